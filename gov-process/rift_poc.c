@@ -2,19 +2,26 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <regex.h>
+#include <time.h>
 
 // Structure definitions
 typedef struct State {
     char* pattern;
     bool is_final;
     size_t id;
+    size_t index;              // Position in the owning automaton's states
+    int accept;                // Pattern index accepted, -1 if not compiled from patterns
 } State;
 
+// input_pattern is one byte class: a literal, '.', an escape such as \d,
+// or a bracket expression
 typedef struct Transition {
     State* from_state;
     char* input_pattern;
     State* to_state;
+    uint64_t input_set[4];     // Bytes input_pattern accepts
 } Transition;
 
 typedef struct RegexAutomaton {
@@ -26,6 +33,10 @@ typedef struct RegexAutomaton {
     size_t transition_capacity;
     State* initial_state;
     State* current_state;
+    uint8_t byte_class[256];   // Byte → equivalence class
+    size_t class_count;
+    int32_t* table;            // [state * class_count + class] → state index, -1 = reject
+    bool table_valid;          // Cleared whenever a state or transition is added
 } RegexAutomaton;
 
 typedef struct TokenNode {
@@ -59,6 +70,8 @@ State* state_create(const char* pattern, bool is_final) {
     
     state->is_final = is_final;
     state->id = generate_id();
+    state->index = 0;
+    state->accept = -1;
     return state;
 }
 
@@ -83,6 +96,121 @@ bool state_matches(State* state, const char* text) {
     return (result == 0);
 }
 
+// Byte set functions
+static void byte_set_add(uint64_t* set, unsigned char c) {
+    set[c >> 6] |= (uint64_t)1 << (c & 63);
+}
+
+static bool byte_set_has(const uint64_t* set, unsigned char c) {
+    return (set[c >> 6] >> (c & 63)) & 1;
+}
+
+static void byte_set_add_range(uint64_t* set, unsigned char lo, unsigned char hi) {
+    for (unsigned c = lo; c <= hi; c++) byte_set_add(set, (unsigned char)c);
+}
+
+// Adds the meaning of the escape letter c to set
+static void byte_set_add_escape(uint64_t* set, char c) {
+    uint64_t class_set[4] = {0, 0, 0, 0};
+    bool negate = false;
+    
+    switch (c) {
+        case 'W': negate = true; // fall through
+        case 'w':
+            byte_set_add_range(class_set, 'a', 'z');
+            byte_set_add_range(class_set, 'A', 'Z');
+            byte_set_add_range(class_set, '0', '9');
+            byte_set_add(class_set, '_');
+            break;
+        case 'D': negate = true; // fall through
+        case 'd':
+            byte_set_add_range(class_set, '0', '9');
+            break;
+        case 'S': negate = true; // fall through
+        case 's':
+            byte_set_add(class_set, ' ');
+            byte_set_add_range(class_set, '\t', '\r');
+            break;
+        case 'n': byte_set_add(class_set, '\n'); break;
+        case 't': byte_set_add(class_set, '\t'); break;
+        case 'r': byte_set_add(class_set, '\r'); break;
+        default:  byte_set_add(class_set, (unsigned char)c); break;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        set[i] |= negate ? ~class_set[i] : class_set[i];
+    }
+}
+
+// Parses one byte class at *p (a literal, '.', an escape or a bracket
+// expression with ranges, negation and escapes) into set and advances *p
+// past it. Returns false on a malformed class or a regex operator.
+static bool byte_set_parse(const char** p, uint64_t* set) {
+    const char* s = *p;
+    memset(set, 0, sizeof(uint64_t) * 4);
+    
+    switch (*s) {
+        case '\0': case '(': case ')': case '|': case '*': case '+': case '?':
+        case '{': case '}':
+            return false;
+        case '.':
+            byte_set_add_range(set, 0, 255);
+            *p = s + 1;
+            return true;
+        case '\\':
+            if (!s[1]) return false;
+            byte_set_add_escape(set, s[1]);
+            *p = s + 2;
+            return true;
+        case '[':
+            break;
+        default:
+            byte_set_add(set, (unsigned char)*s);
+            *p = s + 1;
+            return true;
+    }
+    
+    s++;
+    bool negate = *s == '^';
+    if (negate) s++;
+    
+    bool first = true;
+    while (*s && (*s != ']' || first)) {
+        first = false;
+        unsigned char lo = (unsigned char)*s++;
+        
+        if (lo == '\\') {
+            char escaped = *s++;
+            if (!escaped) return false;
+            if (strchr("wdsWDS", escaped)) {
+                byte_set_add_escape(set, escaped);
+                continue;
+            }
+            lo = (unsigned char)escaped;
+        }
+        
+        if (s[0] == '-' && s[1] && s[1] != ']') {
+            unsigned char hi = (unsigned char)s[1];
+            s += 2;
+            if (hi == '\\') {
+                hi = (unsigned char)*s++;
+                if (!hi) return false;
+            }
+            if (hi < lo) return false;
+            byte_set_add_range(set, lo, hi);
+        } else {
+            byte_set_add(set, lo);
+        }
+    }
+    if (*s != ']') return false;
+    
+    if (negate) {
+        for (int i = 0; i < 4; i++) set[i] = ~set[i];
+    }
+    *p = s + 1;
+    return true;
+}
+
 // Automaton functions
 RegexAutomaton* automaton_create(void) {
     RegexAutomaton* automaton = malloc(sizeof(RegexAutomaton));
@@ -107,6 +235,9 @@ RegexAutomaton* automaton_create(void) {
     automaton->transition_count = 0;
     automaton->initial_state = NULL;
     automaton->current_state = NULL;
+    automaton->class_count = 0;
+    automaton->table = NULL;
+    automaton->table_valid = false;
     
     return automaton;
 }
@@ -124,6 +255,7 @@ void automaton_destroy(RegexAutomaton* automaton) {
         free(automaton->transitions[i]);
     }
     free(automaton->transitions);
+    free(automaton->table);
     
     free(automaton);
 }
@@ -144,7 +276,9 @@ State* automaton_add_state(RegexAutomaton* automaton, const char* pattern, bool
     State* state = state_create(pattern, is_final);
     if (!state) return NULL;
     
+    state->index = automaton->state_count;
     automaton->states[automaton->state_count++] = state;
+    automaton->table_valid = false;
     
     if (!automaton->initial_state) {
         automaton->initial_state = state;
@@ -157,6 +291,10 @@ State* automaton_add_state(RegexAutomaton* automaton, const char* pattern, bool
 bool automaton_add_transition(RegexAutomaton* automaton, State* from, const char* pattern, State* to) {
     if (!automaton || !from || !pattern || !to) return false;
     
+    uint64_t input_set[4];
+    const char* end = pattern;
+    if (!byte_set_parse(&end, input_set) || *end != '\0') return false;
+    
     // Check capacity
     if (automaton->transition_count >= automaton->transition_capacity) {
         size_t new_capacity = automaton->transition_capacity * 2;
@@ -178,23 +316,748 @@ bool automaton_add_transition(RegexAutomaton* automaton, State* from, const char
         return false;
     }
     transition->to_state = to;
+    memcpy(transition->input_set, input_set, sizeof(input_set));
     
     automaton->transitions[automaton->transition_count++] = transition;
+    automaton->table_valid = false;
     return true;
 }
 
+// Collapses bytes that no transition distinguishes into shared classes;
+// representative receives one byte of every class
+static void automaton_byte_classes(RegexAutomaton* automaton, uint8_t* representative) {
+    uint8_t* byte_class = automaton->byte_class;
+    size_t class_count = 1;
+    memset(byte_class, 0, 256);
+    
+    for (size_t t = 0; t < automaton->transition_count; t++) {
+        int split[256][2];
+        memset(split, -1, sizeof(split));
+        size_t new_count = 0;
+        uint8_t refined[256];
+        
+        for (int b = 0; b < 256; b++) {
+            int in_set = byte_set_has(automaton->transitions[t]->input_set, (unsigned char)b);
+            int* slot = &split[byte_class[b]][in_set];
+            if (*slot < 0) *slot = (int)new_count++;
+            refined[b] = (uint8_t)*slot;
+        }
+        
+        memcpy(byte_class, refined, 256);
+        class_count = new_count;
+    }
+    
+    for (int b = 255; b >= 0; b--) representative[byte_class[b]] = (uint8_t)b;
+    automaton->class_count = class_count;
+}
+
+// Builds the dense [state][byte class] table from the transition list.
+// Fails if two transitions leave one state on a shared byte for different
+// states, since the table can only hold a deterministic automaton.
+bool automaton_compile(RegexAutomaton* automaton) {
+    if (!automaton) return false;
+    if (automaton->table_valid) return true;
+    
+    uint8_t representative[256];
+    automaton_byte_classes(automaton, representative);
+    
+    size_t k = automaton->class_count;
+    int32_t* table = malloc(sizeof(int32_t) * (automaton->state_count ? automaton->state_count : 1) * k);
+    if (!table) return false;
+    for (size_t i = 0; i < automaton->state_count * k; i++) table[i] = -1;
+    
+    for (size_t t = 0; t < automaton->transition_count; t++) {
+        const Transition* transition = automaton->transitions[t];
+        int32_t* row = table + transition->from_state->index * k;
+        int32_t target = (int32_t)transition->to_state->index;
+        
+        for (size_t c = 0; c < k; c++) {
+            if (!byte_set_has(transition->input_set, representative[c])) continue;
+            if (row[c] >= 0 && row[c] != target) {
+                free(table);
+                return false;
+            }
+            row[c] = target;
+        }
+    }
+    
+    free(automaton->table);
+    automaton->table = table;
+    automaton->table_valid = true;
+    return true;
+}
+
+// One table lookup per input byte: the state reached from from on byte,
+// or NULL if the automaton rejects it. The table must be compiled.
+State* automaton_step(const RegexAutomaton* automaton, const State* from, unsigned char byte) {
+    int32_t target = automaton->table[from->index * automaton->class_count +
+                                      automaton->byte_class[byte]];
+    return target < 0 ? NULL : automaton->states[target];
+}
+
+// Runs input through the automaton from its initial state and returns the
+// final state the whole input ends in, or NULL if it is rejected. An
+// automaton without transitions falls back to matching each state's
+// pattern as a regex, in the order the states were added.
 State* automaton_get_next_state(RegexAutomaton* automaton, const char* input) {
     if (!automaton || !automaton->current_state || !input) return NULL;
     
-    // Try direct pattern matching first
-    for (size_t i = 0; i < automaton->state_count; i++) {
-        if (state_matches(automaton->states[i], input)) {
-            automaton->current_state = automaton->states[i];
-            return automaton->states[i];
+    if (automaton->transition_count == 0) {
+        for (size_t i = 0; i < automaton->state_count; i++) {
+            if (state_matches(automaton->states[i], input)) {
+                automaton->current_state = automaton->states[i];
+                return automaton->states[i];
+            }
+        }
+        return NULL;
+    }
+    
+    if (!automaton_compile(automaton)) return NULL;
+    
+    const int32_t* table = automaton->table;
+    const uint8_t* byte_class = automaton->byte_class;
+    size_t class_count = automaton->class_count;
+    int32_t state = (int32_t)automaton->initial_state->index;
+    
+    for (const unsigned char* c = (const unsigned char*)input; *c && state >= 0; c++) {
+        state = table[(size_t)state * class_count + byte_class[*c]];
+    }
+    if (state < 0 || !automaton->states[state]->is_final) return NULL;
+    
+    automaton->current_state = automaton->states[state];
+    return automaton->current_state;
+}
+
+// Pattern compilation: regex → Thompson NFA → subset DFA → Hopcroft
+// minimization → RegexAutomaton. Supported ERE subset: literals, '.',
+// bracket expressions, \w \d \s \W \D \S, grouping, '|', '*', '+', '?'.
+// Patterns match whole tokens, so a leading '^' and trailing '$' are
+// implied and ignored.
+
+#define AUTOMATON_MAX_DFA_STATES 4096
+
+typedef struct NFANode {
+    uint64_t set[4];           // Bytes accepted by the consuming edge
+    int next;                  // Target of the consuming edge, -1 if none
+    int eps[2];                // Epsilon edges, -1 if unused
+    int accept;                // Pattern index accepted here, -1 otherwise
+} NFANode;
+
+typedef struct NFA {
+    NFANode* nodes;
+    size_t count;
+    size_t capacity;
+} NFA;
+
+typedef struct NFAFragment {
+    int start;
+    int end;
+} NFAFragment;
+
+typedef struct PatternParser {
+    const char* p;
+    NFA* nfa;
+    bool failed;
+} PatternParser;
+
+// Intermediate DFA over byte classes; only the minimized result is kept
+typedef struct DFA {
+    uint8_t byte_class[256];
+    uint8_t representative[256];   // One byte of every class
+    size_t class_count;
+    size_t state_count;
+    size_t state_capacity;
+    int32_t* transitions;      // [state * class_count + class], -1 = dead
+    int* accept;               // Pattern index accepted per state, -1 otherwise
+    int32_t start;
+} DFA;
+
+static int nfa_new_node(NFA* nfa) {
+    if (nfa->count >= nfa->capacity) {
+        size_t new_capacity = nfa->capacity ? nfa->capacity * 2 : 64;
+        NFANode* new_nodes = realloc(nfa->nodes, sizeof(NFANode) * new_capacity);
+        if (!new_nodes) return -1;
+        nfa->nodes = new_nodes;
+        nfa->capacity = new_capacity;
+    }
+    
+    NFANode* node = &nfa->nodes[nfa->count];
+    memset(node->set, 0, sizeof(node->set));
+    node->next = -1;
+    node->eps[0] = -1;
+    node->eps[1] = -1;
+    node->accept = -1;
+    return (int)nfa->count++;
+}
+
+static NFAFragment pattern_fail(PatternParser* parser) {
+    parser->failed = true;
+    return (NFAFragment){-1, -1};
+}
+
+static NFAFragment parse_alternation(PatternParser* parser);
+
+// One byte class, or a parenthesized group
+static NFAFragment parse_atom(PatternParser* parser) {
+    if (*parser->p == '(') {
+        parser->p++;
+        NFAFragment inner = parse_alternation(parser);
+        if (parser->failed || *parser->p != ')') return pattern_fail(parser);
+        parser->p++;
+        return inner;
+    }
+    
+    uint64_t set[4];
+    if (!byte_set_parse(&parser->p, set)) return pattern_fail(parser);
+    
+    int start = nfa_new_node(parser->nfa);
+    int end = nfa_new_node(parser->nfa);
+    if (start < 0 || end < 0) return pattern_fail(parser);
+    memcpy(parser->nfa->nodes[start].set, set, sizeof(set));
+    parser->nfa->nodes[start].next = end;
+    return (NFAFragment){start, end};
+}
+
+static NFAFragment parse_repeat(PatternParser* parser) {
+    NFAFragment frag = parse_atom(parser);
+    
+    while (!parser->failed && (*parser->p == '*' || *parser->p == '+' || *parser->p == '?')) {
+        char op = *parser->p++;
+        NFA* nfa = parser->nfa;
+        int start = (op == '+') ? frag.start : nfa_new_node(nfa);
+        int end = nfa_new_node(nfa);
+        if (start < 0 || end < 0) return pattern_fail(parser);
+        
+        if (op == '*') {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else if (op == '+') {
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = end;
         }
+        frag = (NFAFragment){start, end};
     }
     
-    return NULL;
+    return frag;
+}
+
+static NFAFragment parse_concat(PatternParser* parser) {
+    int start = nfa_new_node(parser->nfa);
+    if (start < 0) return pattern_fail(parser);
+    NFAFragment frag = {start, start};
+    
+    while (!parser->failed && *parser->p && *parser->p != '|' && *parser->p != ')') {
+        // Trailing '$' anchors the whole token and is implied
+        if (parser->p[0] == '$' && parser->p[1] == '\0') {
+            parser->p++;
+            break;
+        }
+        
+        NFAFragment next = parse_repeat(parser);
+        if (parser->failed) break;
+        parser->nfa->nodes[frag.end].eps[0] = next.start;
+        frag.end = next.end;
+    }
+    
+    return frag;
+}
+
+static NFAFragment parse_alternation(PatternParser* parser) {
+    NFAFragment frag = parse_concat(parser);
+    
+    while (!parser->failed && *parser->p == '|') {
+        parser->p++;
+        NFAFragment other = parse_concat(parser);
+        int start = nfa_new_node(parser->nfa);
+        int end = nfa_new_node(parser->nfa);
+        if (parser->failed || start < 0 || end < 0) return pattern_fail(parser);
+        
+        NFANode* nodes = parser->nfa->nodes;
+        nodes[start].eps[0] = frag.start;
+        nodes[start].eps[1] = other.start;
+        nodes[frag.end].eps[0] = end;
+        nodes[other.end].eps[0] = end;
+        frag = (NFAFragment){start, end};
+    }
+    
+    return frag;
+}
+
+// Thompson construction of one pattern; its final node accepts pattern_index.
+// Returns the start node, or -1 if the pattern is outside the subset.
+static int nfa_add_pattern(NFA* nfa, const char* pattern, int pattern_index) {
+    PatternParser parser = {pattern, nfa, false};
+    if (*parser.p == '^') parser.p++;
+    
+    NFAFragment frag = parse_alternation(&parser);
+    if (parser.failed || *parser.p != '\0') return -1;
+    
+    nfa->nodes[frag.end].accept = pattern_index;
+    return frag.start;
+}
+
+static void dfa_destroy(DFA* dfa) {
+    if (!dfa) return;
+    free(dfa->transitions);
+    free(dfa->accept);
+    free(dfa);
+}
+
+// Collapses bytes that no NFA edge distinguishes into shared classes
+static void dfa_byte_classes(DFA* dfa, const NFA* nfa) {
+    size_t class_count = 1;
+    memset(dfa->byte_class, 0, 256);
+    
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (nfa->nodes[n].next < 0) continue;
+        
+        int split[256][2];
+        memset(split, -1, sizeof(split));
+        size_t new_count = 0;
+        uint8_t refined[256];
+        
+        for (int b = 0; b < 256; b++) {
+            int in_set = byte_set_has(nfa->nodes[n].set, (unsigned char)b);
+            int* slot = &split[dfa->byte_class[b]][in_set];
+            if (*slot < 0) *slot = (int)new_count++;
+            refined[b] = (uint8_t)*slot;
+        }
+        
+        memcpy(dfa->byte_class, refined, 256);
+        class_count = new_count;
+    }
+    
+    for (int b = 255; b >= 0; b--) dfa->representative[dfa->byte_class[b]] = (uint8_t)b;
+    dfa->class_count = class_count;
+}
+
+// Subset construction state: DFA states are epsilon-closed sets of NFA nodes
+typedef struct SubsetBuilder {
+    const NFA* nfa;
+    DFA* dfa;
+    size_t words;              // uint64_t words per NFA node set
+    uint64_t* sets;            // One set per DFA state
+    int* stack;
+    int32_t* lookup;           // Open-addressing index of sets
+    size_t lookup_size;
+} SubsetBuilder;
+
+// Returns the DFA state for the epsilon closure of set, creating it if new;
+// -1 for the empty set, -2 when out of memory or over the state limit
+static int32_t subset_intern(SubsetBuilder* builder, uint64_t* set) {
+    const NFA* nfa = builder->nfa;
+    DFA* dfa = builder->dfa;
+    size_t words = builder->words;
+    
+    size_t top = 0;
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (set[n >> 6] >> (n & 63) & 1) builder->stack[top++] = (int)n;
+    }
+    if (top == 0) return -1;
+    
+    while (top > 0) {
+        const NFANode* node = &nfa->nodes[builder->stack[--top]];
+        for (int e = 0; e < 2; e++) {
+            int t = node->eps[e];
+            if (t >= 0 && !(set[t >> 6] >> (t & 63) & 1)) {
+                set[t >> 6] |= (uint64_t)1 << (t & 63);
+                builder->stack[top++] = t;
+            }
+        }
+    }
+    
+    size_t hash = 0;
+    for (size_t w = 0; w < words; w++) hash = hash * 1099511628211ULL + set[w];
+    size_t slot = hash % builder->lookup_size;
+    while (builder->lookup[slot] >= 0) {
+        int32_t existing = builder->lookup[slot];
+        if (memcmp(builder->sets + words * (size_t)existing, set, sizeof(uint64_t) * words) == 0) {
+            return existing;
+        }
+        slot = (slot + 1) % builder->lookup_size;
+    }
+    
+    if (dfa->state_count >= AUTOMATON_MAX_DFA_STATES) return -2;
+    if (dfa->state_count >= dfa->state_capacity) {
+        size_t new_capacity = dfa->state_capacity * 2;
+        uint64_t* new_sets = realloc(builder->sets, sizeof(uint64_t) * words * new_capacity);
+        if (!new_sets) return -2;
+        builder->sets = new_sets;
+        int32_t* new_transitions = realloc(dfa->transitions,
+                                           sizeof(int32_t) * dfa->class_count * new_capacity);
+        if (!new_transitions) return -2;
+        dfa->transitions = new_transitions;
+        int* new_accept = realloc(dfa->accept, sizeof(int) * new_capacity);
+        if (!new_accept) return -2;
+        dfa->accept = new_accept;
+        dfa->state_capacity = new_capacity;
+    }
+    
+    int32_t state = (int32_t)dfa->state_count++;
+    memcpy(builder->sets + words * (size_t)state, set, sizeof(uint64_t) * words);
+    builder->lookup[slot] = state;
+    
+    // When several patterns accept the same lexeme the earliest wins
+    int best = -1;
+    for (size_t n = 0; n < nfa->count; n++) {
+        int a = nfa->nodes[n].accept;
+        if (a >= 0 && (set[n >> 6] >> (n & 63) & 1) && (best < 0 || a < best)) best = a;
+    }
+    dfa->accept[state] = best;
+    return state;
+}
+
+// Determinizes nfa from node start; states are numbered as discovered
+static DFA* dfa_from_nfa(const NFA* nfa, int start) {
+    DFA* dfa = calloc(1, sizeof(DFA));
+    if (!dfa) return NULL;
+    dfa_byte_classes(dfa, nfa);
+    
+    SubsetBuilder builder = {nfa, dfa, (nfa->count + 63) / 64, NULL, NULL, NULL,
+                             AUTOMATON_MAX_DFA_STATES * 2};
+    dfa->state_capacity = 16;
+    builder.sets = malloc(sizeof(uint64_t) * builder.words * dfa->state_capacity);
+    builder.stack = malloc(sizeof(int) * nfa->count);
+    builder.lookup = malloc(sizeof(int32_t) * builder.lookup_size);
+    uint64_t* scratch = malloc(sizeof(uint64_t) * builder.words);
+    dfa->transitions = malloc(sizeof(int32_t) * dfa->class_count * dfa->state_capacity);
+    dfa->accept = malloc(sizeof(int) * dfa->state_capacity);
+    bool ok = builder.sets && builder.stack && builder.lookup && scratch &&
+              dfa->transitions && dfa->accept;
+    
+    if (ok) {
+        for (size_t i = 0; i < builder.lookup_size; i++) builder.lookup[i] = -1;
+        memset(scratch, 0, sizeof(uint64_t) * builder.words);
+        scratch[start >> 6] |= (uint64_t)1 << (start & 63);
+        dfa->start = subset_intern(&builder, scratch);
+        ok = dfa->start >= 0;
+    }
+    
+    for (size_t s = 0; ok && s < dfa->state_count; s++) {
+        for (size_t c = 0; ok && c < dfa->class_count; c++) {
+            const uint64_t* from = builder.sets + builder.words * s;
+            memset(scratch, 0, sizeof(uint64_t) * builder.words);
+            for (size_t n = 0; n < nfa->count; n++) {
+                if ((from[n >> 6] >> (n & 63) & 1) && nfa->nodes[n].next >= 0 &&
+                    byte_set_has(nfa->nodes[n].set, dfa->representative[c])) {
+                    int t = nfa->nodes[n].next;
+                    scratch[t >> 6] |= (uint64_t)1 << (t & 63);
+                }
+            }
+            
+            int32_t target = subset_intern(&builder, scratch);
+            ok = target != -2;
+            dfa->transitions[s * dfa->class_count + c] = target;
+        }
+    }
+    
+    free(builder.sets);
+    free(builder.stack);
+    free(builder.lookup);
+    free(scratch);
+    if (!ok) {
+        dfa_destroy(dfa);
+        return NULL;
+    }
+    return dfa;
+}
+
+// Hopcroft's algorithm over a refinable partition. The DFA is completed
+// with a dead state (index n) so every state has a transition on every
+// class; blocks are ranges of elements, with marked states moved to the
+// front of their block before it is split. Rewrites dfa with one state per
+// block, dropping the block that is equivalent to the dead state.
+static bool dfa_minimize(DFA* dfa) {
+    size_t n = dfa->state_count + 1;
+    size_t k = dfa->class_count;
+    size_t dead = n - 1;
+    
+    size_t* elements = malloc(sizeof(size_t) * n);     // States grouped by block
+    size_t* location = malloc(sizeof(size_t) * n);     // Position in elements
+    size_t* block_of = calloc(n, sizeof(size_t));
+    size_t* first = malloc(sizeof(size_t) * n);        // Block → elements range
+    size_t* end = malloc(sizeof(size_t) * n);
+    size_t* marked = calloc(n, sizeof(size_t));        // Marked states per block
+    bool* waiting = calloc(n, sizeof(bool));
+    size_t* worklist = malloc(sizeof(size_t) * n);
+    size_t* touched = malloc(sizeof(size_t) * n);
+    size_t* splitter = malloc(sizeof(size_t) * n);
+    size_t* inverse_start = calloc(k * n + 1, sizeof(size_t));  // CSR by (class, target)
+    size_t* inverse = malloc(sizeof(size_t) * k * n);
+    int* block_accept = malloc(sizeof(int) * n);
+    bool ok = elements && location && block_of && first && end && marked && waiting &&
+              worklist && touched && splitter && inverse_start && inverse && block_accept;
+    size_t block_count = 0;
+    
+    if (ok) {
+        // Predecessors of every state on every class
+        for (size_t s = 0; s < n; s++) {
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = s == dead ? -1 : dfa->transitions[s * k + c];
+                inverse_start[c * n + (t < 0 ? dead : (size_t)t)]++;
+            }
+        }
+        for (size_t i = 1; i < k * n; i++) inverse_start[i] += inverse_start[i - 1];
+        inverse_start[k * n] = k * n;
+        for (size_t s = n; s-- > 0; ) {
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = s == dead ? -1 : dfa->transitions[s * k + c];
+                inverse[--inverse_start[c * n + (t < 0 ? dead : (size_t)t)]] = s;
+            }
+        }
+    }
+    
+    if (ok) {
+        // Initial partition: states accepting the same pattern (dead accepts none)
+        for (size_t s = 0; s < n; s++) {
+            int accept = s == dead ? -1 : dfa->accept[s];
+            size_t b = 0;
+            while (b < block_count && block_accept[b] != accept) b++;
+            if (b == block_count) {
+                block_accept[block_count++] = accept;
+                end[b] = 0;
+            }
+            block_of[s] = b;
+            end[b]++;
+        }
+        for (size_t b = 0, offset = 0; b < block_count; b++) {
+            first[b] = offset;
+            offset += end[b];
+            end[b] = first[b];
+        }
+        for (size_t s = 0; s < n; s++) {
+            location[s] = end[block_of[s]]++;
+            elements[location[s]] = s;
+        }
+    }
+    
+    size_t worklist_count = 0;
+    for (size_t b = 0; ok && b < block_count; b++) {
+        worklist[worklist_count++] = b;
+        waiting[b] = true;
+    }
+    
+    while (ok && worklist_count > 0) {
+        size_t a = worklist[--worklist_count];
+        waiting[a] = false;
+        size_t splitter_count = end[a] - first[a];
+        memcpy(splitter, elements + first[a], sizeof(size_t) * splitter_count);
+        
+        for (size_t c = 0; c < k; c++) {
+            size_t touched_count = 0;
+            
+            // Mark every predecessor on c of the splitter
+            for (size_t i = 0; i < splitter_count; i++) {
+                size_t key = c * n + splitter[i];
+                for (size_t j = inverse_start[key]; j < inverse_start[key + 1]; j++) {
+                    size_t p = inverse[j];
+                    size_t b = block_of[p];
+                    size_t target = first[b] + marked[b];
+                    if (location[p] < target) continue;   // Already marked
+                    
+                    size_t other = elements[target];
+                    elements[location[p]] = other;
+                    location[other] = location[p];
+                    elements[target] = p;
+                    location[p] = target;
+                    if (marked[b]++ == 0) touched[touched_count++] = b;
+                }
+            }
+            
+            // Split every block that is only partly marked
+            for (size_t i = 0; i < touched_count; i++) {
+                size_t b = touched[i];
+                size_t split = first[b] + marked[b];
+                marked[b] = 0;
+                if (split == end[b]) continue;
+                
+                size_t nb = block_count++;
+                first[nb] = first[b];
+                end[nb] = split;
+                first[b] = split;
+                for (size_t j = first[nb]; j < end[nb]; j++) block_of[elements[j]] = nb;
+                
+                if (waiting[b] || end[nb] - first[nb] <= end[b] - first[b]) {
+                    worklist[worklist_count++] = nb;
+                    waiting[nb] = true;
+                } else {
+                    worklist[worklist_count++] = b;
+                    waiting[b] = true;
+                }
+            }
+        }
+    }
+    
+    if (ok) {
+        // Renumber blocks, leaving out the dead one, starting from the start state
+        size_t dead_block = block_of[dead];
+        size_t* number = splitter;   // Block → new state, n = dropped
+        size_t new_count = 0;
+        for (size_t b = 0; b < block_count; b++) number[b] = n;
+        number[block_of[dfa->start]] = new_count++;
+        for (size_t b = 0; b < block_count; b++) {
+            if (b != dead_block && number[b] == n) number[b] = new_count++;
+        }
+        
+        int32_t* transitions = malloc(sizeof(int32_t) * (new_count ? new_count : 1) * k);
+        int* accept = malloc(sizeof(int) * (new_count ? new_count : 1));
+        ok = transitions && accept;
+        for (size_t b = 0; ok && b < block_count; b++) {
+            if (number[b] == n) continue;
+            size_t s = elements[first[b]];
+            if (s == dead) s = elements[first[b] + 1];  // Start shares the dead block
+            size_t row = number[b];
+            accept[row] = dfa->accept[s];
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = dfa->transitions[s * k + c];
+                size_t target = t < 0 ? n : number[block_of[t]];
+                transitions[row * k + c] = target == n ? -1 : (int32_t)target;
+            }
+        }
+        
+        if (ok) {
+            free(dfa->transitions);
+            free(dfa->accept);
+            dfa->transitions = transitions;
+            dfa->accept = accept;
+            dfa->state_count = new_count;
+            dfa->state_capacity = new_count;
+            dfa->start = 0;
+        } else {
+            free(transitions);
+            free(accept);
+        }
+    }
+    
+    free(elements);
+    free(location);
+    free(block_of);
+    free(first);
+    free(end);
+    free(marked);
+    free(waiting);
+    free(worklist);
+    free(touched);
+    free(splitter);
+    free(inverse_start);
+    free(inverse);
+    free(block_accept);
+    return ok;
+}
+
+// Writes byte b into a bracket expression, escaping the bytes that are
+// special there
+static char* byte_set_put(char* out, int b) {
+    if (strchr("]\\-^", b)) *out++ = '\\';
+    *out++ = (char)b;
+    return out;
+}
+
+// Renders set as a bracket expression that byte_set_parse reads back. A set
+// holding NUL is written negated, since its complement cannot hold NUL too.
+static char* byte_set_pattern(const uint64_t* set) {
+    uint64_t bytes[4];
+    bool negate = byte_set_has(set, 0);
+    for (int i = 0; i < 4; i++) bytes[i] = negate ? ~set[i] : set[i];
+    if (negate && !bytes[0] && !bytes[1] && !bytes[2] && !bytes[3]) return strdup(".");
+    
+    char* pattern = malloc(4 + 256 * 4);
+    if (!pattern) return NULL;
+    char* out = pattern;
+    *out++ = '[';
+    if (negate) *out++ = '^';
+    
+    for (int lo = 1; lo < 256; lo++) {
+        if (!byte_set_has(bytes, (unsigned char)lo)) continue;
+        int hi = lo;
+        while (hi < 255 && byte_set_has(bytes, (unsigned char)(hi + 1))) hi++;
+        
+        out = byte_set_put(out, lo);
+        if (hi > lo + 1) *out++ = '-';
+        if (hi > lo) out = byte_set_put(out, hi);
+        lo = hi;
+    }
+    *out++ = ']';
+    *out = '\0';
+    return pattern;
+}
+
+// Compiles patterns into one minimized automaton: Thompson construction,
+// subset construction over byte classes, then Hopcroft minimization. A
+// lexeme accepted by several patterns goes to the earliest. Final states
+// carry the pattern they accept (as text and as accept index), and each
+// pair of states gets at most one transition, so the automaton's size
+// follows the minimized state count. Returns NULL if a pattern is outside
+// the supported subset.
+RegexAutomaton* automaton_compile_patterns(const char* const* patterns, size_t pattern_count) {
+    NFA nfa = {NULL, 0, 0};
+    DFA* dfa = NULL;
+    RegexAutomaton* automaton = NULL;
+    
+    // All patterns joined under one start node
+    int start = nfa_new_node(&nfa);
+    int link = start;
+    bool ok = start >= 0;
+    for (size_t i = 0; ok && i < pattern_count; i++) {
+        int pattern_start = nfa_add_pattern(&nfa, patterns[i], (int)i);
+        int next_link = nfa_new_node(&nfa);
+        ok = pattern_start >= 0 && next_link >= 0;
+        if (ok) {
+            nfa.nodes[link].eps[0] = pattern_start;
+            nfa.nodes[link].eps[1] = next_link;
+            link = next_link;
+        }
+    }
+    
+    dfa = ok ? dfa_from_nfa(&nfa, start) : NULL;
+    free(nfa.nodes);
+    ok = dfa && dfa_minimize(dfa);
+    automaton = ok ? automaton_create() : NULL;
+    ok = automaton != NULL;
+    
+    // State 0 is the start state, so it becomes the initial state
+    for (size_t s = 0; ok && s < dfa->state_count; s++) {
+        int accept = dfa->accept[s];
+        State* state = automaton_add_state(automaton, accept >= 0 ? patterns[accept] : "", accept >= 0);
+        ok = state != NULL;
+        if (ok) state->accept = accept;
+    }
+    
+    // One transition per (from, to) pair, over the union of its classes
+    size_t k = dfa ? dfa->class_count : 0;
+    for (size_t s = 0; ok && s < dfa->state_count; s++) {
+        for (size_t c = 0; ok && c < k; c++) {
+            int32_t target = dfa->transitions[s * k + c];
+            bool seen = target < 0;
+            for (size_t e = 0; !seen && e < c; e++) seen = dfa->transitions[s * k + e] == target;
+            if (seen) continue;
+            
+            uint64_t set[4] = {0, 0, 0, 0};
+            for (int b = 0; b < 256; b++) {
+                if (dfa->transitions[s * k + dfa->byte_class[b]] == target) {
+                    byte_set_add(set, (unsigned char)b);
+                }
+            }
+            char* input = byte_set_pattern(set);
+            ok = input && automaton_add_transition(automaton, automaton->states[s], input,
+                                                   automaton->states[target]);
+            free(input);
+        }
+    }
+    
+    dfa_destroy(dfa);
+    if (ok) ok = automaton_compile(automaton);
+    if (!ok) {
+        automaton_destroy(automaton);
+        return NULL;
+    }
+    return automaton;
 }
 
 // IR Generator functions
@@ -251,19 +1114,26 @@ TokenNode* ir_generator_process_token(IRGenerator* generator, const char* token)
     return node;
 }
 
+// Token classes; the names are the type names every tokenizer reports in
+// --classify mode
+static const char* lexer_type_names[] = {"IDENTIFIER", "NUMBER", "OPERATOR", "WHITESPACE"};
+#define LEXER_TYPE_COUNT (sizeof(lexer_type_names) / sizeof(lexer_type_names[0]))
+
+// Token patterns, in lexer_type_names order. These are regexes, not
+// regcomp input: \w and \s are part of the supported subset.
+static const char* lexer_patterns[] = {"^[a-zA-Z_]\\w*$", "^[0-9]+$", "^[-+*/]$", "^\\s+$"};
+
+// Compiles the token patterns into one minimized automaton; every final
+// state's accept is the index of its token class
+RegexAutomaton* create_lexer_automaton(void) {
+    return automaton_compile_patterns(lexer_patterns, LEXER_TYPE_COUNT);
+}
+
 // Example usage
 void create_simple_lexer(void) {
-    RegexAutomaton* automaton = automaton_create();
-    
-    // Add states
-    State* identifier = automaton_add_state(automaton, "^[a-zA-Z_]\\w*$", false);
-    State* number = automaton_add_state(automaton, "^\\d+$", false);
-    State* operator = automaton_add_state(automaton, "^[+\\-*/]$", false);
-    State* whitespace = automaton_add_state(automaton, "^\\s+$", false);
-    
-    if (!identifier || !number || !operator || !whitespace) {
+    RegexAutomaton* automaton = create_lexer_automaton();
+    if (!automaton) {
         printf("Failed to create states\n");
-        automaton_destroy(automaton);
         return;
     }
     
@@ -294,7 +1164,116 @@ void create_simple_lexer(void) {
     automaton_destroy(automaton);
 }
 
-int main(void) {
+static uint64_t clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static bool is_lexeme_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// One classified lexeme of the current corpus line
+typedef struct {
+    size_t start;
+    size_t length;
+    int type;                   // Index into lexer_type_names, -1 if unmatched
+} ClassifiedLexeme;
+
+// --classify CORPUS RESULTS REPEAT; results format in rift_tokenizer_compare.c
+int classify_corpus(const char* corpus_path, const char* results_path, const char* repeat_text) {
+    char* end;
+    unsigned long repeat = strtoul(repeat_text, &end, 10);
+    if (*end != '\0' || repeat == 0) {
+        fprintf(stderr, "--classify: invalid repeat count %s\n", repeat_text);
+        return 1;
+    }
+    
+    FILE* corpus = fopen(corpus_path, "r");
+    if (!corpus) {
+        perror(corpus_path);
+        return 1;
+    }
+    FILE* results = fopen(results_path, "w");
+    if (!results) {
+        perror(results_path);
+        fclose(corpus);
+        return 1;
+    }
+    
+    RegexAutomaton* automaton = create_lexer_automaton();
+    IRGenerator* generator = automaton ? ir_generator_create(automaton) : NULL;
+    
+    // The whole corpus is read up front so no pass includes I/O
+    bool ok = generator && fseek(corpus, 0, SEEK_END) == 0;
+    long size = ok ? ftell(corpus) : -1;
+    size_t length = size > 0 ? (size_t)size : 0;
+    char* text = size >= 0 ? malloc(length + 1) : NULL;
+    char* scratch = text ? malloc(length + 1) : NULL;  // One lexeme, NUL-terminated
+    ClassifiedLexeme* lexemes = scratch ? malloc(sizeof(ClassifiedLexeme) * (length / 2 + 1)) : NULL;
+    ok = lexemes && fseek(corpus, 0, SEEK_SET) == 0 && fread(text, 1, length, corpus) == length;
+    
+    fprintf(results, "E poc-automaton\n");
+    for (unsigned long pass = 0; ok && pass < repeat; pass++) {
+        size_t pos = 0;
+        while (pos < length) {
+            size_t line_end = pos;
+            while (line_end < length && text[line_end] != '\n') line_end++;
+            
+            size_t count = 0;
+            uint64_t start = clock_ns();
+            for (size_t i = pos; i < line_end; ) {
+                if (is_lexeme_separator(text[i])) {
+                    i++;
+                    continue;
+                }
+                size_t j = i;
+                while (j < line_end && !is_lexeme_separator(text[j])) j++;
+                memcpy(scratch, text + i, j - i);
+                scratch[j - i] = '\0';
+                
+                // Type by accepted pattern; node->type only holds its text
+                int type = -1;
+                TokenNode* node = ir_generator_process_token(generator, scratch);
+                if (node) {
+                    type = automaton->current_state->accept;
+                    free(node->type);
+                    free(node->value);
+                    free(node);
+                }
+                lexemes[count++] = (ClassifiedLexeme){i, j - i, type};
+                i = j;
+            }
+            uint64_t elapsed = clock_ns() - start;
+            
+            fprintf(results, "%c %llu\n", pass ? 'R' : 'L', (unsigned long long)elapsed);
+            for (size_t t = 0; pass == 0 && t < count; t++) {
+                const ClassifiedLexeme* lexeme = &lexemes[t];
+                fprintf(results, "T %s %.*s\n",
+                        lexeme->type >= 0 ? lexer_type_names[lexeme->type] : "UNKNOWN",
+                        (int)lexeme->length, text + lexeme->start);
+            }
+            pos = line_end + 1;
+        }
+    }
+    
+    if (fclose(results) != 0) ok = false;
+    if (!ok) fprintf(stderr, "--classify: failed to classify %s\n", corpus_path);
+    fclose(corpus);
+    free(lexemes);
+    free(scratch);
+    free(text);
+    ir_generator_destroy(generator);
+    automaton_destroy(automaton);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 5 && strcmp(argv[1], "--classify") == 0) {
+        return classify_corpus(argv[2], argv[3], argv[4]);
+    }
+    
     create_simple_lexer();
     return 0;
 }
@@ -8,7 +8,61 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <math.h>
 #include <regex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+
+// ================================
+// RIFT Allocator Types
+// Stage objects allocate through the rift_allocator_t they were created
+// with. The system allocator forwards to malloc; memory_tracking=enabled
+// gives every stage its own tracking allocator instead.
+// ================================
+
+typedef enum {
+    RIFT_MEMORY_GOVERNANCE,
+    RIFT_MEMORY_RIFT0,
+    RIFT_MEMORY_RIFT1,
+    RIFT_MEMORY_RIFT2,
+    RIFT_MEMORY_RIFT3,
+    RIFT_MEMORY_STAGE_COUNT
+} rift_memory_stage_t;
+
+// Pipeline stages free each other's objects (RIFT-3 retires the token
+// stream RIFT-0 allocated), so every counter is updated atomically
+typedef struct {
+    atomic_uint_least64_t allocations;
+    atomic_uint_least64_t reallocations;
+    atomic_uint_least64_t frees;
+    atomic_uint_least64_t bytes_allocated;  // Cumulative, including growth by realloc
+    atomic_uint_least64_t live_bytes;
+    atomic_uint_least64_t peak_bytes;
+    atomic_uint_least64_t live_objects;
+    atomic_uint_least64_t items;            // Tokens (RIFT-0) or AST nodes (RIFT-1) produced
+} rift_alloc_stats_t;
+
+typedef struct rift_allocator rift_allocator_t;
+
+struct rift_allocator {
+    const char* name;
+    void* (*allocate)(rift_allocator_t* allocator, size_t size);
+    void* (*reallocate)(rift_allocator_t* allocator, void* ptr, size_t size);
+    void (*release)(rift_allocator_t* allocator, void* ptr);
+    bool tracking;         // stats are maintained
+    rift_alloc_stats_t stats;
+};
 
 // ================================
 // RIFT Governance and Configuration Types
@@ -18,14 +72,39 @@ typedef struct {
     char* pattern;
     char* intention;
     char* sp_alignment;
+    size_t hash;           // rift_hash_string(intention)
 } rift_config_entry_t;
 
 typedef struct {
-    rift_config_entry_t* entries;
+    size_t hash;
+    size_t position;       // Index into the indexed array + 1, 0 = empty
+} config_index_slot_t;
+
+typedef struct {
+    config_index_slot_t* slots;
+    size_t capacity;
+    size_t count;
+    rift_allocator_t* allocator;
+} config_index_t;
+
+typedef struct {
+    rift_config_entry_t** entries;  // Individually allocated, so never move
     size_t count;
     size_t capacity;
+    config_index_t index;           // Intention lookup into entries
+    rift_allocator_t* allocators[RIFT_MEMORY_STAGE_COUNT];  // Used by each stage's objects
 } rift_governance_t;
 
+// Text of one governance file, privately mapped (or copied) and writable
+typedef struct {
+    char* data;
+    size_t length;
+    bool mapped;
+} config_file_t;
+
+typedef void (*config_visit_fn)(void* context, const char* section, const char* key,
+                                const char* value);
+
 // ================================
 // RIFT-0: Tokenizer Stage Types
 // ================================
@@ -38,33 +117,81 @@ typedef enum {
     TOKEN_UNKNOWN
 } token_type_t;
 
+// Struct-of-arrays token stream: token i is types[i] with text
+// source[offsets[i], offsets[i] + lengths[i]). Line and column are derived
+// from the line table on demand. Access it through the token_stream_* helpers.
 typedef struct {
-    token_type_t type;
-    char* value;
-    size_t line;
-    size_t column;
-} rift_token_t;
-
-typedef struct {
-    rift_token_t* tokens;
+    uint8_t* types;        // token_type_t, one byte per token
+    uint32_t* offsets;
+    uint32_t* lengths;
     size_t count;
     size_t capacity;
+    uint32_t* line_starts; // Offset of the first byte of every line
+    size_t line_count;
+    size_t line_capacity;
+    const char* source;    // Borrowed input; must outlive the stream and its AST
+    size_t source_length;
+    rift_allocator_t* allocator;
 } token_stream_t;
 
+// Offsets are 32-bit, so a single stream covers at most 4 GiB of source
+#define RIFT_TOKEN_STREAM_MAX_SOURCE ((size_t)UINT32_MAX)
+
 typedef struct {
     char* pattern;
     token_type_t type;
     bool is_final;
     size_t id;
+    int priority;          // Wins ties between patterns accepting the same lexeme
+    size_t pattern_hash;   // Precomputed for regex cache lookups
+    size_t cache_slot;     // Last known regex cache slot (lookup hint)
 } rift_state_t;
 
+// Bounded LRU cache of compiled regular expressions, sized by
+// regex_cache_size from .riftrc.0 [PERFORMANCE_TUNING]
+typedef struct {
+    char* pattern;
+    size_t hash;
+    regex_t regex;
+    bool compiled;         // false if regcomp rejected the pattern
+    size_t last_used;
+} rift_regex_cache_entry_t;
+
+typedef struct {
+    rift_regex_cache_entry_t* entries;
+    size_t count;
+    size_t capacity;
+    size_t clock;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    rift_allocator_t* allocator;
+} rift_regex_cache_t;
+
+typedef struct rift_dfa rift_dfa_t;
+typedef struct rift_lazy_dfa rift_lazy_dfa_t;
+
 typedef struct {
     rift_state_t** states;
     size_t state_count;
     rift_state_t* current_state;
     rift_governance_t* governance;
+    rift_regex_cache_t* regex_cache;
+    rift_dfa_t* dfa;       // Combined token automaton, NULL → lazy or regex fallback
+    rift_lazy_dfa_t* lazy_dfa;    // dfa_mode=lazy, or the full DFA was too large
+    bool trace_tokens;     // Log every token classification
+    bool parallel;         // parallel_tokenization from .riftrc.0
+    bool split_safe[256];  // Bytes no token other than whitespace can span
+    rift_allocator_t* allocator;  // Tokenizer, DFA and token streams
 } rift_tokenizer_t;
 
+// Pipeline input: a string literal or a read-only file mapping
+typedef struct {
+    const char* data;
+    size_t length;
+    bool mapped;
+} rift_source_t;
+
 // ================================
 // RIFT-1: Parser Bridge Stage Types
 // ================================
@@ -78,36 +205,97 @@ typedef enum {
 
 typedef struct ast_node {
     ast_node_type_t type;
-    char* value;
+    const char* value;     // Span into the token stream source, not terminated
+    size_t value_length;
     struct ast_node* left;
     struct ast_node* right;
 } ast_node_t;
 
+// Bump allocator owning every AST node of one compilation. Blocks double in
+// size as they fill, so an AST of n nodes costs O(log n) mallocs and a
+// single rift_arena_destroy releases all of it.
+typedef struct rift_arena_block {
+    struct rift_arena_block* next;
+    size_t used;
+    size_t capacity;
+    max_align_t data[];
+} rift_arena_block_t;
+
+typedef struct {
+    rift_arena_block_t* head;  // Block currently being filled
+    size_t next_block_size;
+    size_t bytes_used;
+    rift_allocator_t* allocator;
+} rift_arena_t;
+
+// Binary operators indexed by their single-byte symbol; precedence 0 means
+// the byte is not a binary operator
+typedef struct {
+    uint8_t precedence[256];
+    bool right_associative[256];
+    size_t operator_count;
+} rift_operator_table_t;
+
 typedef struct {
     token_stream_t* input_tokens;
     size_t current_position;
     rift_governance_t* governance;
+    rift_arena_t* arena;       // Owns the AST nodes built by rift_parse
+    rift_operator_table_t operators;
+    rift_allocator_t* allocator;
 } rift_parser_t;
 
 // ================================
 // RIFT-2: AST Coordinator Stage Types
 // ================================
 
+// Ancestor stack of the iterative AST walks; its owner keeps it between
+// walks so repeated coordination reuses one allocation
+typedef struct {
+    ast_node_t** nodes;
+    size_t capacity;
+    rift_allocator_t* allocator;
+} rift_ast_walk_stack_t;
+
 typedef struct {
     ast_node_t* root;
     rift_governance_t* governance;
+    rift_arena_t* arena;       // Holds the text of folded constants
+    rift_ast_walk_stack_t walk;
     size_t node_count;
     size_t optimization_passes;
+    bool constant_folding;
+    size_t folded_operations;
+    size_t division_by_zero;   // Constant divisions left unfolded
+    rift_allocator_t* allocator;
 } rift_ast_coordinator_t;
 
 // ================================
 // RIFT-3: Output Stage Types
 // ================================
 
+// Rendered output accumulates here and goes out in large write() calls
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    int fd;
+    size_t bytes_written;
+    size_t write_calls;
+    bool failed;           // A write failed; further output is dropped
+    rift_allocator_t* allocator;
+} rift_output_buffer_t;
+
 typedef struct {
     ast_node_t* ast;
     rift_governance_t* governance;
     char* output_format;
+    int output_fd;         // Destination of the rendered AST, stdout by default
+    char* indent_block;    // Run of indentation bytes copied per nesting level
+    size_t indent_width;   // Bytes of indentation per level
+    rift_output_buffer_t buffer;  // Kept across calls to rift_generate_output
+    bool defer_flush;      // Batch mode: write only when the buffer fills
+    rift_allocator_t* allocator;
 } rift_output_stage_t;
 
 // ================================
@@ -115,479 +303,4299 @@ typedef struct {
 // ================================
 
 // Governance functions
-static rift_governance_t* rift_load_governance(const char* config_dir);
+static rift_governance_t* rift_load_governance(const char* config_dir, rift_allocator_t* allocator);
+static rift_governance_t* rift_governance_open(const char* config_dir);
 static void rift_governance_destroy(rift_governance_t* gov);
 static const char* rift_get_config_value(rift_governance_t* gov, const char* key);
+static const rift_config_entry_t* rift_governance_find(rift_governance_t* gov, const char* key);
+static size_t rift_hash_string(const char* str);
+static rift_allocator_t* rift_governance_allocator(rift_governance_t* gov, rift_memory_stage_t stage);
 
 // RIFT-0 functions
 static rift_tokenizer_t* rift_tokenizer_create(rift_governance_t* gov);
 static void rift_tokenizer_destroy(rift_tokenizer_t* tokenizer);
-static token_stream_t* rift_tokenize(rift_tokenizer_t* tokenizer, const char* input);
+static token_stream_t* rift_tokenize(rift_tokenizer_t* tokenizer, const char* input, size_t length);
+static bool rift_tokenize_into(rift_tokenizer_t* tokenizer, token_stream_t* stream,
+                               const char* input, size_t length);
 static void token_stream_destroy(token_stream_t* stream);
 
+// Regex cache functions
+static rift_regex_cache_t* rift_regex_cache_create(size_t capacity, rift_allocator_t* allocator);
+static void rift_regex_cache_destroy(rift_regex_cache_t* cache);
+static const regex_t* rift_regex_cache_get(rift_regex_cache_t* cache, const char* pattern,
+                                           size_t hash, size_t* slot_hint);
+
+// Arena functions
+static rift_arena_t* rift_arena_create(size_t initial_block_size, rift_allocator_t* allocator);
+static void rift_arena_destroy(rift_arena_t* arena);
+static void rift_arena_reset(rift_arena_t* arena);
+static void* rift_arena_alloc(rift_arena_t* arena, size_t size);
+static char* rift_arena_strndup(rift_arena_t* arena, const char* str, size_t length);
+
 // RIFT-1 functions
-static rift_parser_t* rift_parser_create(rift_governance_t* gov);
+static rift_parser_t* rift_parser_create(rift_governance_t* gov, rift_arena_t* arena);
 static void rift_parser_destroy(rift_parser_t* parser);
 static ast_node_t* rift_parse(rift_parser_t* parser, token_stream_t* tokens);
 
 // RIFT-2 functions
-static rift_ast_coordinator_t* rift_ast_coordinator_create(rift_governance_t* gov);
+static rift_ast_coordinator_t* rift_ast_coordinator_create(rift_governance_t* gov,
+                                                           rift_arena_t* arena);
 static void rift_ast_coordinator_destroy(rift_ast_coordinator_t* coordinator);
+static void rift_ast_coordinator_reset(rift_ast_coordinator_t* coordinator);
 static ast_node_t* rift_coordinate_ast(rift_ast_coordinator_t* coordinator, ast_node_t* ast);
 
 // RIFT-3 functions
 static rift_output_stage_t* rift_output_stage_create(rift_governance_t* gov);
 static void rift_output_stage_destroy(rift_output_stage_t* output);
-static void rift_generate_output(rift_output_stage_t* output, ast_node_t* ast);
+static bool rift_generate_output(rift_output_stage_t* output, ast_node_t* ast);
+static bool rift_output_stage_flush(rift_output_stage_t* output);
 
 // Utility functions
-static void ast_node_destroy(ast_node_t* node);
+static bool rift_source_map_file(rift_source_t* source, const char* path);
+static void rift_source_close(rift_source_t* source);
 static void rift_print_stage_info(const char* stage, const char* message);
+static void rift_log(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Stage progress lines; switched off when stages run concurrently, where
+// their output would interleave with the rendered ASTs
+static bool rift_stage_logging = true;
 
 // ================================
-// Governance Implementation
+// Stage Timing Instrumentation
+// stage_timing=enabled (global.rift) times every RIFT stage and sub-phase on
+// the monotonic clock into log-linear latency histograms, dumped as one JSON
+// line on stderr at exit. performance_monitoring=enabled also dumps them
+// whenever the process receives SIGUSR1, from a thread waiting for it, so a
+// process busy in one long stage or idle still answers.
 // ================================
 
-static rift_governance_t* rift_load_governance(const char* config_dir) {
-    rift_governance_t* gov = malloc(sizeof(rift_governance_t));
-    if (!gov) return NULL;
-    
-    gov->capacity = 10;
-    gov->count = 0;
-    gov->entries = malloc(sizeof(rift_config_entry_t) * gov->capacity);
-    
-    rift_print_stage_info("GOVERNANCE", "Loading .rift configuration files");
-    
-    // Simulate loading tokenizer-config.rift with standard C11 string literals
-    rift_config_entry_t* entry1 = &gov->entries[gov->count++];
-    entry1->pattern = strdup("^[a-zA-Z_]\\w*$");  // C11 standard escape sequences
-    entry1->intention = strdup("IDENTIFIER_RECOGNITION");
-    entry1->sp_alignment = strdup("STAGE_0_TOKENIZER");
-    
-    // Simulate loading intention-map.rift with standard C11 string literals
-    rift_config_entry_t* entry2 = &gov->entries[gov->count++];
-    entry2->pattern = strdup("^\\d+$");  // C11 standard escape sequences
-    entry2->intention = strdup("NUMBER_RECOGNITION");
-    entry2->sp_alignment = strdup("STAGE_0_TOKENIZER");
-    
-    rift_config_entry_t* entry3 = &gov->entries[gov->count++];
-    entry3->pattern = strdup("^[+\\-*/]$");  // C11 standard escape sequences
-    entry3->intention = strdup("OPERATOR_RECOGNITION");
-    entry3->sp_alignment = strdup("STAGE_0_TOKENIZER");
-    
-    printf("  → Loaded %zu configuration entries from .rift files\n", gov->count);
-    return gov;
+typedef enum {
+    RIFT_TIMER_CONFIG_LOAD,
+    RIFT_TIMER_RIFT0,
+    RIFT_TIMER_PATTERN_COMPILE,
+    RIFT_TIMER_SCAN,
+    RIFT_TIMER_LINE_INDEX,
+    RIFT_TIMER_RIFT1,
+    RIFT_TIMER_PARSE,
+    RIFT_TIMER_RIFT2,
+    RIFT_TIMER_PASSES,
+    RIFT_TIMER_RIFT3,
+    RIFT_TIMER_RENDER,
+    RIFT_TIMER_WRITE,
+    RIFT_TIMER_COUNT
+} rift_timer_id_t;
+
+static const char* const rift_timer_names[RIFT_TIMER_COUNT] = {
+    "governance.config_load",
+    "RIFT-0", "RIFT-0.pattern_compile", "RIFT-0.scan", "RIFT-0.line_index",
+    "RIFT-1", "RIFT-1.parse",
+    "RIFT-2", "RIFT-2.passes",
+    "RIFT-3", "RIFT-3.render", "RIFT-3.write"
+};
+
+// Values below 16 ns get a bucket each; above that every power of two is
+// split into 8 sub-buckets, so a reported percentile is within 12.5%
+#define RIFT_HISTOGRAM_EXACT 16
+#define RIFT_HISTOGRAM_SUB_BITS 3
+#define RIFT_HISTOGRAM_BUCKETS (RIFT_HISTOGRAM_EXACT + (64 - 4) * (1 << RIFT_HISTOGRAM_SUB_BITS))
+
+// Each timer is only ever recorded by the thread running its stage, so
+// counters use plain relaxed loads and stores; the atomics only keep a
+// concurrent SIGUSR1 dump from tearing them
+typedef struct {
+    atomic_uint_least64_t buckets[RIFT_HISTOGRAM_BUCKETS];
+    atomic_uint_least64_t count;
+    atomic_uint_least64_t total_ns;
+    atomic_uint_least64_t max_ns;
+} rift_histogram_t;
+
+static rift_histogram_t rift_timers[RIFT_TIMER_COUNT];
+static bool rift_timing_enabled = false;
+
+static uint64_t rift_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
 }
 
-static void rift_governance_destroy(rift_governance_t* gov) {
-    if (!gov) return;
-    
-    for (size_t i = 0; i < gov->count; i++) {
-        free(gov->entries[i].pattern);
-        free(gov->entries[i].intention);
-        free(gov->entries[i].sp_alignment);
-    }
-    free(gov->entries);
-    free(gov);
+static size_t rift_histogram_bucket(uint64_t ns) {
+    if (ns < RIFT_HISTOGRAM_EXACT) return (size_t)ns;
+    int exponent = 63 - __builtin_clzll(ns);
+    size_t sub = (size_t)(ns >> (exponent - RIFT_HISTOGRAM_SUB_BITS)) & ((1 << RIFT_HISTOGRAM_SUB_BITS) - 1);
+    return RIFT_HISTOGRAM_EXACT + (size_t)(exponent - 4) * (1 << RIFT_HISTOGRAM_SUB_BITS) + sub;
 }
 
-static const char* rift_get_config_value(rift_governance_t* gov, const char* key) {
-    for (size_t i = 0; i < gov->count; i++) {
-        if (strcmp(gov->entries[i].intention, key) == 0) {
-            return gov->entries[i].pattern;
-        }
-    }
-    return NULL;
+// Largest value that falls into bucket
+static uint64_t rift_histogram_bucket_limit(size_t bucket) {
+    if (bucket < RIFT_HISTOGRAM_EXACT) return bucket;
+    size_t index = bucket - RIFT_HISTOGRAM_EXACT;
+    int exponent = (int)(index >> RIFT_HISTOGRAM_SUB_BITS) + 4;
+    uint64_t sub = index & ((1 << RIFT_HISTOGRAM_SUB_BITS) - 1);
+    uint64_t width = (uint64_t)1 << (exponent - RIFT_HISTOGRAM_SUB_BITS);
+    return (((uint64_t)1 << RIFT_HISTOGRAM_SUB_BITS) + sub) * width + width - 1;
 }
 
-// ================================
-// RIFT-0: Tokenizer Implementation
-// ================================
+static void rift_counter_add(atomic_uint_least64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
 
-static rift_tokenizer_t* rift_tokenizer_create(rift_governance_t* gov) {
-    rift_tokenizer_t* tokenizer = malloc(sizeof(rift_tokenizer_t));
-    if (!tokenizer) return NULL;
-    
-    tokenizer->governance = gov;
-    tokenizer->state_count = 4;
-    tokenizer->states = malloc(sizeof(rift_state_t*) * tokenizer->state_count);
+// Value at quantile q (0..1], reported as the upper edge of its bucket
+static uint64_t rift_histogram_quantile(const rift_histogram_t* histogram, uint64_t count, double q) {
+    uint64_t rank = (uint64_t)ceil(q * (double)count);
+    if (rank == 0) rank = 1;
     
-    // Create states based on governance configuration
-    for (size_t i = 0; i < tokenizer->state_count; i++) {
-        tokenizer->states[i] = malloc(sizeof(rift_state_t));
-        tokenizer->states[i]->id = i;
-        tokenizer->states[i]->is_final = true;
+    uint64_t seen = 0;
+    uint64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    for (size_t b = 0; b < RIFT_HISTOGRAM_BUCKETS; b++) {
+        seen += atomic_load_explicit(&histogram->buckets[b], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t limit = rift_histogram_bucket_limit(b);
+            return limit < max ? limit : max;
+        }
     }
-    
-    // Configure states from governance
-    tokenizer->states[0]->pattern = strdup(rift_get_config_value(gov, "IDENTIFIER_RECOGNITION"));
-    tokenizer->states[0]->type = TOKEN_IDENTIFIER;
-    
-    tokenizer->states[1]->pattern = strdup(rift_get_config_value(gov, "NUMBER_RECOGNITION"));
-    tokenizer->states[1]->type = TOKEN_NUMBER;
-    
-    tokenizer->states[2]->pattern = strdup(rift_get_config_value(gov, "OPERATOR_RECOGNITION"));
-    tokenizer->states[2]->type = TOKEN_OPERATOR;
-    
-    tokenizer->states[3]->pattern = strdup("^\\s+$");  // C11 standard whitespace pattern
-    tokenizer->states[3]->type = TOKEN_WHITESPACE;
-    
-    return tokenizer;
+    return max;
 }
 
-static void rift_tokenizer_destroy(rift_tokenizer_t* tokenizer) {
-    if (!tokenizer) return;
+static void rift_timing_dump(const char* trigger) {
+    char line[4096];
+    size_t length = (size_t)snprintf(line, sizeof(line), "{\"rift_timing\":{\"trigger\":\"%s\",\"timers\":[",
+                                     trigger);
+    bool first = true;
     
-    for (size_t i = 0; i < tokenizer->state_count; i++) {
-        free(tokenizer->states[i]->pattern);
-        free(tokenizer->states[i]);
+    for (int t = 0; t < RIFT_TIMER_COUNT && length < sizeof(line); t++) {
+        const rift_histogram_t* histogram = &rift_timers[t];
+        uint64_t count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+        if (count == 0) continue;
+        
+        length += (size_t)snprintf(line + length, sizeof(line) - length,
+                                   "%s{\"name\":\"%s\",\"count\":%llu,\"p50_ns\":%llu,"
+                                   "\"p99_ns\":%llu,\"max_ns\":%llu,\"total_ns\":%llu}",
+                                   first ? "" : ",", rift_timer_names[t], (unsigned long long)count,
+                                   (unsigned long long)rift_histogram_quantile(histogram, count, 0.50),
+                                   (unsigned long long)rift_histogram_quantile(histogram, count, 0.99),
+                                   (unsigned long long)atomic_load_explicit(&histogram->max_ns, memory_order_relaxed),
+                                   (unsigned long long)atomic_load_explicit(&histogram->total_ns, memory_order_relaxed));
+        first = false;
     }
-    free(tokenizer->states);
-    free(tokenizer);
+    if (length >= sizeof(line)) length = sizeof(line) - 1;
+    
+    fprintf(stderr, "%.*s]}}\n", (int)length, line);
 }
 
-static bool matches_pattern(const char* pattern, const char* text) {
-    regex_t regex;
-    int result = regcomp(&regex, pattern, REG_EXTENDED);
-    if (result) return false;
-    
-    result = regexec(&regex, text, 0, NULL, 0);
-    regfree(&regex);
-    return (result == 0);
+static void rift_timing_dump_at_exit(void) {
+    rift_timing_dump("exit");
 }
 
-static token_stream_t* rift_tokenize(rift_tokenizer_t* tokenizer, const char* input) {
-    rift_print_stage_info("RIFT-0", "DFA-based tokenization starting");
+// SIGUSR1 is blocked in every thread and taken here with sigwait, so the
+// dump runs as ordinary code rather than in signal context
+static void* rift_timing_signal_thread(void* arg) {
+    sigset_t* signals = arg;
+    int signal_number;
+    while (sigwait(signals, &signal_number) == 0) rift_timing_dump("SIGUSR1");
+    return NULL;
+}
+
+static inline uint64_t rift_timer_start(void) {
+    return rift_timing_enabled ? rift_clock_ns() : 0;
+}
+
+static void rift_timer_stop(rift_timer_id_t id, uint64_t start) {
+    if (!rift_timing_enabled) return;
     
-    token_stream_t* stream = malloc(sizeof(token_stream_t));
-    stream->capacity = 10;
-    stream->count = 0;
-    stream->tokens = malloc(sizeof(rift_token_t) * stream->capacity);
-    
-    // Simple tokenization: split by spaces and classify each token
-    char* input_copy = strdup(input);
-    char* token_str = strtok(input_copy, " ");
-    
-    while (token_str != NULL) {
-        // Skip whitespace tokens for this demo
-        if (strlen(token_str) > 0 && token_str[0] != ' ') {
-            // Resize if needed
-            if (stream->count >= stream->capacity) {
-                stream->capacity *= 2;
-                stream->tokens = realloc(stream->tokens, sizeof(rift_token_t) * stream->capacity);
-            }
-            
-            rift_token_t* token = &stream->tokens[stream->count++];
-            token->value = strdup(token_str);
-            token->line = 1;
-            token->column = stream->count;
-            token->type = TOKEN_UNKNOWN;
-            
-            // Classify token using DFA states
-            for (size_t i = 0; i < tokenizer->state_count; i++) {
-                if (matches_pattern(tokenizer->states[i]->pattern, token_str)) {
-                    token->type = tokenizer->states[i]->type;
-                    break;
-                }
-            }
-            
-            const char* type_name = "UNKNOWN";
-            switch (token->type) {
-                case TOKEN_IDENTIFIER: type_name = "IDENTIFIER"; break;
-                case TOKEN_NUMBER: type_name = "NUMBER"; break;
-                case TOKEN_OPERATOR: type_name = "OPERATOR"; break;
-                case TOKEN_WHITESPACE: type_name = "WHITESPACE"; break;
-                default: break;
-            }
-            
-            printf("  → Token: '%s' classified as %s\n", token_str, type_name);
-        }
-        
-        token_str = strtok(NULL, " ");
+    uint64_t elapsed = rift_clock_ns() - start;
+    rift_histogram_t* histogram = &rift_timers[id];
+    rift_counter_add(&histogram->buckets[rift_histogram_bucket(elapsed)], 1);
+    rift_counter_add(&histogram->count, 1);
+    rift_counter_add(&histogram->total_ns, elapsed);
+    if (elapsed > atomic_load_explicit(&histogram->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&histogram->max_ns, elapsed, memory_order_relaxed);
     }
-    
-    free(input_copy);
-    printf("  → Tokenization complete: %zu tokens generated\n", stream->count);
-    return stream;
 }
 
-static void token_stream_destroy(token_stream_t* stream) {
-    if (!stream) return;
+static void rift_timing_configure(rift_governance_t* gov) {
+    const char* timing = rift_get_config_value(gov, "stage_timing");
+    const char* monitoring = rift_get_config_value(gov, "performance_monitoring");
+    
+    rift_timing_enabled = timing && strcmp(timing, "enabled") == 0;
+    if (!rift_timing_enabled) return;
     
-    for (size_t i = 0; i < stream->count; i++) {
-        free(stream->tokens[i].value);
+    atexit(rift_timing_dump_at_exit);
+    if (monitoring && strcmp(monitoring, "enabled") == 0) {
+        // Runs before any stage thread exists, so every thread inherits the mask
+        static sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        pthread_sigmask(SIG_BLOCK, &signals, NULL);
+        
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, rift_timing_signal_thread, &signals) == 0) {
+            pthread_detach(thread);
+        } else {
+            fprintf(stderr, "performance_monitoring: cannot start the SIGUSR1 thread; "
+                    "timing is only reported at exit\n");
+        }
     }
-    free(stream->tokens);
-    free(stream);
 }
 
 // ================================
-// RIFT-1: Parser Implementation
+// Allocator Implementation
+// The tracking allocator prefixes every block with its size, so frees and
+// reallocs can be accounted without the caller passing sizes around.
 // ================================
 
-static rift_parser_t* rift_parser_create(rift_governance_t* gov) {
-    rift_parser_t* parser = malloc(sizeof(rift_parser_t));
-    if (!parser) return NULL;
-    
-    parser->governance = gov;
-    parser->current_position = 0;
-    return parser;
-}
+typedef union {
+    size_t size;
+    max_align_t align;     // Keeps the returned block aligned for any type
+} rift_alloc_header_t;
 
-static void rift_parser_destroy(rift_parser_t* parser) {
-    if (parser) free(parser);
+static void* rift_system_allocate(rift_allocator_t* allocator, size_t size) {
+    (void)allocator;
+    return malloc(size);
 }
 
-static ast_node_t* create_ast_node(ast_node_type_t type, const char* value) {
-    ast_node_t* node = malloc(sizeof(ast_node_t));
-    node->type = type;
-    node->value = value ? strdup(value) : NULL;
-    node->left = NULL;
-    node->right = NULL;
-    return node;
+static void* rift_system_reallocate(rift_allocator_t* allocator, void* ptr, size_t size) {
+    (void)allocator;
+    return realloc(ptr, size);
 }
 
-// Forward declarations for recursive descent parser
-static ast_node_t* parse_expression(rift_parser_t* parser);
-static ast_node_t* parse_term(rift_parser_t* parser);
-static ast_node_t* parse_factor(rift_parser_t* parser);
-
-static rift_token_t* current_token(rift_parser_t* parser) {
-    if (parser->current_position >= parser->input_tokens->count) return NULL;
-    return &parser->input_tokens->tokens[parser->current_position];
+static void rift_system_release(rift_allocator_t* allocator, void* ptr) {
+    (void)allocator;
+    free(ptr);
 }
 
-static void advance_token(rift_parser_t* parser) {
-    if (parser->current_position < parser->input_tokens->count) {
-        parser->current_position++;
+static void rift_alloc_stats_grow(rift_alloc_stats_t* stats, size_t bytes) {
+    atomic_fetch_add_explicit(&stats->bytes_allocated, bytes, memory_order_relaxed);
+    uint64_t live = atomic_fetch_add_explicit(&stats->live_bytes, bytes, memory_order_relaxed) + bytes;
+    uint64_t peak = atomic_load_explicit(&stats->peak_bytes, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&stats->peak_bytes, &peak, live,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
     }
 }
 
-static ast_node_t* parse_factor(rift_parser_t* parser) {
-    rift_token_t* token = current_token(parser);
-    if (!token) return NULL;
+static void* rift_tracking_allocate(rift_allocator_t* allocator, size_t size) {
+    if (size > SIZE_MAX - sizeof(rift_alloc_header_t)) return NULL;
     
-    if (token->type == TOKEN_IDENTIFIER) {
-        advance_token(parser);
-        return create_ast_node(AST_IDENTIFIER, token->value);
-    } else if (token->type == TOKEN_NUMBER) {
-        advance_token(parser);
-        return create_ast_node(AST_NUMBER, token->value);
-    }
+    rift_alloc_header_t* header = malloc(sizeof(rift_alloc_header_t) + size);
+    if (!header) return NULL;
+    header->size = size;
     
-    return NULL;
+    rift_alloc_stats_t* stats = &allocator->stats;
+    atomic_fetch_add_explicit(&stats->allocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->live_objects, 1, memory_order_relaxed);
+    rift_alloc_stats_grow(stats, size);
+    return header + 1;
 }
 
-static ast_node_t* parse_term(rift_parser_t* parser) {
-    ast_node_t* left = parse_factor(parser);
+static void* rift_tracking_reallocate(rift_allocator_t* allocator, void* ptr, size_t size) {
+    if (!ptr) return rift_tracking_allocate(allocator, size);
+    if (size > SIZE_MAX - sizeof(rift_alloc_header_t)) return NULL;
     
-    while (current_token(parser) && 
-           current_token(parser)->type == TOKEN_OPERATOR &&
-           (strcmp(current_token(parser)->value, "*") == 0 || 
-            strcmp(current_token(parser)->value, "/") == 0)) {
-        
-        char* op = strdup(current_token(parser)->value);
-        advance_token(parser);
-        
-        ast_node_t* right = parse_factor(parser);
-        ast_node_t* binary_op = create_ast_node(AST_BINARY_OP, op);
-        binary_op->left = left;
-        binary_op->right = right;
-        left = binary_op;
-        free(op);
-    }
+    rift_alloc_header_t* header = (rift_alloc_header_t*)ptr - 1;
+    size_t old_size = header->size;
+    header = realloc(header, sizeof(rift_alloc_header_t) + size);
+    if (!header) return NULL;
+    header->size = size;
     
-    return left;
+    rift_alloc_stats_t* stats = &allocator->stats;
+    atomic_fetch_add_explicit(&stats->reallocations, 1, memory_order_relaxed);
+    if (size > old_size) {
+        rift_alloc_stats_grow(stats, size - old_size);
+    } else {
+        atomic_fetch_sub_explicit(&stats->live_bytes, old_size - size, memory_order_relaxed);
+    }
+    return header + 1;
 }
 
-static ast_node_t* parse_expression(rift_parser_t* parser) {
-    ast_node_t* left = parse_term(parser);
-    
-    while (current_token(parser) && 
-           current_token(parser)->type == TOKEN_OPERATOR &&
-           (strcmp(current_token(parser)->value, "+") == 0 || 
-            strcmp(current_token(parser)->value, "-") == 0)) {
-        
-        char* op = strdup(current_token(parser)->value);
-        advance_token(parser);
-        
-        ast_node_t* right = parse_term(parser);
-        ast_node_t* binary_op = create_ast_node(AST_BINARY_OP, op);
-        binary_op->left = left;
-        binary_op->right = right;
-        left = binary_op;
-        free(op);
-    }
+static void rift_tracking_release(rift_allocator_t* allocator, void* ptr) {
+    if (!ptr) return;
     
-    return left;
+    rift_alloc_header_t* header = (rift_alloc_header_t*)ptr - 1;
+    rift_alloc_stats_t* stats = &allocator->stats;
+    atomic_fetch_add_explicit(&stats->frees, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&stats->live_objects, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&stats->live_bytes, header->size, memory_order_relaxed);
+    free(header);
 }
 
-static ast_node_t* rift_parse(rift_parser_t* parser, token_stream_t* tokens) {
-    rift_print_stage_info("RIFT-1", "Parsing token stream to AST");
-    
-    parser->input_tokens = tokens;
-    parser->current_position = 0;
-    
-    ast_node_t* ast = parse_expression(parser);
-    
-    printf("  → Parsing complete: AST root created\n");
-    return ast;
+static rift_allocator_t rift_system_allocator = {
+    "system", rift_system_allocate, rift_system_reallocate, rift_system_release, false, {0}
+};
+
+#define RIFT_TRACKING_ALLOCATOR(stage_name) \
+    {stage_name, rift_tracking_allocate, rift_tracking_reallocate, rift_tracking_release, true, {0}}
+
+// Handed out per stage only when memory_tracking is enabled
+static rift_allocator_t rift_tracking_allocators[RIFT_MEMORY_STAGE_COUNT] = {
+    RIFT_TRACKING_ALLOCATOR("governance"),
+    RIFT_TRACKING_ALLOCATOR("RIFT-0"),
+    RIFT_TRACKING_ALLOCATOR("RIFT-1"),
+    RIFT_TRACKING_ALLOCATOR("RIFT-2"),
+    RIFT_TRACKING_ALLOCATOR("RIFT-3")
+};
+
+static inline void* rift_alloc(rift_allocator_t* allocator, size_t size) {
+    return allocator->allocate(allocator, size);
 }
 
-// ================================
-// RIFT-2: AST Coordinator Implementation
-// ================================
+static void* rift_calloc(rift_allocator_t* allocator, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* ptr = allocator->allocate(allocator, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
 
-static rift_ast_coordinator_t* rift_ast_coordinator_create(rift_governance_t* gov) {
-    rift_ast_coordinator_t* coordinator = malloc(sizeof(rift_ast_coordinator_t));
-    if (!coordinator) return NULL;
-    
-    coordinator->governance = gov;
-    coordinator->node_count = 0;
-    coordinator->optimization_passes = 1;
-    return coordinator;
+static inline void* rift_realloc(rift_allocator_t* allocator, void* ptr, size_t size) {
+    return allocator->reallocate(allocator, ptr, size);
 }
 
-static void rift_ast_coordinator_destroy(rift_ast_coordinator_t* coordinator) {
-    if (coordinator) free(coordinator);
+static inline void rift_free(rift_allocator_t* allocator, void* ptr) {
+    allocator->release(allocator, ptr);
 }
 
-static size_t count_ast_nodes(ast_node_t* node) {
-    if (!node) return 0;
-    return 1 + count_ast_nodes(node->left) + count_ast_nodes(node->right);
+static char* rift_strdup(rift_allocator_t* allocator, const char* str) {
+    size_t length = strlen(str) + 1;
+    char* copy = allocator->allocate(allocator, length);
+    if (copy) memcpy(copy, str, length);
+    return copy;
 }
 
-static ast_node_t* rift_coordinate_ast(rift_ast_coordinator_t* coordinator, ast_node_t* ast) {
-    rift_print_stage_info("RIFT-2", "Coordinating and optimizing AST");
-    
-    coordinator->root = ast;
-    coordinator->node_count = count_ast_nodes(ast);
-    
-    printf("  → AST contains %zu nodes\n", coordinator->node_count);
-    printf("  → Applying %zu optimization passes\n", coordinator->optimization_passes);
-    printf("  → AST coordination complete\n");
-    
-    return ast;
+// Credits allocator with count produced items, for the per-item ratios
+static inline void rift_allocator_count_items(rift_allocator_t* allocator, size_t count) {
+    if (allocator->tracking) {
+        atomic_fetch_add_explicit(&allocator->stats.items, count, memory_order_relaxed);
+    }
 }
 
-// ================================
-// RIFT-3: Output Stage Implementation
-// ================================
+static double rift_alloc_bytes_per_item(const rift_allocator_t* allocator) {
+    uint64_t items = atomic_load_explicit(&allocator->stats.items, memory_order_relaxed);
+    uint64_t bytes = atomic_load_explicit(&allocator->stats.bytes_allocated, memory_order_relaxed);
+    return items ? (double)bytes / (double)items : 0.0;
+}
 
-static rift_output_stage_t* rift_output_stage_create(rift_governance_t* gov) {
-    rift_output_stage_t* output = malloc(sizeof(rift_output_stage_t));
-    if (!output) return NULL;
-    
-    output->governance = gov;
-    output->output_format = strdup("LISP_STYLE_AST");
-    return output;
+// One JSON line on stderr. The per-item ratios divide everything the stage
+// allocated (setup included) by what it produced, so over a batch they show
+// how well storage is reused.
+static void rift_memory_dump(void) {
+    fprintf(stderr, "{\"rift_memory\":{\"stages\":[");
+    for (int s = 0; s < RIFT_MEMORY_STAGE_COUNT; s++) {
+        rift_alloc_stats_t* stats = &rift_tracking_allocators[s].stats;
+        fprintf(stderr, "%s{\"name\":\"%s\",\"allocations\":%llu,\"reallocations\":%llu,"
+                "\"frees\":%llu,\"bytes_allocated\":%llu,\"peak_bytes\":%llu,"
+                "\"live_bytes\":%llu,\"live_objects\":%llu}",
+                s ? "," : "", rift_tracking_allocators[s].name,
+                (unsigned long long)atomic_load(&stats->allocations),
+                (unsigned long long)atomic_load(&stats->reallocations),
+                (unsigned long long)atomic_load(&stats->frees),
+                (unsigned long long)atomic_load(&stats->bytes_allocated),
+                (unsigned long long)atomic_load(&stats->peak_bytes),
+                (unsigned long long)atomic_load(&stats->live_bytes),
+                (unsigned long long)atomic_load(&stats->live_objects));
+    }
+    fprintf(stderr, "],\"tokens\":%llu,\"bytes_per_token\":%.2f,"
+            "\"ast_nodes\":%llu,\"bytes_per_ast_node\":%.2f}}\n",
+            (unsigned long long)atomic_load(&rift_tracking_allocators[RIFT_MEMORY_RIFT0].stats.items),
+            rift_alloc_bytes_per_item(&rift_tracking_allocators[RIFT_MEMORY_RIFT0]),
+            (unsigned long long)atomic_load(&rift_tracking_allocators[RIFT_MEMORY_RIFT1].stats.items),
+            rift_alloc_bytes_per_item(&rift_tracking_allocators[RIFT_MEMORY_RIFT1]));
 }
 
-static void rift_output_stage_destroy(rift_output_stage_t* output) {
-    if (!output) return;
-    free(output->output_format);
-    free(output);
+static bool rift_memory_tracking_requested(rift_governance_t* gov) {
+    const char* tracking = rift_get_config_value(gov, "memory_tracking");
+    return tracking && strcmp(tracking, "enabled") == 0;
 }
 
-static void print_ast_recursive(ast_node_t* node, int indent) {
-    if (!node) return;
-    
-    for (int i = 0; i < indent; i++) printf("  ");
+// memory_tracking=enabled (global.rift [DEVELOPMENT_MODE]) switches every
+// stage created afterwards to its tracking allocator and reports at exit
+static void rift_memory_configure(rift_governance_t* gov) {
+    if (!rift_memory_tracking_requested(gov)) return;
     
-    switch (node->type) {
-        case AST_IDENTIFIER:
-            printf("(Identifier %s)\n", node->value);
-            break;
-        case AST_NUMBER:
-            printf("(Number %s)\n", node->value);
-            break;
-        case AST_BINARY_OP:
-            printf("(BinOp %s\n", node->value);
-            print_ast_recursive(node->left, indent + 1);
-            print_ast_recursive(node->right, indent + 1);
-            for (int i = 0; i < indent; i++) printf("  ");
-            printf(")\n");
-            break;
-        default:
-            printf("(Unknown)\n");
-            break;
+    for (int s = RIFT_MEMORY_RIFT0; s < RIFT_MEMORY_STAGE_COUNT; s++) {
+        gov->allocators[s] = &rift_tracking_allocators[s];
     }
+    atexit(rift_memory_dump);
 }
 
-static void rift_generate_output(rift_output_stage_t* output, ast_node_t* ast) {
-    rift_print_stage_info("RIFT-3", "Generating final output");
-    
-    output->ast = ast;
-    
-    printf("  → Output format: %s\n", output->output_format);
-    printf("  → Final AST structure:\n");
-    printf("(AST\n");
-    print_ast_recursive(ast, 1);
-    printf(")\n");
+static rift_allocator_t* rift_governance_allocator(rift_governance_t* gov, rift_memory_stage_t stage) {
+    return gov->allocators[stage];
 }
 
 // ================================
-// Utility Functions
+// Governance Implementation
 // ================================
 
-static void rift_print_stage_info(const char* stage, const char* message) {
-    printf("\n[%s] %s\n", stage, message);
+// Open-addressing hash index over an external array. Each slot keeps the
+// item's hash and its position + 1 (0 marks an empty slot); capacity is a
+// power of two kept at most half full. Items are never removed, so the probe
+// sequence returns duplicates in insertion order.
+#define CONFIG_INDEX_END ((size_t)-1)
+
+static bool config_index_grow(config_index_t* index) {
+    size_t capacity = index->capacity ? index->capacity * 2 : 16;
+    config_index_slot_t* slots = rift_calloc(index->allocator, capacity, sizeof(config_index_slot_t));
+    if (!slots) return false;
+    
+    for (size_t i = 0; i < index->capacity; i++) {
+        config_index_slot_t slot = index->slots[i];
+        if (!slot.position) continue;
+        size_t probe = slot.hash & (capacity - 1);
+        while (slots[probe].position) probe = (probe + 1) & (capacity - 1);
+        slots[probe] = slot;
+    }
+    
+    rift_free(index->allocator, index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    return true;
 }
 
-static void ast_node_destroy(ast_node_t* node) {
-    if (!node) return;
+static bool config_index_insert(config_index_t* index, size_t hash, size_t position) {
+    if ((index->count + 1) * 2 > index->capacity && !config_index_grow(index)) return false;
     
-    ast_node_destroy(node->left);
-    ast_node_destroy(node->right);
-    free(node->value);
-    free(node);
+    size_t probe = hash & (index->capacity - 1);
+    while (index->slots[probe].position) probe = (probe + 1) & (index->capacity - 1);
+    index->slots[probe].hash = hash;
+    index->slots[probe].position = position + 1;
+    index->count++;
+    return true;
 }
 
-// ================================
-// Main Execution Pipeline
-// OBINexus Framework - Complete RIFT Architecture
-// ================================
+// Iterates the positions whose hash equals hash; start with *cursor = hash.
+// Returns CONFIG_INDEX_END when the probe reaches an empty slot.
+static size_t config_index_next(const config_index_t* index, size_t hash, size_t* cursor) {
+    if (!index->capacity) return CONFIG_INDEX_END;
+    
+    size_t mask = index->capacity - 1;
+    for (size_t probe = *cursor & mask; index->slots[probe].position; probe = (probe + 1) & mask) {
+        if (index->slots[probe].hash == hash) {
+            *cursor = probe + 1;
+            return index->slots[probe].position - 1;
+        }
+    }
+    return CONFIG_INDEX_END;
+}
 
-int main(void) {
-    printf("RIFT Complete Pipeline Simulation\n");
-    printf("==================================\n");
-    printf("OBINexus Framework - RIFT Architecture\n");
-    printf("Toolchain: riftlang.exe → .so.a → rift.exe → gosilang\n");
-    printf("Executing RIFT-0 → RIFT-1 → RIFT-2 → RIFT-3\n");
+static void config_index_release(config_index_t* index) {
+    rift_free(index->allocator, index->slots);
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+static bool rift_governance_add(rift_governance_t* gov, const char* pattern,
+                                const char* intention, const char* sp_alignment) {
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_GOVERNANCE);
     
-    // Initialize governance from .rift configuration files
-    rift_governance_t* governance = rift_load_governance("rift-gov/");
-    if (!governance) {
-        fprintf(stderr, "Failed to load RIFT governance configuration\n");
-        return 1;
+    // Resize if needed
+    if (gov->count >= gov->capacity) {
+        size_t new_capacity = gov->capacity * 2;
+        rift_config_entry_t** new_entries = rift_realloc(allocator, gov->entries,
+                                                         sizeof(rift_config_entry_t*) * new_capacity);
+        if (!new_entries) return false;
+        gov->entries = new_entries;
+        gov->capacity = new_capacity;
     }
     
-    // Test input: mathematical expression
-    const char* source_input = "x + 2 * y";
-    printf("\nProcessing input: \"%s\"\n", source_input);
+    rift_config_entry_t* entry = rift_alloc(allocator, sizeof(rift_config_entry_t));
+    if (!entry) return false;
+    entry->pattern = rift_strdup(allocator, pattern);
+    entry->intention = rift_strdup(allocator, intention);
+    entry->sp_alignment = rift_strdup(allocator, sp_alignment);
+    entry->hash = rift_hash_string(intention);
+    if (!config_index_insert(&gov->index, entry->hash, gov->count)) {
+        rift_free(allocator, entry->pattern);
+        rift_free(allocator, entry->intention);
+        rift_free(allocator, entry->sp_alignment);
+        rift_free(allocator, entry);
+        return false;
+    }
+    gov->entries[gov->count++] = entry;
+    return true;
+}
+
+// Maps a governance file privately and writable, so the parser can terminate
+// keys and values in place. Falls back to a heap copy when the file has no
+// spare byte after its end within the last page.
+static bool config_file_open(config_file_t* file, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
     
-    // RIFT-0: Tokenization Stage
-    rift_tokenizer_t* tokenizer = rift_tokenizer_create(governance);
-    if (!tokenizer) {
-        fprintf(stderr, "Failed to create tokenizer\n");
-        rift_governance_destroy(governance);
-        return 1;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
     }
     
-    token_stream_t* tokens = rift_tokenize(tokenizer, source_input);
-    if (!tokens) {
-        fprintf(stderr, "Failed to tokenize input\n");
-        rift_tokenizer_destroy(tokenizer);
-        rift_governance_destroy(governance);
+    file->length = (size_t)st.st_size;
+    file->mapped = false;
+    long page_size = sysconf(_SC_PAGESIZE);
+    
+    if (file->length > 0 && page_size > 0 && file->length % (size_t)page_size != 0) {
+        void* data = mmap(NULL, file->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            file->data = data;
+            file->mapped = true;
+            close(fd);
+            return true;
+        }
+    }
+    
+    file->data = malloc(file->length + 1);
+    size_t filled = 0;
+    while (file->data && filled < file->length) {
+        ssize_t got = read(fd, file->data + filled, file->length - filled);
+        if (got <= 0) break;
+        filled += (size_t)got;
+    }
+    close(fd);
+    
+    if (!file->data || filled != file->length) {
+        free(file->data);
+        return false;
+    }
+    file->data[file->length] = '\0';
+    return true;
+}
+
+static void config_file_close(config_file_t* file) {
+    if (file->mapped) munmap(file->data, file->length);
+    else free(file->data);
+    file->data = NULL;
+    file->length = 0;
+}
+
+static char* config_trim(char* begin, char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+    *end = '\0';
+    return begin;
+}
+
+// Single pass over the file text: [SECTION] headers, key=value lines and
+// '#'/';' comments. Strings are terminated in place, nothing is copied. Lines
+// before the first section header are ignored.
+static void config_file_parse(config_file_t* file, config_visit_fn visit, void* context) {
+    char* text = file->data;
+    char* end = text + file->length;
+    const char* section = NULL;
+    
+    while (text < end) {
+        char* line_end = memchr(text, '\n', (size_t)(end - text));
+        if (!line_end) line_end = end;
+        
+        char* line = text;
+        while (line < line_end && (*line == ' ' || *line == '\t')) line++;
+        
+        if (line < line_end && *line == '[') {
+            char* close = memchr(line, ']', (size_t)(line_end - line));
+            if (close) section = config_trim(line + 1, close);
+        } else if (section && line < line_end && *line != '#' && *line != ';') {
+            char* equals = memchr(line, '=', (size_t)(line_end - line));
+            if (equals) {
+                char* key = config_trim(line, equals);
+                char* value = config_trim(equals + 1, line_end);
+                if (*key) visit(context, section, key, value);
+            }
+        }
+        
+        text = line_end + 1;
+    }
+}
+
+// Replaces the value of an existing key, or adds it
+static bool rift_governance_set(rift_governance_t* gov, const char* pattern,
+                                const char* intention, const char* sp_alignment) {
+    rift_config_entry_t* entry = (rift_config_entry_t*)rift_governance_find(gov, intention);
+    if (entry) {
+        rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_GOVERNANCE);
+        char* value = rift_strdup(allocator, pattern);
+        char* alignment = rift_strdup(allocator, sp_alignment);
+        if (!value || !alignment) {
+            rift_free(allocator, value);
+            rift_free(allocator, alignment);
+            return false;
+        }
+        rift_free(allocator, entry->pattern);
+        rift_free(allocator, entry->sp_alignment);
+        entry->pattern = value;
+        entry->sp_alignment = alignment;
+        return true;
+    }
+    return rift_governance_add(gov, pattern, intention, sp_alignment);
+}
+
+// Length of NAME in a NAME_PATTERN key, 0 if key does not name a token pattern
+static size_t token_pattern_name_length(const char* key) {
+    size_t length = strlen(key);
+    if (length <= 8 || strcmp(key + length - 8, "_PATTERN") != 0) return 0;
+    return length - 8;
+}
+
+typedef struct {
+    rift_governance_t* gov;
+    int stage_id;
+    char sp_alignment[64];     // STAGE_<id>_<stage_name> once metadata is seen
+    size_t entries;
+} governance_file_context_t;
+
+static void governance_file_visit(void* context, const char* section, const char* key,
+                                  const char* value) {
+    governance_file_context_t* file = context;
+    
+    if (strcmp(section, "STAGE_METADATA") == 0) {
+        if (strcmp(key, "stage_name") == 0 && file->stage_id >= 0) {
+            snprintf(file->sp_alignment, sizeof(file->sp_alignment), "STAGE_%d_%s",
+                     file->stage_id, value);
+        }
+        return;
+    }
+    
+    // Token patterns are written with "\\" for one backslash; store them as
+    // the compilers read them
+    if (strcmp(section, "TOKEN_PATTERNS") == 0 && token_pattern_name_length(key)) {
+        rift_allocator_t* allocator = rift_governance_allocator(file->gov, RIFT_MEMORY_GOVERNANCE);
+        char* pattern = rift_strdup(allocator, value);
+        if (!pattern) return;
+        
+        char* out = pattern;
+        for (const char* p = pattern; *p; p++) {
+            *out++ = *p;
+            if (p[0] == '\\' && p[1] == '\\') p++;
+        }
+        *out = '\0';
+        
+        if (rift_governance_set(file->gov, pattern, key, file->sp_alignment)) file->entries++;
+        rift_free(allocator, pattern);
+        return;
+    }
+    
+    if (rift_governance_set(file->gov, value, key, file->sp_alignment)) file->entries++;
+}
+
+// Overlays .riftrc.0-3 and global.rift from config_dir on the built-in
+// entries. Returns the number of files found.
+static int rift_governance_load_files(rift_governance_t* gov, const char* config_dir) {
+    static const char* names[] = {".riftrc.0", ".riftrc.1", ".riftrc.2", ".riftrc.3", "global.rift"};
+    size_t dir_length = strlen(config_dir);
+    const char* separator = dir_length && config_dir[dir_length - 1] == '/' ? "" : "/";
+    int loaded = 0;
+    
+    for (int i = 0; i < 5; i++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s%s%s", config_dir, separator, names[i]);
+        
+        config_file_t text;
+        if (!config_file_open(&text, path)) continue;
+        
+        governance_file_context_t context = {gov, i < 4 ? i : -1, "", 0};
+        snprintf(context.sp_alignment, sizeof(context.sp_alignment),
+                 i < 4 ? "STAGE_%d" : "GLOBAL", i);
+        config_file_parse(&text, governance_file_visit, &context);
+        config_file_close(&text);
+        
+        rift_log("  → %s: %zu entries\n", path, context.entries);
+        loaded++;
+    }
+    return loaded;
+}
+
+static rift_governance_t* rift_load_governance(const char* config_dir, rift_allocator_t* allocator) {
+    rift_governance_t* gov = rift_alloc(allocator, sizeof(rift_governance_t));
+    if (!gov) return NULL;
+    
+    gov->allocators[RIFT_MEMORY_GOVERNANCE] = allocator;
+    for (int s = RIFT_MEMORY_RIFT0; s < RIFT_MEMORY_STAGE_COUNT; s++) {
+        gov->allocators[s] = &rift_system_allocator;
+    }
+    gov->capacity = 10;
+    gov->count = 0;
+    gov->index = (config_index_t){NULL, 0, 0, allocator};
+    gov->entries = rift_alloc(allocator, sizeof(rift_config_entry_t*) * gov->capacity);
+    
+    rift_print_stage_info("GOVERNANCE", "Loading .rift configuration files");
+    
+    // Simulate loading .riftrc.0 [TOKEN_PATTERNS] with standard C11 string literals
+    rift_governance_add(gov, "^[a-zA-Z_]\\w*$", "IDENTIFIER_PATTERN", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "100", "IDENTIFIER_PRIORITY", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "^\\d+(\\.\\d+)?$", "NUMBER_PATTERN", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "90", "NUMBER_PRIORITY", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "^[+\\-*/=<>!&|]$", "OPERATOR_PATTERN", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "80", "OPERATOR_PRIORITY", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "^\\s+$", "WHITESPACE_PATTERN", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "10", "WHITESPACE_PRIORITY", "STAGE_0_TOKENIZER");
+    
+    // Simulate loading .riftrc.0 [PERFORMANCE_TUNING]
+    rift_governance_add(gov, "256", "regex_cache_size", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "false", "parallel_tokenization", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "eager", "dfa_mode", "STAGE_0_TOKENIZER");
+    rift_governance_add(gov, "1024", "dfa_cache_kb", "STAGE_0_TOKENIZER");
+    
+    // Simulate loading .riftrc.1 [PRECEDENCE_TABLE], [OPERATOR_SYMBOLS], [AST_CONSTRUCTION]
+    rift_governance_add(gov, "20", "MULTIPLY_PRECEDENCE", "STAGE_1_PARSER");
+    rift_governance_add(gov, "20", "DIVIDE_PRECEDENCE", "STAGE_1_PARSER");
+    rift_governance_add(gov, "10", "PLUS_PRECEDENCE", "STAGE_1_PARSER");
+    rift_governance_add(gov, "10", "MINUS_PRECEDENCE", "STAGE_1_PARSER");
+    rift_governance_add(gov, "5", "ASSIGNMENT_PRECEDENCE", "STAGE_1_PARSER");
+    rift_governance_add(gov, "*", "MULTIPLY_SYMBOL", "STAGE_1_PARSER");
+    rift_governance_add(gov, "/", "DIVIDE_SYMBOL", "STAGE_1_PARSER");
+    rift_governance_add(gov, "+", "PLUS_SYMBOL", "STAGE_1_PARSER");
+    rift_governance_add(gov, "-", "MINUS_SYMBOL", "STAGE_1_PARSER");
+    rift_governance_add(gov, "=", "ASSIGNMENT_SYMBOL", "STAGE_1_PARSER");
+    rift_governance_add(gov, "left", "operator_association", "STAGE_1_PARSER");
+    
+    // Simulate loading .riftrc.2 [OPTIMIZATION_PASSES]
+    rift_governance_add(gov, "enabled", "constant_folding", "STAGE_2_AST_COORDINATOR");
+    
+    // Simulate loading .riftrc.3 [FORMATTING_RULES]
+    rift_governance_add(gov, "spaces", "indentation_style", "STAGE_3_OUTPUT");
+    rift_governance_add(gov, "2", "indentation_size", "STAGE_3_OUTPUT");
+    
+    // Simulate loading global.rift [PIPELINE_COORDINATION] and [DEVELOPMENT_MODE]
+    rift_governance_add(gov, "message_passing", "inter_stage_communication", "GLOBAL");
+    rift_governance_add(gov, "disabled", "performance_monitoring", "GLOBAL");
+    rift_governance_add(gov, "disabled", "stage_timing", "GLOBAL");
+    rift_governance_add(gov, "disabled", "memory_tracking", "GLOBAL");
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int files = config_dir ? rift_governance_load_files(gov, config_dir) : 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    if (files > 0) {
+        double micros = (double)(end.tv_sec - start.tv_sec) * 1e6 +
+                        (double)(end.tv_nsec - start.tv_nsec) / 1e3;
+        rift_log("  → Read %d governance files from %s in %.0f µs\n", files, config_dir, micros);
+    } else if (config_dir) {
+        rift_log("  → No governance files in %s, using built-in defaults\n", config_dir);
+    } else {
+        rift_log("  → No governance directory found, using built-in defaults\n");
+    }
+    rift_log("  → Loaded %zu configuration entries from .rift files\n", gov->count);
+    return gov;
+}
+
+static void rift_governance_destroy(rift_governance_t* gov) {
+    if (!gov) return;
+    
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_GOVERNANCE);
+    for (size_t i = 0; i < gov->count; i++) {
+        rift_free(allocator, gov->entries[i]->pattern);
+        rift_free(allocator, gov->entries[i]->intention);
+        rift_free(allocator, gov->entries[i]->sp_alignment);
+        rift_free(allocator, gov->entries[i]);
+    }
+    rift_free(allocator, gov->entries);
+    config_index_release(&gov->index);
+    rift_free(allocator, gov);
+}
+
+// Governance directory: RIFT_GOV_DIR, else rift-gov/ under the working
+// directory, else the in-tree governance as seen from gov-process/. NULL
+// when none of them holds a .riftrc.0.
+static const char* rift_governance_find_dir(void) {
+    static const char* fallbacks[] = {"rift-gov/", "../gov-stage/rift-gov/"};
+    const char* env = getenv("RIFT_GOV_DIR");
+    if (env && *env) return env;
+    
+    for (size_t i = 0; i < sizeof(fallbacks) / sizeof(fallbacks[0]); i++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s.riftrc.0", fallbacks[i]);
+        if (access(path, R_OK) == 0) return fallbacks[i];
+    }
+    return NULL;
+}
+
+// Loads governance through the allocator memory_tracking selects. The key is
+// only known once governance is loaded, so a tracked run loads it a second
+// time, quietly, through the governance tracking allocator.
+static rift_governance_t* rift_governance_open(const char* config_dir) {
+    rift_governance_t* gov = rift_load_governance(config_dir, &rift_system_allocator);
+    if (!gov || !rift_memory_tracking_requested(gov)) return gov;
+    
+    rift_governance_destroy(gov);
+    bool logging = rift_stage_logging;
+    rift_stage_logging = false;
+    gov = rift_load_governance(config_dir, &rift_tracking_allocators[RIFT_MEMORY_GOVERNANCE]);
+    rift_stage_logging = logging;
+    return gov;
+}
+
+// Resolves key to its entry. Entries never move and rift_governance_set
+// updates them in place, so the result is a stable handle for the lifetime
+// of the governance; read it through rift_config_entry_value.
+static const rift_config_entry_t* rift_governance_find(rift_governance_t* gov, const char* key) {
+    size_t hash = rift_hash_string(key);
+    size_t cursor = hash;
+    for (size_t i; (i = config_index_next(&gov->index, hash, &cursor)) != CONFIG_INDEX_END; ) {
+        if (strcmp(gov->entries[i]->intention, key) == 0) return gov->entries[i];
+    }
+    return NULL;
+}
+
+static inline const char* rift_config_entry_value(const rift_config_entry_t* entry) {
+    return entry ? entry->pattern : NULL;
+}
+
+static const char* rift_get_config_value(rift_governance_t* gov, const char* key) {
+    return rift_config_entry_value(rift_governance_find(gov, key));
+}
+
+// ================================
+// Regex Cache Implementation
+// ================================
+
+static size_t rift_hash_string(const char* str) {
+    // FNV-1a
+    size_t hash = (size_t)14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        hash ^= *p;
+        hash *= (size_t)1099511628211ULL;
+    }
+    return hash;
+}
+
+static rift_regex_cache_t* rift_regex_cache_create(size_t capacity, rift_allocator_t* allocator) {
+    rift_regex_cache_t* cache = rift_alloc(allocator, sizeof(rift_regex_cache_t));
+    if (!cache) return NULL;
+    
+    cache->entries = rift_alloc(allocator, sizeof(rift_regex_cache_entry_t) * capacity);
+    if (!cache->entries) {
+        rift_free(allocator, cache);
+        return NULL;
+    }
+    
+    cache->allocator = allocator;
+    cache->count = 0;
+    cache->capacity = capacity;
+    cache->clock = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    return cache;
+}
+
+static void rift_regex_cache_entry_release(rift_regex_cache_t* cache, rift_regex_cache_entry_t* entry) {
+    if (entry->compiled) regfree(&entry->regex);
+    rift_free(cache->allocator, entry->pattern);
+}
+
+static void rift_regex_cache_destroy(rift_regex_cache_t* cache) {
+    if (!cache) return;
+    
+    for (size_t i = 0; i < cache->count; i++) {
+        rift_regex_cache_entry_release(cache, &cache->entries[i]);
+    }
+    rift_free(cache->allocator, cache->entries);
+    rift_free(cache->allocator, cache);
+}
+
+static bool regex_cache_entry_is(rift_regex_cache_entry_t* entry, const char* pattern, size_t hash) {
+    return entry->hash == hash && strcmp(entry->pattern, pattern) == 0;
+}
+
+// Returns the compiled form of pattern, compiling it on a miss and evicting the
+// least recently used entry when full. slot_hint remembers where the pattern
+// was last found so repeated lookups skip the scan. NULL if regcomp failed.
+static const regex_t* rift_regex_cache_get(rift_regex_cache_t* cache, const char* pattern,
+                                           size_t hash, size_t* slot_hint) {
+    rift_regex_cache_entry_t* entry = NULL;
+    
+    if (*slot_hint < cache->count && regex_cache_entry_is(&cache->entries[*slot_hint], pattern, hash)) {
+        entry = &cache->entries[*slot_hint];
+    } else {
+        for (size_t i = 0; i < cache->count; i++) {
+            if (regex_cache_entry_is(&cache->entries[i], pattern, hash)) {
+                entry = &cache->entries[i];
+                *slot_hint = i;
+                break;
+            }
+        }
+    }
+    
+    if (entry) {
+        cache->hits++;
+        entry->last_used = ++cache->clock;
+        return entry->compiled ? &entry->regex : NULL;
+    }
+    
+    cache->misses++;
+    
+    // Copy the key first so a failed copy leaves the cache untouched
+    char* copy = rift_strdup(cache->allocator, pattern);
+    if (!copy) return NULL;
+    
+    size_t slot = cache->count;
+    if (cache->count < cache->capacity) {
+        cache->count++;
+    } else {
+        slot = 0;
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].last_used < cache->entries[slot].last_used) slot = i;
+        }
+        rift_regex_cache_entry_release(cache, &cache->entries[slot]);
+        cache->evictions++;
+    }
+    
+    entry = &cache->entries[slot];
+    entry->pattern = copy;
+    entry->hash = hash;
+    entry->compiled = (regcomp(&entry->regex, pattern, REG_EXTENDED | REG_NOSUB) == 0);
+    entry->last_used = ++cache->clock;
+    *slot_hint = slot;
+    
+    return entry->compiled ? &entry->regex : NULL;
+}
+
+// ================================
+// RIFT-0: Token DFA Compiler
+// Governance patterns → Thompson NFA → subset DFA → minimized DFA
+// ================================
+
+// Supported pattern dialect: literals, '.', [...] classes (with ranges,
+// negation and escapes), \w \d \s \W \D \S, grouping, '|', '*', '+', '?'.
+// Leading '^' and trailing '$' are implied for token patterns and ignored.
+
+#define RIFT_DFA_MAX_STATES 4096
+
+typedef struct {
+    uint64_t set[4];       // Bytes accepted by the consuming edge
+    int next;              // Target of the consuming edge, -1 if none
+    int eps[2];            // Epsilon edges, -1 if unused
+    int accept;            // Pattern index accepted here, -1 otherwise
+} rift_nfa_node_t;
+
+typedef struct {
+    rift_nfa_node_t* nodes;
+    size_t count;
+    size_t capacity;
+    rift_allocator_t* allocator;
+} rift_nfa_t;
+
+typedef struct {
+    int start;
+    int end;
+} rift_nfa_frag_t;
+
+typedef struct {
+    const char* p;
+    rift_nfa_t* nfa;
+    bool failed;
+} rift_pattern_parser_t;
+
+struct rift_dfa {
+    uint8_t byte_class[256];   // Byte → equivalence class
+    size_t class_count;
+    size_t state_count;
+    int32_t* transitions;      // [state * class_count + class], -1 = dead
+    int* accept;               // Pattern index accepted per state, -1 otherwise
+    int start;
+    rift_allocator_t* allocator;
+};
+
+static int nfa_new_node(rift_nfa_t* nfa) {
+    if (nfa->count >= nfa->capacity) {
+        size_t new_capacity = nfa->capacity ? nfa->capacity * 2 : 64;
+        rift_nfa_node_t* new_nodes = rift_realloc(nfa->allocator, nfa->nodes,
+                                                  sizeof(rift_nfa_node_t) * new_capacity);
+        if (!new_nodes) return -1;
+        nfa->nodes = new_nodes;
+        nfa->capacity = new_capacity;
+    }
+    
+    rift_nfa_node_t* node = &nfa->nodes[nfa->count];
+    memset(node->set, 0, sizeof(node->set));
+    node->next = -1;
+    node->eps[0] = -1;
+    node->eps[1] = -1;
+    node->accept = -1;
+    return (int)nfa->count++;
+}
+
+static void byte_set_add(uint64_t* set, unsigned char c) {
+    set[c >> 6] |= (uint64_t)1 << (c & 63);
+}
+
+static bool byte_set_has(const uint64_t* set, unsigned char c) {
+    return (set[c >> 6] >> (c & 63)) & 1;
+}
+
+static void byte_set_add_range(uint64_t* set, unsigned char lo, unsigned char hi) {
+    for (unsigned c = lo; c <= hi; c++) byte_set_add(set, (unsigned char)c);
+}
+
+// Adds the meaning of the escape letter c to set
+static void byte_set_add_escape(uint64_t* set, char c) {
+    uint64_t class_set[4] = {0, 0, 0, 0};
+    bool negate = false;
+    
+    switch (c) {
+        case 'W': negate = true; // fall through
+        case 'w':
+            byte_set_add_range(class_set, 'a', 'z');
+            byte_set_add_range(class_set, 'A', 'Z');
+            byte_set_add_range(class_set, '0', '9');
+            byte_set_add(class_set, '_');
+            break;
+        case 'D': negate = true; // fall through
+        case 'd':
+            byte_set_add_range(class_set, '0', '9');
+            break;
+        case 'S': negate = true; // fall through
+        case 's':
+            byte_set_add(class_set, ' ');
+            byte_set_add_range(class_set, '\t', '\r');
+            break;
+        case 'n': byte_set_add(class_set, '\n'); break;
+        case 't': byte_set_add(class_set, '\t'); break;
+        case 'r': byte_set_add(class_set, '\r'); break;
+        default:  byte_set_add(class_set, (unsigned char)c); break;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        set[i] |= negate ? ~class_set[i] : class_set[i];
+    }
+}
+
+static rift_nfa_frag_t nfa_frag_set(rift_pattern_parser_t* parser, const uint64_t* set) {
+    int start = nfa_new_node(parser->nfa);
+    int end = nfa_new_node(parser->nfa);
+    if (start < 0 || end < 0) {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    
+    memcpy(parser->nfa->nodes[start].set, set, sizeof(parser->nfa->nodes[start].set));
+    parser->nfa->nodes[start].next = end;
+    return (rift_nfa_frag_t){start, end};
+}
+
+static rift_nfa_frag_t parse_pattern_alternation(rift_pattern_parser_t* parser);
+
+static rift_nfa_frag_t parse_pattern_bracket(rift_pattern_parser_t* parser) {
+    uint64_t set[4] = {0, 0, 0, 0};
+    bool negate = false;
+    
+    if (*parser->p == '^') {
+        negate = true;
+        parser->p++;
+    }
+    
+    bool first = true;
+    while (*parser->p && (*parser->p != ']' || first)) {
+        first = false;
+        unsigned char lo = (unsigned char)*parser->p++;
+        
+        if (lo == '\\') {
+            char escaped = *parser->p++;
+            if (!escaped) break;
+            if (strchr("wdsWDS", escaped)) {
+                byte_set_add_escape(set, escaped);
+                continue;
+            }
+            lo = (unsigned char)escaped;
+        }
+        
+        if (parser->p[0] == '-' && parser->p[1] && parser->p[1] != ']') {
+            unsigned char hi = (unsigned char)parser->p[1];
+            parser->p += 2;
+            if (hi == '\\') {
+                hi = (unsigned char)*parser->p++;
+                if (!hi) break;
+            }
+            if (hi < lo) {
+                parser->failed = true;
+                return (rift_nfa_frag_t){-1, -1};
+            }
+            byte_set_add_range(set, lo, hi);
+        } else {
+            byte_set_add(set, lo);
+        }
+    }
+    
+    if (*parser->p != ']') {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    parser->p++;
+    
+    if (negate) {
+        for (int i = 0; i < 4; i++) set[i] = ~set[i];
+    }
+    return nfa_frag_set(parser, set);
+}
+
+static rift_nfa_frag_t parse_pattern_atom(rift_pattern_parser_t* parser) {
+    uint64_t set[4] = {0, 0, 0, 0};
+    char c = *parser->p++;
+    
+    switch (c) {
+        case '(': {
+            rift_nfa_frag_t inner = parse_pattern_alternation(parser);
+            if (*parser->p != ')') {
+                parser->failed = true;
+                return (rift_nfa_frag_t){-1, -1};
+            }
+            parser->p++;
+            return inner;
+        }
+        case '[':
+            return parse_pattern_bracket(parser);
+        case '.':
+            byte_set_add_range(set, 0, 255);
+            return nfa_frag_set(parser, set);
+        case '\\':
+            if (!*parser->p) break;
+            byte_set_add_escape(set, *parser->p++);
+            return nfa_frag_set(parser, set);
+        case '{': case '}': case '*': case '+': case '?': case ')': case '\0':
+            break;
+        default:
+            byte_set_add(set, (unsigned char)c);
+            return nfa_frag_set(parser, set);
+    }
+    
+    parser->failed = true;
+    return (rift_nfa_frag_t){-1, -1};
+}
+
+static rift_nfa_frag_t parse_pattern_repeat(rift_pattern_parser_t* parser) {
+    rift_nfa_frag_t frag = parse_pattern_atom(parser);
+    
+    while (!parser->failed && (*parser->p == '*' || *parser->p == '+' || *parser->p == '?')) {
+        char op = *parser->p++;
+        rift_nfa_t* nfa = parser->nfa;
+        int start = (op == '+') ? frag.start : nfa_new_node(nfa);
+        int end = nfa_new_node(nfa);
+        if (start < 0 || end < 0) {
+            parser->failed = true;
+            break;
+        }
+        
+        if (op == '*') {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else if (op == '+') {
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = end;
+        }
+        frag = (rift_nfa_frag_t){start, end};
+    }
+    
+    return frag;
+}
+
+static rift_nfa_frag_t parse_pattern_concat(rift_pattern_parser_t* parser) {
+    int start = nfa_new_node(parser->nfa);
+    if (start < 0) {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    rift_nfa_frag_t frag = {start, start};
+    
+    while (!parser->failed && *parser->p && *parser->p != '|' && *parser->p != ')') {
+        // Trailing '$' anchors the whole token and is implied
+        if (parser->p[0] == '$' && parser->p[1] == '\0') {
+            parser->p++;
+            break;
+        }
+        
+        rift_nfa_frag_t next = parse_pattern_repeat(parser);
+        if (parser->failed) break;
+        parser->nfa->nodes[frag.end].eps[0] = next.start;
+        frag.end = next.end;
+    }
+    
+    return frag;
+}
+
+static rift_nfa_frag_t parse_pattern_alternation(rift_pattern_parser_t* parser) {
+    rift_nfa_frag_t frag = parse_pattern_concat(parser);
+    
+    while (!parser->failed && *parser->p == '|') {
+        parser->p++;
+        rift_nfa_frag_t other = parse_pattern_concat(parser);
+        int start = nfa_new_node(parser->nfa);
+        int end = nfa_new_node(parser->nfa);
+        if (parser->failed || start < 0 || end < 0) {
+            parser->failed = true;
+            break;
+        }
+        
+        rift_nfa_node_t* nodes = parser->nfa->nodes;
+        nodes[start].eps[0] = frag.start;
+        nodes[start].eps[1] = other.start;
+        nodes[frag.end].eps[0] = end;
+        nodes[other.end].eps[0] = end;
+        frag = (rift_nfa_frag_t){start, end};
+    }
+    
+    return frag;
+}
+
+// Compiles one pattern into nfa; its final node accepts pattern_index
+static int nfa_add_pattern(rift_nfa_t* nfa, const char* pattern, int pattern_index) {
+    rift_pattern_parser_t parser = {pattern, nfa, false};
+    if (*parser.p == '^') parser.p++;
+    
+    rift_nfa_frag_t frag = parse_pattern_alternation(&parser);
+    if (parser.failed || *parser.p != '\0') return -1;
+    
+    nfa->nodes[frag.end].accept = pattern_index;
+    return frag.start;
+}
+
+static void rift_dfa_destroy(rift_dfa_t* dfa) {
+    if (!dfa) return;
+    rift_free(dfa->allocator, dfa->transitions);
+    rift_free(dfa->allocator, dfa->accept);
+    rift_free(dfa->allocator, dfa);
+}
+
+// Collapses bytes that no edge distinguishes into shared classes
+static size_t nfa_byte_classes(const rift_nfa_t* nfa, uint8_t* byte_class, uint8_t* representative) {
+    size_t class_count = 1;
+    memset(byte_class, 0, 256);
+    
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (nfa->nodes[n].next < 0) continue;
+        
+        int split[256][2];
+        memset(split, -1, sizeof(split));
+        size_t new_count = 0;
+        uint8_t refined[256];
+        
+        for (int b = 0; b < 256; b++) {
+            int in_set = byte_set_has(nfa->nodes[n].set, (unsigned char)b);
+            int* slot = &split[byte_class[b]][in_set];
+            if (*slot < 0) *slot = (int)new_count++;
+            refined[b] = (uint8_t)*slot;
+        }
+        
+        memcpy(byte_class, refined, 256);
+        class_count = new_count;
+    }
+    
+    for (int b = 255; b >= 0; b--) representative[byte_class[b]] = (uint8_t)b;
+    return class_count;
+}
+
+// Merges equivalent states (Moore partition refinement)
+static bool rift_dfa_minimize(rift_dfa_t* dfa) {
+    size_t n = dfa->state_count;
+    size_t k = dfa->class_count;
+    rift_allocator_t* allocator = dfa->allocator;
+    int* block = rift_alloc(allocator, sizeof(int) * n);
+    int* next_block = rift_alloc(allocator, sizeof(int) * n);
+    int* table = rift_alloc(allocator, sizeof(int) * n * 2);
+    if (!block || !next_block || !table) {
+        rift_free(allocator, block);
+        rift_free(allocator, next_block);
+        rift_free(allocator, table);
+        return false;
+    }
+    
+    // Initial partition: states accepting the same pattern
+    size_t block_count = 0;
+    for (size_t s = 0; s < n; s++) {
+        block[s] = -1;
+        for (size_t r = 0; r < s; r++) {
+            if (dfa->accept[r] == dfa->accept[s]) {
+                block[s] = block[r];
+                break;
+            }
+        }
+        if (block[s] < 0) block[s] = (int)block_count++;
+    }
+    
+    for (;;) {
+        size_t table_size = n * 2;
+        size_t new_count = 0;
+        int* representative = rift_alloc(allocator, sizeof(int) * n);
+        if (!representative) break;
+        for (size_t i = 0; i < table_size; i++) table[i] = -1;
+        
+        for (size_t s = 0; s < n; s++) {
+            size_t hash = (size_t)block[s] * 31;
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = dfa->transitions[s * k + c];
+                hash = hash * 1099511628211ULL + (size_t)(t < 0 ? -1 : block[t]);
+            }
+            
+            size_t slot = hash % table_size;
+            while (table[slot] >= 0) {
+                int r = table[slot];
+                bool same = block[r] == block[s];
+                for (size_t c = 0; same && c < k; c++) {
+                    int32_t a = dfa->transitions[(size_t)r * k + c];
+                    int32_t b = dfa->transitions[s * k + c];
+                    same = (a < 0 ? -1 : block[a]) == (b < 0 ? -1 : block[b]);
+                }
+                if (same) break;
+                slot = (slot + 1) % table_size;
+            }
+            
+            if (table[slot] < 0) {
+                table[slot] = (int)s;
+                representative[new_count] = (int)s;
+                next_block[s] = (int)new_count++;
+            } else {
+                next_block[s] = next_block[table[slot]];
+            }
+        }
+        
+        int* swap = block;
+        block = next_block;
+        next_block = swap;
+        
+        if (new_count == block_count) {
+            // Stable: rebuild the table with one state per block
+            int32_t* transitions = rift_alloc(allocator, sizeof(int32_t) * new_count * k);
+            int* accept = rift_alloc(allocator, sizeof(int) * new_count);
+            if (transitions && accept) {
+                for (size_t b = 0; b < new_count; b++) {
+                    size_t r = (size_t)representative[b];
+                    accept[b] = dfa->accept[r];
+                    for (size_t c = 0; c < k; c++) {
+                        int32_t t = dfa->transitions[r * k + c];
+                        transitions[b * k + c] = t < 0 ? -1 : block[t];
+                    }
+                }
+                dfa->start = block[dfa->start];
+                rift_free(allocator, dfa->transitions);
+                rift_free(allocator, dfa->accept);
+                dfa->transitions = transitions;
+                dfa->accept = accept;
+                dfa->state_count = new_count;
+            } else {
+                rift_free(allocator, transitions);
+                rift_free(allocator, accept);
+            }
+            rift_free(allocator, representative);
+            break;
+        }
+        
+        block_count = new_count;
+        rift_free(allocator, representative);
+    }
+    
+    rift_free(allocator, block);
+    rift_free(allocator, next_block);
+    rift_free(allocator, table);
+    return true;
+}
+
+// Subset construction state: DFA states are sets of NFA nodes
+typedef struct {
+    const rift_nfa_t* nfa;
+    const int* priorities;
+    rift_dfa_t* dfa;
+    size_t words;              // uint64_t words per NFA node set
+    uint64_t* sets;            // One set per DFA state
+    size_t capacity;
+    int* stack;
+    int* lookup;               // Open-addressing index of sets
+    size_t lookup_size;
+} rift_dfa_builder_t;
+
+// Adds every node reachable over epsilon edges to set. Returns false if set
+// is empty. stack must hold one int per NFA node.
+static bool nfa_closure(const rift_nfa_t* nfa, uint64_t* set, int* stack) {
+    size_t top = 0;
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (set[n >> 6] >> (n & 63) & 1) stack[top++] = (int)n;
+    }
+    if (top == 0) return false;
+    
+    while (top > 0) {
+        const rift_nfa_node_t* node = &nfa->nodes[stack[--top]];
+        for (int e = 0; e < 2; e++) {
+            int t = node->eps[e];
+            if (t >= 0 && !(set[t >> 6] >> (t & 63) & 1)) {
+                set[t >> 6] |= (uint64_t)1 << (t & 63);
+                stack[top++] = t;
+            }
+        }
+    }
+    return true;
+}
+
+// Nodes reached from the set from by consuming byte c, before closure
+static void nfa_move(const rift_nfa_t* nfa, const uint64_t* from, unsigned char c,
+                     uint64_t* to, size_t words) {
+    memset(to, 0, sizeof(uint64_t) * words);
+    for (size_t n = 0; n < nfa->count; n++) {
+        if ((from[n >> 6] >> (n & 63) & 1) && nfa->nodes[n].next >= 0 &&
+            byte_set_has(nfa->nodes[n].set, c)) {
+            int t = nfa->nodes[n].next;
+            to[t >> 6] |= (uint64_t)1 << (t & 63);
+        }
+    }
+}
+
+// Highest priority accepting pattern in set wins, then the earliest;
+// -1 if set accepts nothing
+static int nfa_set_accept(const rift_nfa_t* nfa, const uint64_t* set, const int* priorities) {
+    int best = -1;
+    for (size_t n = 0; n < nfa->count; n++) {
+        int a = nfa->nodes[n].accept;
+        if (a >= 0 && (set[n >> 6] >> (n & 63) & 1) &&
+            (best < 0 || priorities[a] > priorities[best] ||
+             (priorities[a] == priorities[best] && a < best))) {
+            best = a;
+        }
+    }
+    return best;
+}
+
+// Thompson construction, all patterns joined under one start node. Returns
+// the start node, or -1 if a pattern is outside the supported dialect.
+static int nfa_build(rift_nfa_t* nfa, char** patterns, size_t pattern_count) {
+    int start = nfa_new_node(nfa);
+    int link = start;
+    for (size_t i = 0; i < pattern_count && link >= 0; i++) {
+        int pattern_start = nfa_add_pattern(nfa, patterns[i], (int)i);
+        int next_link = nfa_new_node(nfa);
+        if (pattern_start < 0 || next_link < 0) return -1;
+        nfa->nodes[link].eps[0] = pattern_start;
+        nfa->nodes[link].eps[1] = next_link;
+        link = next_link;
+    }
+    return link >= 0 ? start : -1;
+}
+
+// Returns the DFA state for the epsilon closure of set, creating it if new
+static int32_t dfa_builder_intern(rift_dfa_builder_t* builder, uint64_t* set) {
+    const rift_nfa_t* nfa = builder->nfa;
+    rift_dfa_t* dfa = builder->dfa;
+    size_t words = builder->words;
+    
+    if (!nfa_closure(nfa, set, builder->stack)) return -1;
+    
+    size_t hash = 0;
+    for (size_t w = 0; w < words; w++) hash = hash * 1099511628211ULL + set[w];
+    size_t slot = hash % builder->lookup_size;
+    while (builder->lookup[slot] >= 0) {
+        int32_t existing = builder->lookup[slot];
+        if (memcmp(builder->sets + words * (size_t)existing, set, sizeof(uint64_t) * words) == 0) {
+            return existing;
+        }
+        slot = (slot + 1) % builder->lookup_size;
+    }
+    
+    if (dfa->state_count >= RIFT_DFA_MAX_STATES) return -2;
+    
+    if (dfa->state_count >= builder->capacity) {
+        size_t new_capacity = builder->capacity * 2;
+        rift_allocator_t* allocator = dfa->allocator;
+        uint64_t* new_sets = rift_realloc(allocator, builder->sets, sizeof(uint64_t) * words * new_capacity);
+        int32_t* new_transitions = new_sets ? rift_realloc(allocator, dfa->transitions,
+                                                           sizeof(int32_t) * dfa->class_count * new_capacity) : NULL;
+        int* new_accept = new_transitions ? rift_realloc(allocator, dfa->accept,
+                                                         sizeof(int) * new_capacity) : NULL;
+        if (new_sets) builder->sets = new_sets;
+        if (new_transitions) dfa->transitions = new_transitions;
+        if (!new_accept) return -2;
+        dfa->accept = new_accept;
+        builder->capacity = new_capacity;
+    }
+    
+    int32_t state = (int32_t)dfa->state_count++;
+    memcpy(builder->sets + words * (size_t)state, set, sizeof(uint64_t) * words);
+    builder->lookup[slot] = state;
+    dfa->accept[state] = nfa_set_accept(nfa, set, builder->priorities);
+    return state;
+}
+
+// Builds one minimized DFA recognizing every pattern. When several patterns
+// accept the same lexeme the highest priority wins, then the earliest pattern.
+// Returns NULL if a pattern is outside the supported dialect.
+static rift_dfa_t* rift_dfa_compile(char** patterns, const int* priorities, size_t pattern_count,
+                                    rift_allocator_t* allocator) {
+    rift_nfa_t nfa = {NULL, 0, 0, allocator};
+    rift_dfa_builder_t builder = {0};
+    uint64_t* scratch = NULL;
+    rift_dfa_t* dfa = NULL;
+    
+    int start = nfa_build(&nfa, patterns, pattern_count);
+    if (start < 0) goto fail;
+    
+    dfa = rift_calloc(allocator, 1, sizeof(rift_dfa_t));
+    if (!dfa) goto fail;
+    dfa->allocator = allocator;
+    
+    uint8_t representative[256];
+    dfa->class_count = nfa_byte_classes(&nfa, dfa->byte_class, representative);
+    
+    builder.nfa = &nfa;
+    builder.priorities = priorities;
+    builder.dfa = dfa;
+    builder.words = (nfa.count + 63) / 64;
+    builder.capacity = 16;
+    builder.lookup_size = RIFT_DFA_MAX_STATES * 2;
+    builder.sets = rift_alloc(allocator, sizeof(uint64_t) * builder.words * builder.capacity);
+    builder.stack = rift_alloc(allocator, sizeof(int) * nfa.count);
+    builder.lookup = rift_alloc(allocator, sizeof(int) * builder.lookup_size);
+    scratch = rift_alloc(allocator, sizeof(uint64_t) * builder.words);
+    dfa->transitions = rift_alloc(allocator, sizeof(int32_t) * dfa->class_count * builder.capacity);
+    dfa->accept = rift_alloc(allocator, sizeof(int) * builder.capacity);
+    if (!builder.sets || !builder.stack || !builder.lookup || !scratch ||
+        !dfa->transitions || !dfa->accept) goto fail;
+    for (size_t i = 0; i < builder.lookup_size; i++) builder.lookup[i] = -1;
+    
+    memset(scratch, 0, sizeof(uint64_t) * builder.words);
+    scratch[start >> 6] |= (uint64_t)1 << (start & 63);
+    dfa->start = dfa_builder_intern(&builder, scratch);
+    
+    // Subset construction over byte classes; states are appended as discovered
+    for (size_t s = 0; s < dfa->state_count; s++) {
+        for (size_t c = 0; c < dfa->class_count; c++) {
+            nfa_move(&nfa, builder.sets + builder.words * s, representative[c],
+                     scratch, builder.words);
+            int32_t target = dfa_builder_intern(&builder, scratch);
+            if (target == -2) goto fail;
+            dfa->transitions[s * dfa->class_count + c] = target;
+        }
+    }
+    
+    rift_free(allocator, builder.sets);
+    rift_free(allocator, builder.stack);
+    rift_free(allocator, builder.lookup);
+    rift_free(allocator, scratch);
+    rift_free(allocator, nfa.nodes);
+    
+    if (!rift_dfa_minimize(dfa)) {
+        rift_dfa_destroy(dfa);
+        return NULL;
+    }
+    return dfa;
+
+fail:
+    rift_free(allocator, builder.sets);
+    rift_free(allocator, builder.stack);
+    rift_free(allocator, builder.lookup);
+    rift_free(allocator, scratch);
+    rift_free(allocator, nfa.nodes);
+    rift_dfa_destroy(dfa);
+    return NULL;
+}
+
+// Maximal munch: length of the longest prefix of input accepted by the DFA,
+// and the pattern that accepts it (0 and -1 if nothing matches)
+static size_t rift_dfa_longest_match(const rift_dfa_t* dfa, const char* input, size_t length,
+                                     int* accept) {
+    const int32_t* transitions = dfa->transitions;
+    const uint8_t* byte_class = dfa->byte_class;
+    size_t class_count = dfa->class_count;
+    int32_t state = dfa->start;
+    size_t match_length = 0;
+    
+    *accept = -1;
+    for (size_t i = 0; i < length; i++) {
+        state = transitions[(size_t)state * class_count + byte_class[(unsigned char)input[i]]];
+        if (state < 0) break;
+        if (dfa->accept[state] >= 0) {
+            *accept = dfa->accept[state];
+            match_length = i + 1;
+        }
+    }
+    
+    return match_length;
+}
+
+// ================================
+// RIFT-0: Lazy Token DFA
+// DFA states built on first visit into a fixed-size cache
+// ================================
+
+// The full subset construction can blow up on large alternations of operator
+// and keyword patterns. In lazy mode only the NFA is built up front; each DFA
+// state is created the first time a scan reaches it and kept in a cache sized
+// by dfa_cache_kb from .riftrc.0 [PERFORMANCE_TUNING]. A full cache is flushed
+// and refilled. If it fills again before scanning RIFT_LAZY_MIN_BYTES_PER_STATE
+// bytes per cached state, the cache is thrashing and the rest of the input is
+// scanned by NFA simulation instead.
+
+#define RIFT_LAZY_UNKNOWN (-2)         // Transition not built yet
+#define RIFT_LAZY_MIN_STATES 8
+#define RIFT_LAZY_MIN_BYTES_PER_STATE 10
+
+struct rift_lazy_dfa {
+    rift_nfa_t nfa;
+    int* priorities;
+    int nfa_start;
+    uint8_t byte_class[256];
+    uint8_t representative[256];   // One byte of every class
+    size_t class_count;
+    size_t words;                  // uint64_t words per NFA node set
+    
+    // State cache, allocated once at capacity
+    size_t capacity;
+    size_t state_count;
+    uint64_t* sets;                // NFA node set per state
+    int32_t* transitions;          // [state * class_count + class], -1 = dead
+    int* accept;
+    int32_t* lookup;               // Open-addressing index of sets
+    size_t lookup_size;
+    int32_t start;
+    
+    // Scratch for closures and NFA simulation
+    int* stack;
+    uint64_t* from;
+    uint64_t* to;
+    
+    size_t bytes_since_flush;
+    bool thrashing;                // Scanning by NFA simulation
+    size_t states_built;
+    size_t flushes;
+    size_t nfa_bytes;              // Bytes scanned by NFA simulation
+    rift_allocator_t* allocator;
+};
+
+static void rift_lazy_dfa_destroy(rift_lazy_dfa_t* lazy) {
+    if (!lazy) return;
+    rift_allocator_t* allocator = lazy->allocator;
+    rift_free(allocator, lazy->nfa.nodes);
+    rift_free(allocator, lazy->priorities);
+    rift_free(allocator, lazy->sets);
+    rift_free(allocator, lazy->transitions);
+    rift_free(allocator, lazy->accept);
+    rift_free(allocator, lazy->lookup);
+    rift_free(allocator, lazy->stack);
+    rift_free(allocator, lazy->from);
+    rift_free(allocator, lazy->to);
+    rift_free(allocator, lazy);
+}
+
+// Returns the cached state for the epsilon closure of set, adding it if new.
+// -1 means set is empty, -2 that the cache is full.
+static int32_t lazy_dfa_intern(rift_lazy_dfa_t* lazy, uint64_t* set) {
+    size_t words = lazy->words;
+    if (!nfa_closure(&lazy->nfa, set, lazy->stack)) return -1;
+    
+    size_t hash = 0;
+    for (size_t w = 0; w < words; w++) hash = hash * 1099511628211ULL + set[w];
+    size_t slot = hash % lazy->lookup_size;
+    while (lazy->lookup[slot] >= 0) {
+        int32_t existing = lazy->lookup[slot];
+        if (memcmp(lazy->sets + words * (size_t)existing, set, sizeof(uint64_t) * words) == 0) {
+            return existing;
+        }
+        slot = (slot + 1) % lazy->lookup_size;
+    }
+    
+    if (lazy->state_count >= lazy->capacity) return -2;
+    
+    int32_t state = (int32_t)lazy->state_count++;
+    memcpy(lazy->sets + words * (size_t)state, set, sizeof(uint64_t) * words);
+    for (size_t c = 0; c < lazy->class_count; c++) {
+        lazy->transitions[(size_t)state * lazy->class_count + c] = RIFT_LAZY_UNKNOWN;
+    }
+    lazy->accept[state] = nfa_set_accept(&lazy->nfa, set, lazy->priorities);
+    lazy->lookup[slot] = state;
+    lazy->states_built++;
+    return state;
+}
+
+// Empties the cache and re-adds the start state
+static void lazy_dfa_flush(rift_lazy_dfa_t* lazy) {
+    lazy->state_count = 0;
+    for (size_t i = 0; i < lazy->lookup_size; i++) lazy->lookup[i] = -1;
+    
+    memset(lazy->from, 0, sizeof(uint64_t) * lazy->words);
+    lazy->from[lazy->nfa_start >> 6] |= (uint64_t)1 << (lazy->nfa_start & 63);
+    lazy->start = lazy_dfa_intern(lazy, lazy->from);
+}
+
+// Builds every pattern into one NFA and sizes the state cache to fit
+// cache_bytes. Returns NULL if a pattern is outside the supported dialect.
+static rift_lazy_dfa_t* rift_lazy_dfa_create(char** patterns, const int* priorities,
+                                             size_t pattern_count, size_t cache_bytes,
+                                             rift_allocator_t* allocator) {
+    rift_lazy_dfa_t* lazy = rift_calloc(allocator, 1, sizeof(rift_lazy_dfa_t));
+    if (!lazy) return NULL;
+    lazy->allocator = allocator;
+    lazy->nfa.allocator = allocator;
+    
+    lazy->nfa_start = nfa_build(&lazy->nfa, patterns, pattern_count);
+    lazy->priorities = rift_alloc(allocator, sizeof(int) * (pattern_count ? pattern_count : 1));
+    if (lazy->nfa_start < 0 || !lazy->priorities) {
+        rift_lazy_dfa_destroy(lazy);
+        return NULL;
+    }
+    memcpy(lazy->priorities, priorities, sizeof(int) * pattern_count);
+    
+    lazy->class_count = nfa_byte_classes(&lazy->nfa, lazy->byte_class, lazy->representative);
+    lazy->words = (lazy->nfa.count + 63) / 64;
+    
+    size_t state_bytes = sizeof(uint64_t) * lazy->words + sizeof(int32_t) * lazy->class_count +
+                         sizeof(int) + sizeof(int32_t) * 2;
+    lazy->capacity = cache_bytes / state_bytes;
+    if (lazy->capacity < RIFT_LAZY_MIN_STATES) {
+        fprintf(stderr, "RIFT-0: dfa_cache_kb holds %zu states of %zu bytes; using the minimum of %d\n",
+                lazy->capacity, state_bytes, RIFT_LAZY_MIN_STATES);
+        lazy->capacity = RIFT_LAZY_MIN_STATES;
+    }
+    lazy->lookup_size = lazy->capacity * 2;
+    
+    lazy->sets = rift_alloc(allocator, sizeof(uint64_t) * lazy->words * lazy->capacity);
+    lazy->transitions = rift_alloc(allocator, sizeof(int32_t) * lazy->class_count * lazy->capacity);
+    lazy->accept = rift_alloc(allocator, sizeof(int) * lazy->capacity);
+    lazy->lookup = rift_alloc(allocator, sizeof(int32_t) * lazy->lookup_size);
+    lazy->stack = rift_alloc(allocator, sizeof(int) * lazy->nfa.count);
+    lazy->from = rift_alloc(allocator, sizeof(uint64_t) * lazy->words);
+    lazy->to = rift_alloc(allocator, sizeof(uint64_t) * lazy->words);
+    if (!lazy->sets || !lazy->transitions || !lazy->accept || !lazy->lookup ||
+        !lazy->stack || !lazy->from || !lazy->to) {
+        rift_lazy_dfa_destroy(lazy);
+        return NULL;
+    }
+    
+    lazy_dfa_flush(lazy);
+    return lazy;
+}
+
+// Builds the transition of state on byte class c. May flush the cache, so
+// the returned state is the only one still valid.
+static int32_t lazy_dfa_step(rift_lazy_dfa_t* lazy, int32_t state, size_t c) {
+    size_t words = lazy->words;
+    memcpy(lazy->from, lazy->sets + words * (size_t)state, sizeof(uint64_t) * words);
+    nfa_move(&lazy->nfa, lazy->from, lazy->representative[c], lazy->to, words);
+    
+    int32_t target = lazy_dfa_intern(lazy, lazy->to);
+    if (target == -2) {
+        if (lazy->bytes_since_flush < lazy->capacity * RIFT_LAZY_MIN_BYTES_PER_STATE) {
+            lazy->thrashing = true;
+        }
+        lazy->flushes++;
+        lazy->bytes_since_flush = 0;
+        lazy_dfa_flush(lazy);
+        
+        // The closure was already taken, so the set is re-added unchanged
+        return lazy_dfa_intern(lazy, lazy->to);
+    }
+    
+    lazy->transitions[(size_t)state * lazy->class_count + c] = target;
+    return target;
+}
+
+// Maximal munch by stepping the NFA node set directly
+static size_t lazy_dfa_nfa_longest_match(rift_lazy_dfa_t* lazy, const char* input, size_t length,
+                                         int* accept) {
+    const rift_nfa_t* nfa = &lazy->nfa;
+    size_t words = lazy->words;
+    uint64_t* current = lazy->from;
+    uint64_t* next = lazy->to;
+    size_t match_length = 0;
+    
+    memset(current, 0, sizeof(uint64_t) * words);
+    current[lazy->nfa_start >> 6] |= (uint64_t)1 << (lazy->nfa_start & 63);
+    nfa_closure(nfa, current, lazy->stack);
+    
+    *accept = -1;
+    for (size_t i = 0; i < length; i++) {
+        nfa_move(nfa, current, (unsigned char)input[i], next, words);
+        if (!nfa_closure(nfa, next, lazy->stack)) break;
+        
+        int a = nfa_set_accept(nfa, next, lazy->priorities);
+        if (a >= 0) {
+            *accept = a;
+            match_length = i + 1;
+        }
+        uint64_t* swap = current;
+        current = next;
+        next = swap;
+    }
+    
+    lazy->nfa_bytes += match_length ? match_length : 1;
+    return match_length;
+}
+
+// Maximal munch over the cached states, building missing transitions
+static size_t rift_lazy_dfa_longest_match(rift_lazy_dfa_t* lazy, const char* input, size_t length,
+                                          int* accept) {
+    if (lazy->thrashing) return lazy_dfa_nfa_longest_match(lazy, input, length, accept);
+    
+    const uint8_t* byte_class = lazy->byte_class;
+    size_t class_count = lazy->class_count;
+    int32_t state = lazy->start;
+    size_t match_length = 0;
+    size_t i = 0;
+    
+    *accept = -1;
+    for (; i < length; i++) {
+        size_t c = byte_class[(unsigned char)input[i]];
+        int32_t next = lazy->transitions[(size_t)state * class_count + c];
+        if (next == RIFT_LAZY_UNKNOWN) {
+            next = lazy_dfa_step(lazy, state, c);
+            if (lazy->thrashing) {
+                // Rescan this token from its start without the cache
+                lazy->bytes_since_flush += i;
+                return lazy_dfa_nfa_longest_match(lazy, input, length, accept);
+            }
+        }
+        state = next;
+        if (state < 0) break;
+        if (lazy->accept[state] >= 0) {
+            *accept = lazy->accept[state];
+            match_length = i + 1;
+        }
+    }
+    
+    lazy->bytes_since_flush += i;
+    return match_length;
+}
+
+// ================================
+// RIFT-0: Tokenizer Implementation
+// ================================
+
+// Inputs below this size are always tokenized on the calling thread
+#define RIFT_PARALLEL_MIN_BYTES ((size_t)64 << 20)
+#define RIFT_PARALLEL_MAX_WORKERS 64
+
+// Marks the bytes a chunk boundary may be placed before. A byte is safe when
+// every in-progress token dies on it, except pure whitespace runs (which are
+// dropped, so splitting one changes nothing).
+static void rift_tokenizer_compute_split_bytes(rift_tokenizer_t* tokenizer) {
+    const rift_dfa_t* dfa = tokenizer->dfa;
+    size_t n = dfa->state_count;
+    size_t k = dfa->class_count;
+    bool* pure_whitespace = rift_alloc(tokenizer->allocator, sizeof(bool) * n);
+    
+    memset(tokenizer->split_safe, 0, sizeof(tokenizer->split_safe));
+    if (!pure_whitespace) return;
+    
+    // States that accept whitespace and can only continue as whitespace
+    for (size_t s = 0; s < n; s++) {
+        pure_whitespace[s] = dfa->accept[s] >= 0 &&
+                             tokenizer->states[dfa->accept[s]]->type == TOKEN_WHITESPACE;
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t s = 0; s < n; s++) {
+            if (!pure_whitespace[s]) continue;
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = dfa->transitions[s * k + c];
+                if (t >= 0 && !pure_whitespace[t]) {
+                    pure_whitespace[s] = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    for (int b = 0; b < 256; b++) {
+        size_t c = dfa->byte_class[b];
+        bool safe = true;
+        for (size_t s = 0; s < n && safe; s++) {
+            if ((int)s == dfa->start) continue;
+            int32_t t = dfa->transitions[s * k + c];
+            safe = t < 0 || (pure_whitespace[s] && pure_whitespace[t]);
+        }
+        tokenizer->split_safe[b] = safe;
+    }
+    
+    rift_free(tokenizer->allocator, pure_whitespace);
+}
+
+static token_type_t token_type_from_name(const char* name, size_t length) {
+    static const struct { const char* name; token_type_t type; } names[] = {
+        {"IDENTIFIER", TOKEN_IDENTIFIER},
+        {"NUMBER", TOKEN_NUMBER},
+        {"OPERATOR", TOKEN_OPERATOR},
+        {"WHITESPACE", TOKEN_WHITESPACE}
+    };
+    
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strlen(names[i].name) == length && strncmp(names[i].name, name, length) == 0) {
+            return names[i].type;
+        }
+    }
+    return TOKEN_UNKNOWN;
+}
+
+static rift_tokenizer_t* rift_tokenizer_create(rift_governance_t* gov) {
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_RIFT0);
+    rift_tokenizer_t* tokenizer = rift_alloc(allocator, sizeof(rift_tokenizer_t));
+    if (!tokenizer) return NULL;
+    
+    tokenizer->allocator = allocator;
+    tokenizer->governance = gov;
+    tokenizer->trace_tokens = true;
+    
+    const char* cache_size = rift_get_config_value(gov, "regex_cache_size");
+    size_t cache_capacity = cache_size ? strtoul(cache_size, NULL, 10) : 0;
+    tokenizer->regex_cache = rift_regex_cache_create(cache_capacity ? cache_capacity : 256, allocator);
+    if (!tokenizer->regex_cache) {
+        rift_free(allocator, tokenizer);
+        return NULL;
+    }
+    
+    tokenizer->dfa = NULL;
+    tokenizer->lazy_dfa = NULL;
+    tokenizer->state_count = 0;
+    tokenizer->states = rift_alloc(allocator, sizeof(rift_state_t*) * (gov->count ? gov->count : 1));
+    if (!tokenizer->states) {
+        rift_regex_cache_destroy(tokenizer->regex_cache);
+        rift_free(allocator, tokenizer);
+        return NULL;
+    }
+    
+    // Every stage 0 NAME_PATTERN entry defines a token class ranked by
+    // NAME_PRIORITY, as in .riftrc.0 [TOKEN_PATTERNS]
+    for (size_t i = 0; i < gov->count; i++) {
+        const rift_config_entry_t* entry = gov->entries[i];
+        size_t name_length = token_pattern_name_length(entry->intention);
+        if (!name_length || strncmp(entry->sp_alignment, "STAGE_0", 7) != 0) continue;
+        
+        char priority_key[128];
+        snprintf(priority_key, sizeof(priority_key), "%.*s_PRIORITY",
+                 (int)name_length, entry->intention);
+        const char* priority = rift_get_config_value(gov, priority_key);
+        
+        rift_state_t* state = rift_alloc(allocator, sizeof(rift_state_t));
+        char* pattern = state ? rift_strdup(allocator, entry->pattern) : NULL;
+        if (!pattern) {
+            rift_free(allocator, state);
+            rift_tokenizer_destroy(tokenizer);
+            return NULL;
+        }
+        state->pattern = pattern;
+        state->type = token_type_from_name(entry->intention, name_length);
+        state->priority = priority ? atoi(priority) : 0;
+        state->is_final = true;
+        
+        // Keep states in priority order so the regex path can stop at the
+        // first match; equal priorities keep their governance order
+        size_t slot = tokenizer->state_count++;
+        while (slot > 0 && tokenizer->states[slot - 1]->priority < state->priority) {
+            tokenizer->states[slot] = tokenizer->states[slot - 1];
+            slot--;
+        }
+        tokenizer->states[slot] = state;
+    }
+    
+    // Compile all patterns into one automaton
+    size_t pattern_count = tokenizer->state_count;
+    char** patterns = rift_alloc(allocator, sizeof(char*) * (pattern_count ? pattern_count : 1));
+    int* priorities = rift_alloc(allocator, sizeof(int) * (pattern_count ? pattern_count : 1));
+    if (!patterns || !priorities) {
+        rift_free(allocator, patterns);
+        rift_free(allocator, priorities);
+        rift_tokenizer_destroy(tokenizer);
+        return NULL;
+    }
+    for (size_t i = 0; i < pattern_count; i++) {
+        tokenizer->states[i]->id = i;
+        patterns[i] = tokenizer->states[i]->pattern;
+        priorities[i] = tokenizer->states[i]->priority;
+    }
+    
+    const char* dfa_mode = rift_get_config_value(gov, "dfa_mode");
+    bool lazy = dfa_mode && strcmp(dfa_mode, "lazy") == 0;
+    const char* cache_kb = rift_get_config_value(gov, "dfa_cache_kb");
+    size_t cache_bytes = (cache_kb ? strtoul(cache_kb, NULL, 10) : 1024) * 1024;
+    
+    uint64_t compile_start = rift_timer_start();
+    tokenizer->dfa = lazy ? NULL : rift_dfa_compile(patterns, priorities, pattern_count, allocator);
+    
+    // Build states on demand when asked to, or when the full DFA hit its limit
+    tokenizer->lazy_dfa = tokenizer->dfa ? NULL :
+        rift_lazy_dfa_create(patterns, priorities, pattern_count, cache_bytes, allocator);
+    rift_timer_stop(RIFT_TIMER_PATTERN_COMPILE, compile_start);
+    rift_free(allocator, patterns);
+    rift_free(allocator, priorities);
+    
+    const char* parallel = rift_get_config_value(gov, "parallel_tokenization");
+    tokenizer->parallel = parallel && strcmp(parallel, "true") == 0;
+    if (tokenizer->dfa) rift_tokenizer_compute_split_bytes(tokenizer);
+    
+    // Without an automaton, compile every pattern once up front for the regex path
+    for (size_t i = 0; i < tokenizer->state_count; i++) {
+        rift_state_t* state = tokenizer->states[i];
+        state->pattern_hash = rift_hash_string(state->pattern);
+        state->cache_slot = 0;
+        if (!tokenizer->dfa && !tokenizer->lazy_dfa) {
+            rift_regex_cache_get(tokenizer->regex_cache, state->pattern,
+                                 state->pattern_hash, &state->cache_slot);
+        }
+    }
+    
+    return tokenizer;
+}
+
+static void rift_tokenizer_destroy(rift_tokenizer_t* tokenizer) {
+    if (!tokenizer) return;
+    
+    rift_allocator_t* allocator = tokenizer->allocator;
+    for (size_t i = 0; i < tokenizer->state_count; i++) {
+        rift_free(allocator, tokenizer->states[i]->pattern);
+        rift_free(allocator, tokenizer->states[i]);
+    }
+    rift_free(allocator, tokenizer->states);
+    rift_regex_cache_destroy(tokenizer->regex_cache);
+    rift_dfa_destroy(tokenizer->dfa);
+    rift_lazy_dfa_destroy(tokenizer->lazy_dfa);
+    rift_free(allocator, tokenizer);
+}
+
+static bool matches_pattern(rift_regex_cache_t* cache, rift_state_t* state, const char* text) {
+    const regex_t* regex = rift_regex_cache_get(cache, state->pattern,
+                                                state->pattern_hash, &state->cache_slot);
+    if (!regex) return false;
+    
+    return regexec(regex, text, 0, NULL, 0) == 0;
+}
+
+static const char* token_type_name(token_type_t type) {
+    switch (type) {
+        case TOKEN_IDENTIFIER: return "IDENTIFIER";
+        case TOKEN_NUMBER: return "NUMBER";
+        case TOKEN_OPERATOR: return "OPERATOR";
+        case TOKEN_WHITESPACE: return "WHITESPACE";
+        default: return "UNKNOWN";
+    }
+}
+
+static bool token_stream_init(token_stream_t* stream, rift_allocator_t* allocator,
+                              const char* source, size_t length, size_t capacity) {
+    stream->allocator = allocator;
+    stream->count = 0;
+    stream->capacity = capacity ? capacity : 1;
+    stream->types = rift_alloc(allocator, sizeof(uint8_t) * stream->capacity);
+    stream->offsets = rift_alloc(allocator, sizeof(uint32_t) * stream->capacity);
+    stream->lengths = rift_alloc(allocator, sizeof(uint32_t) * stream->capacity);
+    stream->line_starts = NULL;
+    stream->line_count = 0;
+    stream->line_capacity = 0;
+    stream->source = source;
+    stream->source_length = length;
+    return stream->types && stream->offsets && stream->lengths;
+}
+
+static void token_stream_release(token_stream_t* stream) {
+    rift_free(stream->allocator, stream->types);
+    rift_free(stream->allocator, stream->offsets);
+    rift_free(stream->allocator, stream->lengths);
+    rift_free(stream->allocator, stream->line_starts);
+}
+
+static bool token_stream_reserve(token_stream_t* stream, size_t capacity) {
+    if (capacity <= stream->capacity) return true;
+    
+    uint8_t* types = rift_realloc(stream->allocator, stream->types, sizeof(uint8_t) * capacity);
+    if (types) stream->types = types;
+    uint32_t* offsets = rift_realloc(stream->allocator, stream->offsets, sizeof(uint32_t) * capacity);
+    if (offsets) stream->offsets = offsets;
+    uint32_t* lengths = rift_realloc(stream->allocator, stream->lengths, sizeof(uint32_t) * capacity);
+    if (lengths) stream->lengths = lengths;
+    if (!types || !offsets || !lengths) return false;
+    
+    stream->capacity = capacity;
+    return true;
+}
+
+static void token_stream_push(token_stream_t* stream, token_type_t type,
+                              size_t offset, size_t length) {
+    // Resize if needed
+    if (stream->count >= stream->capacity &&
+        !token_stream_reserve(stream, stream->capacity * 2)) {
+        fprintf(stderr, "Failed to grow token stream\n");
+        exit(1);
+    }
+    stream->types[stream->count] = (uint8_t)type;
+    stream->offsets[stream->count] = (uint32_t)offset;
+    stream->lengths[stream->count] = (uint32_t)length;
+    stream->count++;
+}
+
+// Records where every line of the source begins, for line/column lookups
+static bool token_stream_index_lines(token_stream_t* stream) {
+    const char* source = stream->source;
+    size_t length = stream->source_length;
+    size_t lines = 1;
+    
+    for (const char* nl = memchr(source, '\n', length); nl;
+         nl = memchr(nl + 1, '\n', length - (size_t)(nl + 1 - source))) {
+        lines++;
+    }
+    
+    if (lines > stream->line_capacity) {
+        uint32_t* line_starts = rift_realloc(stream->allocator, stream->line_starts,
+                                             sizeof(uint32_t) * lines);
+        if (!line_starts) return false;
+        stream->line_starts = line_starts;
+        stream->line_capacity = lines;
+    }
+    
+    stream->line_starts[0] = 0;
+    stream->line_count = 1;
+    for (const char* nl = memchr(source, '\n', length); nl;
+         nl = memchr(nl + 1, '\n', length - (size_t)(nl + 1 - source))) {
+        stream->line_starts[stream->line_count++] = (uint32_t)(nl + 1 - source);
+    }
+    return true;
+}
+
+static inline size_t token_stream_count(const token_stream_t* stream) {
+    return stream->count;
+}
+
+static inline token_type_t token_stream_type(const token_stream_t* stream, size_t index) {
+    return (token_type_t)stream->types[index];
+}
+
+static inline const char* token_stream_text(const token_stream_t* stream, size_t index) {
+    return stream->source + stream->offsets[index];
+}
+
+static inline size_t token_stream_length(const token_stream_t* stream, size_t index) {
+    return stream->lengths[index];
+}
+
+// 1-based line of a token, by binary search over the line table
+static size_t token_stream_line(const token_stream_t* stream, size_t index) {
+    uint32_t offset = stream->offsets[index];
+    size_t low = 0;
+    size_t high = stream->line_count;
+    
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (stream->line_starts[mid] <= offset) low = mid;
+        else high = mid;
+    }
+    return low + 1;
+}
+
+static size_t token_stream_column(const token_stream_t* stream, size_t index) {
+    size_t line = token_stream_line(stream, index);
+    return stream->offsets[index] - stream->line_starts[line - 1] + 1;
+}
+
+// Scans source[begin, end) with maximal munch, appending non-whitespace tokens
+// to stream
+static void rift_scan_dfa_range(rift_tokenizer_t* tokenizer, token_stream_t* stream,
+                                size_t begin, size_t end, bool trace) {
+    const char* input = stream->source;
+    size_t pos = begin;
+    
+    while (pos < end) {
+        int accept;
+        size_t match = tokenizer->dfa ?
+            rift_dfa_longest_match(tokenizer->dfa, input + pos, end - pos, &accept) :
+            rift_lazy_dfa_longest_match(tokenizer->lazy_dfa, input + pos, end - pos, &accept);
+        token_type_t type = TOKEN_UNKNOWN;
+        
+        if (match == 0) {
+            match = 1;  // Unrecognized byte becomes a one-byte UNKNOWN token
+        } else {
+            type = tokenizer->states[accept]->type;
+        }
+        
+        if (type != TOKEN_WHITESPACE) {
+            token_stream_push(stream, type, pos, match);
+            
+            if (trace) {
+                rift_log("  → Token: '%.*s' classified as %s\n",
+                         (int)match, input + pos, token_type_name(type));
+            }
+        }
+        pos += match;
+    }
+}
+
+// Single pass over the input with maximal munch; whitespace is dropped
+static void rift_tokenize_dfa(rift_tokenizer_t* tokenizer, token_stream_t* stream) {
+    rift_scan_dfa_range(tokenizer, stream, 0, stream->source_length, tokenizer->trace_tokens);
+}
+
+typedef struct {
+    rift_tokenizer_t* tokenizer;
+    token_stream_t chunk;      // Tokens of this chunk, offsets already global
+    size_t begin;
+    size_t end;
+    token_stream_t* output;
+    size_t output_index;       // First slot of the chunk in output
+} rift_tokenize_chunk_t;
+
+static void* rift_tokenize_chunk_worker(void* arg) {
+    rift_tokenize_chunk_t* work = arg;
+    rift_scan_dfa_range(work->tokenizer, &work->chunk, work->begin, work->end, false);
+    return NULL;
+}
+
+// Copies a chunk's columns into its slot of the output
+static void* rift_stitch_chunk_worker(void* arg) {
+    rift_tokenize_chunk_t* work = arg;
+    token_stream_t* out = work->output;
+    size_t n = work->chunk.count;
+    
+    memcpy(out->types + work->output_index, work->chunk.types, sizeof(uint8_t) * n);
+    memcpy(out->offsets + work->output_index, work->chunk.offsets, sizeof(uint32_t) * n);
+    memcpy(out->lengths + work->output_index, work->chunk.lengths, sizeof(uint32_t) * n);
+    return NULL;
+}
+
+// Splits the input at safe boundaries, scans the chunks on a worker pool and
+// stitches the per-chunk streams back together. Returns false if the input
+// cannot be split or the chunk streams cannot be allocated, leaving stream
+// untouched.
+static bool rift_tokenize_parallel(rift_tokenizer_t* tokenizer, token_stream_t* stream) {
+    const char* input = stream->source;
+    size_t length = stream->source_length;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t workers = cpus > 1 ? (size_t)cpus : 1;
+    if (workers > RIFT_PARALLEL_MAX_WORKERS) workers = RIFT_PARALLEL_MAX_WORKERS;
+    if (workers < 2) return false;
+    
+    rift_tokenize_chunk_t chunks[RIFT_PARALLEL_MAX_WORKERS];
+    pthread_t threads[RIFT_PARALLEL_MAX_WORKERS];
+    bool started[RIFT_PARALLEL_MAX_WORKERS];
+    size_t chunk_count = 0;
+    size_t begin = 0;
+    
+    for (size_t i = 1; i <= workers && begin < length; i++) {
+        size_t end = (i == workers) ? length : length / workers * i;
+        if (end < begin) end = begin;
+        while (end < length && !tokenizer->split_safe[(unsigned char)input[end]]) end++;
+        if (end == begin) continue;
+        
+        rift_tokenize_chunk_t* work = &chunks[chunk_count];
+        work->tokenizer = tokenizer;
+        work->begin = begin;
+        work->end = end;
+        if (!token_stream_init(&work->chunk, tokenizer->allocator, input, length,
+                               (end - begin) / 4 + 16)) {
+            token_stream_release(&work->chunk);
+            for (size_t j = 0; j < chunk_count; j++) token_stream_release(&chunks[j].chunk);
+            return false;
+        }
+        chunk_count++;
+        begin = end;
+    }
+    
+    if (chunk_count < 2) {
+        for (size_t i = 0; i < chunk_count; i++) token_stream_release(&chunks[i].chunk);
+        return false;
+    }
+    
+    // A chunk whose thread cannot be started is scanned here instead
+    for (size_t i = 0; i < chunk_count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, rift_tokenize_chunk_worker, &chunks[i]) == 0;
+    }
+    for (size_t i = 0; i < chunk_count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else rift_tokenize_chunk_worker(&chunks[i]);
+    }
+    
+    // Prefix sum gives every chunk its slot in the output
+    size_t total = 0;
+    for (size_t i = 0; i < chunk_count; i++) {
+        chunks[i].output = stream;
+        chunks[i].output_index = total;
+        total += chunks[i].chunk.count;
+    }
+    
+    if (!token_stream_reserve(stream, total)) {
+        for (size_t i = 0; i < chunk_count; i++) token_stream_release(&chunks[i].chunk);
+        return false;
+    }
+    stream->count = total;
+    
+    for (size_t i = 0; i < chunk_count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, rift_stitch_chunk_worker, &chunks[i]) == 0;
+    }
+    for (size_t i = 0; i < chunk_count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else rift_stitch_chunk_worker(&chunks[i]);
+        token_stream_release(&chunks[i].chunk);
+    }
+    
+    rift_log("  → Parallel tokenization: %zu chunks\n", chunk_count);
+    return true;
+}
+
+// Fallback for patterns outside the DFA dialect: split on spaces and
+// classify each piece against the cached regexes. Returns false if out of memory.
+static bool rift_tokenize_regex(rift_tokenizer_t* tokenizer, token_stream_t* stream) {
+    const char* input = stream->source;
+    size_t length = stream->source_length;
+    char* scratch = NULL;      // NUL-terminated copy of one piece for regexec
+    size_t scratch_capacity = 0;
+    size_t pos = 0;
+    
+    while (pos < length) {
+        if (input[pos] == ' ') {
+            pos++;
+            continue;
+        }
+        
+        size_t end = pos;
+        while (end < length && input[end] != ' ') end++;
+        
+        size_t piece_length = end - pos;
+        if (piece_length + 1 > scratch_capacity) {
+            size_t new_capacity = (piece_length + 1) * 2;
+            char* new_scratch = rift_realloc(tokenizer->allocator, scratch, new_capacity);
+            if (!new_scratch) {
+                rift_free(tokenizer->allocator, scratch);
+                return false;
+            }
+            scratch = new_scratch;
+            scratch_capacity = new_capacity;
+        }
+        memcpy(scratch, input + pos, piece_length);
+        scratch[piece_length] = '\0';
+        
+        token_type_t type = TOKEN_UNKNOWN;
+        
+        // Classify token using DFA states
+        for (size_t i = 0; i < tokenizer->state_count; i++) {
+            if (matches_pattern(tokenizer->regex_cache, tokenizer->states[i], scratch)) {
+                type = tokenizer->states[i]->type;
+                break;
+            }
+        }
+        token_stream_push(stream, type, pos, piece_length);
+        
+        if (tokenizer->trace_tokens) {
+            rift_log("  → Token: '%s' classified as %s\n", scratch, token_type_name(type));
+        }
+        pos = end;
+    }
+    
+    rift_free(tokenizer->allocator, scratch);
+    return true;
+}
+
+// Tokenizes input into an existing stream, reusing its storage; the
+// previous contents are discarded
+static bool rift_tokenize_into(rift_tokenizer_t* tokenizer, token_stream_t* stream,
+                               const char* input, size_t length) {
+    uint64_t stage_start = rift_timer_start();
+    rift_print_stage_info("RIFT-0", "DFA-based tokenization starting");
+    
+    if (length > RIFT_TOKEN_STREAM_MAX_SOURCE) {
+        fprintf(stderr, "Input of %zu bytes exceeds the 4 GiB token stream limit\n", length);
+        return false;
+    }
+    
+    stream->count = 0;
+    stream->line_count = 0;
+    stream->source = input;
+    stream->source_length = length;
+    
+    uint64_t scan_start = rift_timer_start();
+    if (tokenizer->dfa) {
+        rift_log("  → Token automaton: %zu states, %zu byte classes\n",
+                 tokenizer->dfa->state_count, tokenizer->dfa->class_count);
+        
+        bool parallel_done = tokenizer->parallel && !tokenizer->trace_tokens &&
+                             length >= RIFT_PARALLEL_MIN_BYTES &&
+                             rift_tokenize_parallel(tokenizer, stream);
+        if (!parallel_done) rift_tokenize_dfa(tokenizer, stream);
+    } else if (tokenizer->lazy_dfa) {
+        rift_lazy_dfa_t* lazy = tokenizer->lazy_dfa;
+        rift_log("  → Lazy token automaton: %zu of %zu cached states, %zu byte classes\n",
+                 lazy->state_count, lazy->capacity, lazy->class_count);
+        
+        // Every input gets a fresh chance at the cache
+        lazy->thrashing = false;
+        lazy->bytes_since_flush = 0;
+        rift_tokenize_dfa(tokenizer, stream);
+    } else {
+        rift_log("  → Token automaton unavailable, classifying with regex cache\n");
+        if (!rift_tokenize_regex(tokenizer, stream)) {
+            fprintf(stderr, "RIFT-0: out of memory while tokenizing\n");
+            return false;
+        }
+    }
+    rift_timer_stop(RIFT_TIMER_SCAN, scan_start);
+    
+    uint64_t index_start = rift_timer_start();
+    if (!token_stream_index_lines(stream)) return false;
+    rift_timer_stop(RIFT_TIMER_LINE_INDEX, index_start);
+    
+    rift_log("  → Tokenization complete: %zu tokens generated\n", stream->count);
+    if (tokenizer->lazy_dfa) {
+        rift_lazy_dfa_t* lazy = tokenizer->lazy_dfa;
+        rift_log("  → Lazy DFA cache: %zu states built, %zu flushes, %zu bytes by NFA simulation%s\n",
+                 lazy->states_built, lazy->flushes, lazy->nfa_bytes,
+                 lazy->thrashing ? " (cache thrashing)" : "");
+    } else if (!tokenizer->dfa) {
+        rift_log("  → Regex cache: %zu hits, %zu misses, %zu evictions (capacity %zu)\n",
+                 tokenizer->regex_cache->hits, tokenizer->regex_cache->misses,
+                 tokenizer->regex_cache->evictions, tokenizer->regex_cache->capacity);
+    }
+    rift_allocator_count_items(tokenizer->allocator, stream->count);
+    rift_timer_stop(RIFT_TIMER_RIFT0, stage_start);
+    return true;
+}
+
+static token_stream_t* rift_tokenize(rift_tokenizer_t* tokenizer, const char* input, size_t length) {
+    token_stream_t* stream = rift_alloc(tokenizer->allocator, sizeof(token_stream_t));
+    if (!stream) return NULL;
+    if (!token_stream_init(stream, tokenizer->allocator, input, length, 10) ||
+        !rift_tokenize_into(tokenizer, stream, input, length)) {
+        token_stream_destroy(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+static void token_stream_destroy(token_stream_t* stream) {
+    if (!stream) return;
+    
+    token_stream_release(stream);
+    rift_free(stream->allocator, stream);
+}
+
+// ================================
+// Arena Allocator Implementation
+// ================================
+
+#define RIFT_ARENA_DEFAULT_BLOCK_SIZE 4096
+
+static rift_arena_t* rift_arena_create(size_t initial_block_size, rift_allocator_t* allocator) {
+    rift_arena_t* arena = rift_alloc(allocator, sizeof(rift_arena_t));
+    if (!arena) return NULL;
+    
+    arena->allocator = allocator;
+    arena->head = NULL;
+    arena->next_block_size = initial_block_size ? initial_block_size : RIFT_ARENA_DEFAULT_BLOCK_SIZE;
+    arena->bytes_used = 0;
+    return arena;
+}
+
+static void rift_arena_destroy(rift_arena_t* arena) {
+    if (!arena) return;
+    
+    rift_arena_block_t* block = arena->head;
+    while (block) {
+        rift_arena_block_t* next = block->next;
+        rift_free(arena->allocator, block);
+        block = next;
+    }
+    rift_free(arena->allocator, arena);
+}
+
+// Releases everything allocated so far but keeps the newest (largest) block,
+// so an arena reused for similar inputs stops calling malloc
+static void rift_arena_reset(rift_arena_t* arena) {
+    rift_arena_block_t* keep = arena->head;
+    if (keep) {
+        rift_arena_block_t* block = keep->next;
+        while (block) {
+            rift_arena_block_t* next = block->next;
+            rift_free(arena->allocator, block);
+            block = next;
+        }
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    arena->bytes_used = 0;
+}
+
+// Returns size bytes aligned for any type, or NULL if out of memory
+static void* rift_arena_alloc(rift_arena_t* arena, size_t size) {
+    size_t align = sizeof(max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+    
+    rift_arena_block_t* block = arena->head;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = arena->next_block_size;
+        while (capacity < size) capacity *= 2;
+        
+        block = rift_alloc(arena->allocator, sizeof(rift_arena_block_t) + capacity);
+        if (!block) return NULL;
+        block->next = arena->head;
+        block->used = 0;
+        block->capacity = capacity;
+        arena->head = block;
+        arena->next_block_size = capacity * 2;
+    }
+    
+    void* ptr = (char*)block->data + block->used;
+    block->used += size;
+    arena->bytes_used += size;
+    return ptr;
+}
+
+static char* rift_arena_strndup(rift_arena_t* arena, const char* str, size_t length) {
+    char* copy = rift_arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+    
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// ================================
+// RIFT-1: Parser Implementation
+// ================================
+
+// Fills the operator table from every NAME_PRECEDENCE entry that has a
+// matching single-character NAME_SYMBOL. operator_association applies to all.
+static void rift_operator_table_load(rift_operator_table_t* table, rift_governance_t* gov) {
+    static const char suffix[] = "_PRECEDENCE";
+    size_t suffix_length = sizeof(suffix) - 1;
+    const char* association = rift_get_config_value(gov, "operator_association");
+    bool right = association && strcmp(association, "right") == 0;
+    
+    memset(table, 0, sizeof(*table));
+    
+    for (size_t i = 0; i < gov->count; i++) {
+        const char* key = gov->entries[i]->intention;
+        size_t key_length = strlen(key);
+        if (key_length <= suffix_length ||
+            strcmp(key + key_length - suffix_length, suffix) != 0) continue;
+        
+        char symbol_key[128];
+        int name_length = (int)(key_length - suffix_length);
+        snprintf(symbol_key, sizeof(symbol_key), "%.*s_SYMBOL", name_length, key);
+        const char* symbol = rift_get_config_value(gov, symbol_key);
+        long precedence = strtol(gov->entries[i]->pattern, NULL, 10);
+        
+        if (!symbol || strlen(symbol) != 1 || precedence < 1 || precedence > UINT8_MAX) {
+            fprintf(stderr, "Ignoring operator %.*s: needs a 1-byte %s and precedence 1-255\n",
+                    name_length, key, symbol_key);
+            continue;
+        }
+        
+        unsigned char byte = (unsigned char)symbol[0];
+        if (!table->precedence[byte]) table->operator_count++;
+        table->precedence[byte] = (uint8_t)precedence;
+        table->right_associative[byte] = right;
+    }
+}
+
+static rift_parser_t* rift_parser_create(rift_governance_t* gov, rift_arena_t* arena) {
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_RIFT1);
+    rift_parser_t* parser = rift_alloc(allocator, sizeof(rift_parser_t));
+    if (!parser) return NULL;
+    
+    parser->allocator = allocator;
+    parser->governance = gov;
+    parser->arena = arena;
+    parser->current_position = 0;
+    rift_operator_table_load(&parser->operators, gov);
+    return parser;
+}
+
+static void rift_parser_destroy(rift_parser_t* parser) {
+    if (parser) rift_free(parser->allocator, parser);
+}
+
+// Allocated from the arena; value is borrowed from the token stream source
+static ast_node_t* create_ast_node(rift_arena_t* arena, ast_node_type_t type,
+                                   const char* value, size_t value_length) {
+    ast_node_t* node = rift_arena_alloc(arena, sizeof(ast_node_t));
+    if (!node) {
+        fprintf(stderr, "Failed to allocate AST node\n");
+        exit(1);
+    }
+    rift_allocator_count_items(arena->allocator, 1);
+    node->type = type;
+    node->value = value;
+    node->value_length = value ? value_length : 0;
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
+
+// Forward declarations for the precedence-climbing parser
+static ast_node_t* parse_expression(rift_parser_t* parser, int min_precedence);
+static ast_node_t* parse_factor(rift_parser_t* parser);
+
+static bool has_token(rift_parser_t* parser) {
+    return parser->current_position < token_stream_count(parser->input_tokens);
+}
+
+static token_type_t current_type(rift_parser_t* parser) {
+    return token_stream_type(parser->input_tokens, parser->current_position);
+}
+
+// Precedence of the current token as a binary operator, 0 if it is not one
+static int current_precedence(rift_parser_t* parser) {
+    const token_stream_t* tokens = parser->input_tokens;
+    size_t index = parser->current_position;
+    
+    if (current_type(parser) != TOKEN_OPERATOR || token_stream_length(tokens, index) != 1) return 0;
+    return parser->operators.precedence[(unsigned char)token_stream_text(tokens, index)[0]];
+}
+
+static void advance_token(rift_parser_t* parser) {
+    if (parser->current_position < token_stream_count(parser->input_tokens)) {
+        parser->current_position++;
+    }
+}
+
+// Builds an AST node whose value is the text of the token at index
+static ast_node_t* create_token_node(rift_parser_t* parser, ast_node_type_t type, size_t index) {
+    return create_ast_node(parser->arena, type, token_stream_text(parser->input_tokens, index),
+                           token_stream_length(parser->input_tokens, index));
+}
+
+static ast_node_t* parse_factor(rift_parser_t* parser) {
+    if (!has_token(parser)) return NULL;
+    
+    size_t index = parser->current_position;
+    token_type_t type = current_type(parser);
+    if (type == TOKEN_IDENTIFIER) {
+        advance_token(parser);
+        return create_token_node(parser, AST_IDENTIFIER, index);
+    } else if (type == TOKEN_NUMBER) {
+        advance_token(parser);
+        return create_token_node(parser, AST_NUMBER, index);
+    }
+    
+    return NULL;
+}
+
+// Precedence climbing: folds operators binding at least as tightly as
+// min_precedence into left. Left-associative chains loop rather than recurse.
+static ast_node_t* parse_expression(rift_parser_t* parser, int min_precedence) {
+    ast_node_t* left = parse_factor(parser);
+    
+    while (has_token(parser)) {
+        int precedence = current_precedence(parser);
+        if (precedence == 0 || precedence < min_precedence) break;
+        
+        size_t op = parser->current_position;
+        unsigned char symbol = (unsigned char)token_stream_text(parser->input_tokens, op)[0];
+        int next_min = parser->operators.right_associative[symbol] ? precedence : precedence + 1;
+        advance_token(parser);
+        
+        ast_node_t* right = parse_expression(parser, next_min);
+        ast_node_t* binary_op = create_token_node(parser, AST_BINARY_OP, op);
+        binary_op->left = left;
+        binary_op->right = right;
+        left = binary_op;
+    }
+    
+    return left;
+}
+
+static ast_node_t* rift_parse(rift_parser_t* parser, token_stream_t* tokens) {
+    uint64_t stage_start = rift_timer_start();
+    rift_print_stage_info("RIFT-1", "Parsing token stream to AST");
+    
+    parser->input_tokens = tokens;
+    parser->current_position = 0;
+    
+    uint64_t parse_start = rift_timer_start();
+    ast_node_t* ast = parse_expression(parser, 1);
+    rift_timer_stop(RIFT_TIMER_PARSE, parse_start);
+    
+    if (has_token(parser)) {
+        size_t index = parser->current_position;
+        rift_log("  → Parsing stopped at line %zu, column %zu: '%.*s' (%zu tokens unconsumed)\n",
+                 token_stream_line(tokens, index), token_stream_column(tokens, index),
+                 (int)token_stream_length(tokens, index), token_stream_text(tokens, index),
+                 token_stream_count(tokens) - index);
+    }
+    rift_log("  → Parsing complete: AST root created (%zu arena bytes)\n", parser->arena->bytes_used);
+    rift_timer_stop(RIFT_TIMER_RIFT1, stage_start);
+    return ast;
+}
+
+// ================================
+// RIFT-2: AST Coordinator Implementation
+// ================================
+
+static rift_ast_coordinator_t* rift_ast_coordinator_create(rift_governance_t* gov,
+                                                           rift_arena_t* arena) {
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_RIFT2);
+    rift_ast_coordinator_t* coordinator = rift_alloc(allocator, sizeof(rift_ast_coordinator_t));
+    if (!coordinator) return NULL;
+    
+    const char* folding = rift_get_config_value(gov, "constant_folding");
+    
+    coordinator->allocator = allocator;
+    coordinator->governance = gov;
+    coordinator->arena = arena;
+    coordinator->node_count = 0;
+    coordinator->constant_folding = folding && strcmp(folding, "enabled") == 0;
+    coordinator->optimization_passes = coordinator->constant_folding ? 1 : 0;
+    coordinator->folded_operations = 0;
+    coordinator->division_by_zero = 0;
+    coordinator->walk = (rift_ast_walk_stack_t){NULL, 0, allocator};
+    return coordinator;
+}
+
+static void rift_ast_coordinator_destroy(rift_ast_coordinator_t* coordinator) {
+    if (!coordinator) return;
+    rift_free(coordinator->allocator, coordinator->walk.nodes);
+    rift_free(coordinator->allocator, coordinator);
+}
+
+// Clears per-AST results so the coordinator can take the next input
+static void rift_ast_coordinator_reset(rift_ast_coordinator_t* coordinator) {
+    coordinator->root = NULL;
+    coordinator->node_count = 0;
+    coordinator->folded_operations = 0;
+    coordinator->division_by_zero = 0;
+}
+
+typedef void (*rift_ast_visit_fn)(void* context, ast_node_t* node, size_t depth);
+
+// Post-order walk: visit sees every node after its children, with its depth
+// (the root is 1). Ancestors live on an explicit stack, so a left-associative
+// chain of n operands costs n pointers rather than n C frames. Returns false
+// if the stack cannot grow; nodes visited so far stay visited.
+static bool walk_ast(rift_ast_walk_stack_t* stack, ast_node_t* root,
+                     rift_ast_visit_fn visit, void* context) {
+    size_t top = 0;
+    ast_node_t* node = root;
+    ast_node_t* last = NULL;   // Most recently visited node
+    
+    while (node || top > 0) {
+        if (node && (node->left || node->right)) {
+            if (top == stack->capacity) {
+                size_t capacity = stack->capacity ? stack->capacity * 2 : 64;
+                ast_node_t** grown = rift_realloc(stack->allocator, stack->nodes,
+                                                  sizeof(ast_node_t*) * capacity);
+                if (!grown) return false;
+                stack->nodes = grown;
+                stack->capacity = capacity;
+            }
+            stack->nodes[top++] = node;
+            node = node->left;
+            continue;
+        }
+        if (node) {
+            visit(context, node, top + 1);
+            last = node;
+            node = NULL;
+            continue;
+        }
+        
+        // Left subtree done: descend right once, then visit the parent
+        ast_node_t* parent = stack->nodes[top - 1];
+        if (parent->right && parent->right != last) {
+            node = parent->right;
+            continue;
+        }
+        top--;
+        visit(context, parent, top + 1);
+        last = parent;
+    }
+    return true;
+}
+
+typedef struct {
+    size_t nodes;
+    size_t depth;
+} rift_ast_shape_t;
+
+static void measure_ast_visit(void* context, ast_node_t* node, size_t depth) {
+    (void)node;
+    rift_ast_shape_t* shape = context;
+    shape->nodes++;
+    if (depth > shape->depth) shape->depth = depth;
+}
+
+// Node count and depth of the AST rooted at node
+static bool measure_ast(rift_ast_walk_stack_t* stack, ast_node_t* node, rift_ast_shape_t* shape) {
+    *shape = (rift_ast_shape_t){0, 0};
+    return walk_ast(stack, node, measure_ast_visit, shape);
+}
+
+// A numeric literal: integers fold with int64 semantics, anything with a
+// fraction or exponent as double
+typedef struct {
+    bool is_float;
+    int64_t i;
+    double f;
+} rift_constant_t;
+
+static bool parse_constant(const ast_node_t* node, rift_constant_t* out) {
+    char text[64];
+    if (node->type != AST_NUMBER || node->value_length >= sizeof(text)) return false;
+    
+    memcpy(text, node->value, node->value_length);
+    text[node->value_length] = '\0';
+    
+    char* end;
+    errno = 0;
+    out->is_float = strpbrk(text, ".eE") != NULL;
+    if (out->is_float) {
+        out->f = strtod(text, &end);
+    } else {
+        long long value = strtoll(text, &end, 10);
+        out->i = value;
+        out->f = (double)value;
+    }
+    return *end == '\0' && end != text && errno == 0;
+}
+
+// Evaluates left op right. Returns false when the result is not a plain
+// literal (overflow, non-finite) or on division by zero, which stays in the
+// tree for the runtime to report.
+static bool fold_constants(rift_ast_coordinator_t* coordinator, char op,
+                           rift_constant_t left, rift_constant_t right, rift_constant_t* out) {
+    bool is_division = op == '/';
+    if (is_division && (left.is_float || right.is_float ? right.f == 0.0 : right.i == 0)) {
+        coordinator->division_by_zero++;
+        return false;
+    }
+    
+    if (left.is_float || right.is_float) {
+        double a = left.is_float ? left.f : (double)left.i;
+        double b = right.is_float ? right.f : (double)right.i;
+        switch (op) {
+            case '+': out->f = a + b; break;
+            case '-': out->f = a - b; break;
+            case '*': out->f = a * b; break;
+            case '/': out->f = a / b; break;
+            default: return false;
+        }
+        out->is_float = true;
+        return isfinite(out->f);
+    }
+    
+    int64_t a = left.i;
+    int64_t b = right.i;
+    out->is_float = false;
+    switch (op) {
+        case '+': return !__builtin_add_overflow(a, b, &out->i);
+        case '-': return !__builtin_sub_overflow(a, b, &out->i);
+        case '*': return !__builtin_mul_overflow(a, b, &out->i);
+        case '/':
+            if (a == INT64_MIN && b == -1) return false;
+            out->i = a / b;  // C truncation toward zero
+            return true;
+        default: return false;
+    }
+}
+
+// Replaces a constant binary operation with its value in place; operations
+// that cannot be evaluated are left as they are. Run post-order by fold_ast,
+// so both operands are already folded.
+static void fold_ast_visit(void* context, ast_node_t* node, size_t depth) {
+    (void)depth;
+    rift_ast_coordinator_t* coordinator = context;
+    if (node->type != AST_BINARY_OP) return;
+    
+    rift_constant_t left, right, result;
+    if (!node->left || !node->right || node->value_length != 1 ||
+        !parse_constant(node->left, &left) || !parse_constant(node->right, &right) ||
+        !fold_constants(coordinator, node->value[0], left, right, &result)) {
+        return;
+    }
+    
+    char text[64];
+    int length;
+    if (result.is_float) {
+        length = snprintf(text, sizeof(text), "%.17g", result.f);
+        if (!strpbrk(text, ".eE")) length = snprintf(text, sizeof(text), "%.17g.0", result.f);
+    } else {
+        length = snprintf(text, sizeof(text), "%lld", (long long)result.i);
+    }
+    
+    char* value = rift_arena_strndup(coordinator->arena, text, (size_t)length);
+    if (!value) return;
+    
+    // Children stay in the arena and are released with it
+    node->type = AST_NUMBER;
+    node->value = value;
+    node->value_length = (size_t)length;
+    node->left = NULL;
+    node->right = NULL;
+    coordinator->folded_operations++;
+}
+
+static bool fold_ast(rift_ast_coordinator_t* coordinator, ast_node_t* node) {
+    return walk_ast(&coordinator->walk, node, fold_ast_visit, coordinator);
+}
+
+static ast_node_t* rift_coordinate_ast(rift_ast_coordinator_t* coordinator, ast_node_t* ast) {
+    uint64_t stage_start = rift_timer_start();
+    rift_print_stage_info("RIFT-2", "Coordinating and optimizing AST");
+    
+    coordinator->root = ast;
+    rift_ast_shape_t shape;
+    bool ok = measure_ast(&coordinator->walk, ast, &shape);
+    coordinator->node_count = shape.nodes;
+    
+    rift_log("  → AST contains %zu nodes\n", coordinator->node_count);
+    rift_log("  → Applying %zu optimization passes\n", coordinator->optimization_passes);
+    
+    if (ok && coordinator->constant_folding) {
+        uint64_t passes_start = rift_timer_start();
+        ok = fold_ast(coordinator, ast) && measure_ast(&coordinator->walk, ast, &shape);
+        rift_timer_stop(RIFT_TIMER_PASSES, passes_start);
+        coordinator->node_count = shape.nodes;
+        rift_log("  → Constant folding: %zu operations folded, %zu nodes remain\n",
+                 coordinator->folded_operations, coordinator->node_count);
+        if (coordinator->division_by_zero) {
+            rift_log("  → Constant folding: %zu divisions by zero left unfolded\n",
+                     coordinator->division_by_zero);
+        }
+    }
+    if (ok) rift_log("  → AST coordination complete\n");
+    else fprintf(stderr, "RIFT-2: out of memory while walking the AST\n");
+    
+    rift_timer_stop(RIFT_TIMER_RIFT2, stage_start);
+    return ok ? ast : NULL;
+}
+
+// ================================
+// RIFT-3: Output Stage Implementation
+// ================================
+
+#define RIFT_OUTPUT_FLUSH_SIZE ((size_t)1 << 20)
+#define RIFT_INDENT_BLOCK_SIZE 4096
+#define RIFT_INDENT_MAX_WIDTH 16
+
+static rift_output_stage_t* rift_output_stage_create(rift_governance_t* gov) {
+    rift_allocator_t* allocator = rift_governance_allocator(gov, RIFT_MEMORY_RIFT3);
+    rift_output_stage_t* output = rift_alloc(allocator, sizeof(rift_output_stage_t));
+    if (!output) return NULL;
+    
+    const char* style = rift_get_config_value(gov, "indentation_style");
+    const char* size = rift_get_config_value(gov, "indentation_size");
+    bool tabs = style && strcmp(style, "tabs") == 0;
+    long width = size ? strtol(size, NULL, 10) : 2;
+    if (tabs) width = 1;
+    if (width < 0 || width > RIFT_INDENT_MAX_WIDTH) width = 2;
+    
+    output->allocator = allocator;
+    output->governance = gov;
+    output->output_format = rift_strdup(allocator, "LISP_STYLE_AST");
+    output->output_fd = STDOUT_FILENO;
+    output->indent_width = (size_t)width;
+    output->indent_block = rift_alloc(allocator, RIFT_INDENT_BLOCK_SIZE);
+    output->buffer = (rift_output_buffer_t){0};
+    output->buffer.allocator = allocator;
+    output->buffer.capacity = RIFT_OUTPUT_FLUSH_SIZE + RIFT_INDENT_BLOCK_SIZE;
+    output->buffer.data = rift_alloc(allocator, output->buffer.capacity);
+    output->defer_flush = false;
+    if (!output->output_format || !output->indent_block || !output->buffer.data) {
+        rift_free(allocator, output->output_format);
+        rift_free(allocator, output->indent_block);
+        rift_free(allocator, output->buffer.data);
+        rift_free(allocator, output);
+        return NULL;
+    }
+    memset(output->indent_block, tabs ? '\t' : ' ', RIFT_INDENT_BLOCK_SIZE);
+    return output;
+}
+
+static void rift_output_stage_destroy(rift_output_stage_t* output) {
+    if (!output) return;
+    rift_free(output->allocator, output->output_format);
+    rift_free(output->allocator, output->indent_block);
+    rift_free(output->allocator, output->buffer.data);
+    rift_free(output->allocator, output);
+}
+
+static bool rift_write_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+static void output_buffer_flush(rift_output_buffer_t* buffer) {
+    if (buffer->length == 0 || buffer->failed) return;
+    
+    uint64_t write_start = rift_timer_start();
+    bool written = rift_write_all(buffer->fd, buffer->data, buffer->length);
+    rift_timer_stop(RIFT_TIMER_WRITE, write_start);
+    
+    if (!written) {
+        perror("RIFT-3 output write");
+        buffer->failed = true;
+    } else {
+        buffer->bytes_written += buffer->length;
+        buffer->write_calls++;
+    }
+    buffer->length = 0;
+}
+
+static void output_buffer_append(rift_output_buffer_t* buffer, const char* data, size_t length) {
+    if (buffer->length + length > buffer->capacity) {
+        output_buffer_flush(buffer);
+        if (length > buffer->capacity) {
+            char* grown = rift_realloc(buffer->allocator, buffer->data, length);
+            if (!grown) {
+                buffer->failed = true;
+                return;
+            }
+            buffer->data = grown;
+            buffer->capacity = length;
+        }
+    }
+    if (buffer->failed) return;
+    
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+}
+
+static void output_buffer_puts(rift_output_buffer_t* buffer, const char* str) {
+    output_buffer_append(buffer, str, strlen(str));
+}
+
+static void output_indent(rift_output_stage_t* output, rift_output_buffer_t* buffer, size_t depth) {
+    size_t remaining = depth * output->indent_width;
+    while (remaining > 0) {
+        size_t chunk = remaining < RIFT_INDENT_BLOCK_SIZE ? remaining : RIFT_INDENT_BLOCK_SIZE;
+        output_buffer_append(buffer, output->indent_block, chunk);
+        remaining -= chunk;
+    }
+}
+
+typedef struct {
+    ast_node_t* node;
+    size_t depth;
+    bool closing;          // Emit the ')' line of a BinOp rather than the node
+} render_frame_t;
+
+// Renders the AST with an explicit stack, so deep left-leaning chains do not
+// recurse once per level
+static bool render_ast(rift_output_stage_t* output, rift_output_buffer_t* buffer,
+                       ast_node_t* root, size_t depth) {
+    size_t capacity = 64;
+    size_t top = 0;
+    render_frame_t* stack = rift_alloc(output->allocator, sizeof(render_frame_t) * capacity);
+    if (!stack) return false;
+    
+    if (root) stack[top++] = (render_frame_t){root, depth, false};
+    
+    while (top > 0 && !buffer->failed) {
+        render_frame_t frame = stack[--top];
+        ast_node_t* node = frame.node;
+        
+        output_indent(output, buffer, frame.depth);
+        if (frame.closing) {
+            output_buffer_append(buffer, ")\n", 2);
+            continue;
+        }
+        
+        switch (node->type) {
+            case AST_IDENTIFIER:
+                output_buffer_puts(buffer, "(Identifier ");
+                output_buffer_append(buffer, node->value, node->value_length);
+                output_buffer_append(buffer, ")\n", 2);
+                break;
+            case AST_NUMBER:
+                output_buffer_puts(buffer, "(Number ");
+                output_buffer_append(buffer, node->value, node->value_length);
+                output_buffer_append(buffer, ")\n", 2);
+                break;
+            case AST_BINARY_OP:
+                output_buffer_puts(buffer, "(BinOp ");
+                output_buffer_append(buffer, node->value, node->value_length);
+                output_buffer_append(buffer, "\n", 1);
+                
+                if (top + 3 > capacity) {
+                    capacity *= 2;
+                    render_frame_t* grown = rift_realloc(output->allocator, stack,
+                                                         sizeof(render_frame_t) * capacity);
+                    if (!grown) {
+                        rift_free(output->allocator, stack);
+                        return false;
+                    }
+                    stack = grown;
+                }
+                // Pushed in reverse: left child, right child, then ')'
+                stack[top++] = (render_frame_t){node, frame.depth, true};
+                if (node->right) stack[top++] = (render_frame_t){node->right, frame.depth + 1, false};
+                if (node->left) stack[top++] = (render_frame_t){node->left, frame.depth + 1, false};
+                break;
+            default:
+                output_buffer_puts(buffer, "(Unknown)\n");
+                break;
+        }
+        
+        if (buffer->length >= RIFT_OUTPUT_FLUSH_SIZE) output_buffer_flush(buffer);
+    }
+    
+    rift_free(output->allocator, stack);
+    return !buffer->failed;
+}
+
+static bool rift_generate_output(rift_output_stage_t* output, ast_node_t* ast) {
+    uint64_t stage_start = rift_timer_start();
+    rift_print_stage_info("RIFT-3", "Generating final output");
+    
+    output->ast = ast;
+    
+    rift_log("  → Output format: %s\n", output->output_format);
+    rift_log("  → Final AST structure:\n");
+    fflush(stdout);  // Keep stdio output ordered before our direct writes
+    
+    rift_output_buffer_t* buffer = &output->buffer;
+    if (buffer->fd != output->output_fd) {
+        output_buffer_flush(buffer);
+        buffer->fd = output->output_fd;
+    }
+    
+    uint64_t render_start = rift_timer_start();
+    output_buffer_puts(buffer, "(AST\n");
+    bool ok = render_ast(output, buffer, ast, 1);
+    output_buffer_puts(buffer, ")\n");
+    rift_timer_stop(RIFT_TIMER_RENDER, render_start);
+    if (!output->defer_flush) output_buffer_flush(buffer);
+    
+    ok = ok && !buffer->failed;
+    if (output->output_fd != STDOUT_FILENO) {
+        rift_log("  → Wrote %zu bytes in %zu writes\n", buffer->bytes_written, buffer->write_calls);
+    }
+    rift_timer_stop(RIFT_TIMER_RIFT3, stage_start);
+    return ok;
+}
+
+// Writes out whatever defer_flush has held back
+static bool rift_output_stage_flush(rift_output_stage_t* output) {
+    output_buffer_flush(&output->buffer);
+    return !output->buffer.failed;
+}
+
+// ================================
+// Utility Functions
+// ================================
+
+static void rift_log(const char* format, ...) {
+    if (!rift_stage_logging) return;
+    
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+static void rift_print_stage_info(const char* stage, const char* message) {
+    rift_log("\n[%s] %s\n", stage, message);
+}
+
+// Maps path read-only so every stage works on the page cache directly
+static bool rift_source_map_file(rift_source_t* source, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    
+    source->length = (size_t)st.st_size;
+    source->mapped = source->length > 0;
+    source->data = "";
+    
+    if (source->mapped) {
+        void* mapping = mmap(NULL, source->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(mapping, source->length, MADV_SEQUENTIAL);
+        source->data = mapping;
+    }
+    
+    close(fd);
+    return true;
+}
+
+static void rift_source_close(rift_source_t* source) {
+    if (source->mapped) munmap((void*)source->data, source->length);
+    source->data = NULL;
+    source->length = 0;
+    source->mapped = false;
+}
+
+// ================================
+// Pipelined Execution
+// Many inputs per run. With inter_stage_communication=message_passing each
+// stage runs on its own thread and hands jobs to the next through a bounded
+// lock-free single-producer/single-consumer ring, so tokenizing input N+1
+// overlaps parsing input N. Otherwise the same steps run back to back.
+// ================================
+
+#define RIFT_PIPELINE_QUEUE_SIZE 64   // Slots per ring, a power of two
+#define RIFT_PIPELINE_BATCH 16        // Jobs moved per queue operation
+#define RIFT_PIPELINE_STAGES 4
+
+// head is only written by the consumer and tail by the producer; each sits
+// on its own cache line so the two threads do not false-share
+typedef struct {
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    _Alignas(64) void* slots[RIFT_PIPELINE_QUEUE_SIZE];
+} rift_spsc_queue_t;
+
+// One input travelling through the stages. A NULL job marks end of input.
+typedef struct {
+    const char* path;
+    rift_source_t source;
+    token_stream_t* tokens;
+    rift_arena_t* arena;       // Owns this input's AST until RIFT-3 is done
+    ast_node_t* ast;
+    const char* error;         // First failure; later stages pass the job on
+} rift_pipeline_job_t;
+
+typedef struct rift_pipeline rift_pipeline_t;
+typedef void (*rift_pipeline_step_fn)(rift_pipeline_t* pipeline, rift_pipeline_job_t* job);
+
+struct rift_pipeline {
+    rift_tokenizer_t* tokenizer;
+    rift_parser_t* parser;
+    rift_ast_coordinator_t* coordinator;
+    rift_output_stage_t* output;
+    rift_spsc_queue_t queues[RIFT_PIPELINE_STAGES - 1];  // queues[i] feeds stage i + 1
+    size_t completed;          // Counted by the RIFT-3 step only
+    size_t failed;
+};
+
+typedef struct {
+    rift_pipeline_t* pipeline;
+    int stage;
+} rift_pipeline_worker_t;
+
+// Producer side: copies up to count items in, returns how many fit
+static size_t rift_spsc_push(rift_spsc_queue_t* queue, void* const* items, size_t count) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    size_t space = RIFT_PIPELINE_QUEUE_SIZE - (tail - head);
+    if (count > space) count = space;
+    
+    for (size_t i = 0; i < count; i++) {
+        queue->slots[(tail + i) & (RIFT_PIPELINE_QUEUE_SIZE - 1)] = items[i];
+    }
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+    return count;
+}
+
+// Consumer side: copies up to max items out, returns how many there were
+static size_t rift_spsc_pop(rift_spsc_queue_t* queue, void** items, size_t max) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    size_t count = tail - head;
+    if (count > max) count = max;
+    
+    for (size_t i = 0; i < count; i++) {
+        items[i] = queue->slots[(head + i) & (RIFT_PIPELINE_QUEUE_SIZE - 1)];
+    }
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+    return count;
+}
+
+static void rift_spsc_push_all(rift_spsc_queue_t* queue, void* const* items, size_t count) {
+    while (count > 0) {
+        size_t pushed = rift_spsc_push(queue, items, count);
+        items += pushed;
+        count -= pushed;
+        if (count > 0) sched_yield();  // Full: let the consumer catch up
+    }
+}
+
+static size_t rift_spsc_pop_wait(rift_spsc_queue_t* queue, void** items, size_t max) {
+    size_t count;
+    while ((count = rift_spsc_pop(queue, items, max)) == 0) sched_yield();
+    return count;
+}
+
+static void rift_pipeline_tokenize_step(rift_pipeline_t* pipeline, rift_pipeline_job_t* job) {
+    if (!rift_source_map_file(&job->source, job->path)) {
+        job->error = "cannot map input file";
+        return;
+    }
+    job->tokens = rift_tokenize(pipeline->tokenizer, job->source.data, job->source.length);
+    if (!job->tokens) job->error = "tokenization failed";
+}
+
+static void rift_pipeline_parse_step(rift_pipeline_t* pipeline, rift_pipeline_job_t* job) {
+    job->arena = rift_arena_create(RIFT_ARENA_DEFAULT_BLOCK_SIZE, pipeline->parser->allocator);
+    if (!job->arena) {
+        job->error = "out of memory";
+        return;
+    }
+    pipeline->parser->arena = job->arena;
+    job->ast = rift_parse(pipeline->parser, job->tokens);
+    if (!job->ast) job->error = "parsing failed";
+}
+
+static void rift_pipeline_coordinate_step(rift_pipeline_t* pipeline, rift_pipeline_job_t* job) {
+    pipeline->coordinator->arena = job->arena;
+    job->ast = rift_coordinate_ast(pipeline->coordinator, job->ast);
+    if (!job->ast) job->error = "AST coordination failed";
+}
+
+// Emits the AST (inputs come out in command-line order) and retires the job
+static void rift_pipeline_output_step(rift_pipeline_t* pipeline, rift_pipeline_job_t* job) {
+    if (!job->error) {
+        printf("; %s\n", job->path);
+        if (!rift_generate_output(pipeline->output, job->ast)) job->error = "output failed";
+    }
+    
+    if (job->error) {
+        fprintf(stderr, "%s: %s\n", job->path, job->error);
+        pipeline->failed++;
+    }
+    pipeline->completed++;
+    
+    token_stream_destroy(job->tokens);
+    rift_arena_destroy(job->arena);
+    if (job->source.data) rift_source_close(&job->source);
+    free(job);
+}
+
+static const rift_pipeline_step_fn rift_pipeline_steps[RIFT_PIPELINE_STAGES] = {
+    rift_pipeline_tokenize_step,
+    rift_pipeline_parse_step,
+    rift_pipeline_coordinate_step,
+    rift_pipeline_output_step
+};
+
+// RIFT-1..3 worker: drains its input ring in batches, runs its step on every
+// job that has not failed yet and forwards the batch, end marker included
+static void* rift_pipeline_worker(void* arg) {
+    rift_pipeline_worker_t* worker = arg;
+    rift_pipeline_t* pipeline = worker->pipeline;
+    int stage = worker->stage;
+    rift_spsc_queue_t* input = &pipeline->queues[stage - 1];
+    rift_spsc_queue_t* output = stage + 1 < RIFT_PIPELINE_STAGES ? &pipeline->queues[stage] : NULL;
+    
+    for (bool done = false; !done; ) {
+        void* batch[RIFT_PIPELINE_BATCH];
+        size_t count = rift_spsc_pop_wait(input, batch, RIFT_PIPELINE_BATCH);
+        size_t forward = count;
+        
+        for (size_t i = 0; i < count; i++) {
+            rift_pipeline_job_t* job = batch[i];
+            if (!job) {
+                done = true;
+                forward = i + 1;
+                break;
+            }
+            // The output step frees the job, so check the error first
+            if (!job->error || !output) rift_pipeline_steps[stage](pipeline, job);
+        }
+        
+        if (output) rift_spsc_push_all(output, batch, forward);
+    }
+    return NULL;
+}
+
+static rift_pipeline_job_t* rift_pipeline_job_create(const char* path) {
+    rift_pipeline_job_t* job = calloc(1, sizeof(rift_pipeline_job_t));
+    if (job) job->path = path;
+    return job;
+}
+
+// Feeds jobs through RIFT-0 on the calling thread; workers[s - 1] runs
+// stage s. Falls back to running every step here when threading is off or a
+// worker cannot be started.
+static bool rift_pipeline_execute(rift_pipeline_t* pipeline, const char* const* paths,
+                                  size_t path_count, bool threaded) {
+    pthread_t threads[RIFT_PIPELINE_STAGES - 1];
+    rift_pipeline_worker_t workers[RIFT_PIPELINE_STAGES - 1];
+    int started = RIFT_PIPELINE_STAGES;  // Lowest stage with a running worker
+    
+    // Start consumers first so each one's input always has a reader
+    for (int stage = RIFT_PIPELINE_STAGES - 1; threaded && stage >= 1; stage--) {
+        workers[stage - 1] = (rift_pipeline_worker_t){pipeline, stage};
+        if (pthread_create(&threads[stage - 1], NULL, rift_pipeline_worker, &workers[stage - 1]) != 0) {
+            break;
+        }
+        started = stage;
+    }
+    
+    if (threaded && started != 1) {
+        fprintf(stderr, "Could not start pipeline threads, running stages in sequence\n");
+        if (started < RIFT_PIPELINE_STAGES) {
+            void* end = NULL;
+            rift_spsc_push_all(&pipeline->queues[started - 1], &end, 1);
+            for (int stage = started; stage < RIFT_PIPELINE_STAGES; stage++) {
+                pthread_join(threads[stage - 1], NULL);
+            }
+        }
+        threaded = false;
+    }
+    
+    bool ok = true;
+    void* batch[RIFT_PIPELINE_BATCH];
+    size_t pending = 0;
+    
+    for (size_t i = 0; i < path_count; i++) {
+        rift_pipeline_job_t* job = rift_pipeline_job_create(paths[i]);
+        if (!job) {
+            fprintf(stderr, "Out of memory queueing %s\n", paths[i]);
+            ok = false;
+            break;
+        }
+        
+        rift_pipeline_tokenize_step(pipeline, job);
+        if (!threaded) {
+            for (int stage = 1; stage < RIFT_PIPELINE_STAGES; stage++) {
+                if (!job->error || stage == RIFT_PIPELINE_STAGES - 1) {
+                    rift_pipeline_steps[stage](pipeline, job);
+                }
+            }
+            continue;
+        }
+        
+        batch[pending++] = job;
+        if (pending == RIFT_PIPELINE_BATCH) {
+            rift_spsc_push_all(&pipeline->queues[0], batch, pending);
+            pending = 0;
+        }
+    }
+    
+    if (threaded) {
+        batch[pending++] = NULL;  // End of input
+        rift_spsc_push_all(&pipeline->queues[0], batch, pending);
+        for (int stage = 1; stage < RIFT_PIPELINE_STAGES; stage++) {
+            pthread_join(threads[stage - 1], NULL);
+        }
+    }
+    return ok;
+}
+
+// --pipeline FILE...: runs every file through RIFT-0 → RIFT-3 with one set
+// of stage objects and prints the rendered ASTs in argument order
+static int rift_pipeline_run(rift_governance_t* governance, const char* const* paths, size_t path_count) {
+    const char* communication = rift_get_config_value(governance, "inter_stage_communication");
+    bool threaded = communication && strcmp(communication, "message_passing") == 0;
+    
+    rift_pipeline_t* pipeline = aligned_alloc(_Alignof(rift_pipeline_t), sizeof(rift_pipeline_t));
+    if (!pipeline) {
+        fprintf(stderr, "Failed to allocate pipeline\n");
+        return 1;
+    }
+    memset(pipeline, 0, sizeof(*pipeline));
+    
+    pipeline->tokenizer = rift_tokenizer_create(governance);
+    pipeline->parser = rift_parser_create(governance, NULL);
+    pipeline->coordinator = rift_ast_coordinator_create(governance, NULL);
+    pipeline->output = rift_output_stage_create(governance);
+    
+    bool ok = pipeline->tokenizer && pipeline->parser && pipeline->coordinator && pipeline->output;
+    if (!ok) {
+        fprintf(stderr, "Failed to create pipeline stages\n");
+    } else {
+        pipeline->tokenizer->trace_tokens = false;
+        for (int i = 0; i < RIFT_PIPELINE_STAGES - 1; i++) {
+            atomic_init(&pipeline->queues[i].head, 0);
+            atomic_init(&pipeline->queues[i].tail, 0);
+        }
+        
+        printf("\n[PIPELINE] %zu inputs, %s\n", path_count,
+               threaded ? "one thread per stage (message_passing)" : "stages in sequence");
+        fflush(stdout);
+        
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rift_stage_logging = false;
+        ok = rift_pipeline_execute(pipeline, paths, path_count, threaded);
+        rift_stage_logging = true;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("\n[PIPELINE] %zu inputs processed, %zu failed, %.3f s\n",
+               pipeline->completed, pipeline->failed, seconds);
+        ok = ok && pipeline->failed == 0;
+    }
+    
+    rift_output_stage_destroy(pipeline->output);
+    rift_ast_coordinator_destroy(pipeline->coordinator);
+    rift_parser_destroy(pipeline->parser);
+    rift_tokenizer_destroy(pipeline->tokenizer);
+    free(pipeline);
+    return ok ? 0 : 1;
+}
+
+// ================================
+// Batch Execution
+// Millions of small inputs per run through one set of stage objects. The
+// token stream, arena and coordinator are reset between inputs instead of
+// being recreated, and rendered ASTs leave in large writes.
+// ================================
+
+typedef struct {
+    rift_tokenizer_t* tokenizer;
+    token_stream_t tokens;     // Storage reused by every input
+    rift_arena_t* arena;       // Reset per input; keeps its largest block
+    rift_parser_t* parser;
+    rift_ast_coordinator_t* coordinator;
+    rift_output_stage_t* output;
+    size_t inputs;
+    size_t failed;
+    size_t token_count;
+    size_t byte_count;
+} rift_batch_t;
+
+// Runs one input through RIFT-0 → RIFT-3. False only when output can no
+// longer be written; a malformed input is counted and skipped.
+static bool rift_batch_process(rift_batch_t* batch, const char* input, size_t length) {
+    rift_arena_reset(batch->arena);
+    rift_ast_coordinator_reset(batch->coordinator);
+    batch->inputs++;
+    batch->byte_count += length;
+    
+    if (!rift_tokenize_into(batch->tokenizer, &batch->tokens, input, length)) {
+        batch->failed++;
+        return true;
+    }
+    batch->token_count += token_stream_count(&batch->tokens);
+    
+    ast_node_t* ast = rift_parse(batch->parser, &batch->tokens);
+    if (!ast) {
+        batch->failed++;
+        return true;
+    }
+    
+    ast = rift_coordinate_ast(batch->coordinator, ast);
+    return ast && rift_generate_output(batch->output, ast);
+}
+
+// Every non-empty line of stream is one expression
+static bool rift_batch_process_lines(rift_batch_t* batch, FILE* stream) {
+    char* line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    bool ok = true;
+    
+    while (ok && (length = getline(&line, &line_capacity, stream)) >= 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) length--;
+        if (length == 0) continue;
+        ok = rift_batch_process(batch, line, (size_t)length);
+    }
+    
+    free(line);
+    return ok;
+}
+
+// Each file is one input, labelled with its path in the output
+static bool rift_batch_process_file(rift_batch_t* batch, const char* path) {
+    rift_source_t source;
+    if (!rift_source_map_file(&source, path)) {
+        fprintf(stderr, "%s: cannot map input file\n", path);
+        batch->inputs++;
+        batch->failed++;
+        return true;
+    }
+    
+    output_buffer_puts(&batch->output->buffer, "; ");
+    output_buffer_puts(&batch->output->buffer, path);
+    output_buffer_puts(&batch->output->buffer, "\n");
+    bool ok = rift_batch_process(batch, source.data, source.length);
+    rift_source_close(&source);
+    return ok;
+}
+
+// Creates the reusable stage objects; on failure the batch must still be
+// released
+static bool rift_batch_init(rift_batch_t* batch, rift_governance_t* governance) {
+    *batch = (rift_batch_t){0};
+    batch->tokenizer = rift_tokenizer_create(governance);
+    batch->arena = rift_arena_create(RIFT_ARENA_DEFAULT_BLOCK_SIZE,
+                                     rift_governance_allocator(governance, RIFT_MEMORY_RIFT1));
+    batch->parser = batch->arena ? rift_parser_create(governance, batch->arena) : NULL;
+    batch->coordinator = batch->arena ? rift_ast_coordinator_create(governance, batch->arena) : NULL;
+    batch->output = rift_output_stage_create(governance);
+    bool tokens_ready = token_stream_init(&batch->tokens,
+                                          rift_governance_allocator(governance, RIFT_MEMORY_RIFT0),
+                                          "", 0, 64);
+    
+    if (!batch->tokenizer || !batch->parser || !batch->coordinator || !batch->output || !tokens_ready) {
+        return false;
+    }
+    batch->tokenizer->trace_tokens = false;
+    batch->output->defer_flush = true;
+    return true;
+}
+
+static void rift_batch_release(rift_batch_t* batch) {
+    rift_output_stage_destroy(batch->output);
+    rift_ast_coordinator_destroy(batch->coordinator);
+    rift_parser_destroy(batch->parser);
+    rift_arena_destroy(batch->arena);
+    token_stream_release(&batch->tokens);
+    rift_tokenizer_destroy(batch->tokenizer);
+}
+
+// --batch [FILE...]: newline-delimited expressions from each FILE, or stdin
+// --batch-files FILE...: every FILE is one input
+static int rift_batch_run(rift_governance_t* governance, const char* const* paths,
+                          size_t path_count, bool whole_files) {
+    rift_batch_t batch;
+    bool ok = rift_batch_init(&batch, governance);
+    if (!ok) fprintf(stderr, "Failed to create batch stages\n");
+    
+    if (ok) {
+        printf("\n[BATCH] Reusing one set of RIFT-0 → RIFT-3 stage objects\n");
+        fflush(stdout);
+        
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rift_stage_logging = false;
+        
+        if (path_count == 0) {
+            ok = rift_batch_process_lines(&batch, stdin);
+        }
+        for (size_t i = 0; ok && i < path_count; i++) {
+            if (whole_files) {
+                ok = rift_batch_process_file(&batch, paths[i]);
+                continue;
+            }
+            
+            FILE* stream = strcmp(paths[i], "-") == 0 ? stdin : fopen(paths[i], "r");
+            if (!stream) {
+                fprintf(stderr, "%s: %s\n", paths[i], strerror(errno));
+                batch.failed++;
+                continue;
+            }
+            ok = rift_batch_process_lines(&batch, stream);
+            if (stream != stdin) fclose(stream);
+        }
+        
+        ok = rift_output_stage_flush(batch.output) && ok;
+        rift_stage_logging = true;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+        double rate = seconds > 0 ? 1.0 / seconds : 0.0;
+        printf("\n[BATCH] %zu inputs (%zu failed), %zu tokens, %zu bytes in %.3f s\n",
+               batch.inputs, batch.failed, batch.token_count, batch.byte_count, seconds);
+        printf("[BATCH] Throughput: %.0f expressions/s, %.0f tokens/s\n",
+               (double)batch.inputs * rate, (double)batch.token_count * rate);
+        if (!ok) fprintf(stderr, "Batch stopped: output could not be written\n");
+    }
+    
+    rift_batch_release(&batch);
+    return ok && batch.failed == 0 ? 0 : 1;
+}
+
+// ================================
+// Benchmark Harness
+// --bench [--seed N] [--expressions N] [--operands N] [--depth N]
+//         [--operators STR] [--vocabulary N] [--numbers PERCENT]
+//         [--repeat N] [--output FILE|-]
+// Times every stage on its own and then the whole pipeline over a seeded
+// synthetic workload, and saves the results as JSON so runs can be compared.
+// config_load parses the directory rift_governance_find_dir picks and fails
+// when there is none.
+// ================================
+
+#define RIFT_BENCH_MAX_RESULTS 8
+#define RIFT_BENCH_CONFIG_LOADS 20     // Governance loads per pass
+#define RIFT_BENCH_MAX_OPERAND 24      // "v" + 20 digits + " op "
+
+typedef struct {
+    uint64_t seed;
+    size_t expressions;
+    size_t operands;           // Operands per expression
+    size_t depth;              // Longest run of operators sharing a precedence
+    const char* operators;     // Operator mix; repeat a symbol to weight it
+    size_t vocabulary;         // Distinct identifiers
+    unsigned long number_percent;  // Operands that are numbers, not identifiers
+    size_t repeat;             // Timed passes over the workload
+    const char* output_path;   // "-" for stdout
+} rift_bench_config_t;
+
+typedef struct {
+    char* text;                // Every expression, newline separated
+    size_t* offsets;
+    size_t* lengths;
+    size_t count;
+    size_t bytes;              // Expression bytes, separators excluded
+} rift_bench_workload_t;
+
+typedef struct {
+    const char* name;
+    uint64_t ops;
+    uint64_t bytes;            // Input bytes consumed, 0 if not meaningful
+    uint64_t tokens;
+    uint64_t nodes;
+    uint64_t elapsed_ns;
+    uint64_t allocations;      // Allocator calls, reallocations included
+    uint64_t started_ns;
+    uint64_t started_allocations;
+} rift_bench_result_t;
+
+// xorshift64*: fast, and the same sequence on every platform for a seed
+static uint64_t rift_bench_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t rift_bench_allocations(void) {
+    uint64_t total = 0;
+    for (int s = 0; s < RIFT_MEMORY_STAGE_COUNT; s++) {
+        total += atomic_load(&rift_tracking_allocators[s].stats.allocations);
+        total += atomic_load(&rift_tracking_allocators[s].stats.reallocations);
+    }
+    return total;
+}
+
+static void rift_bench_resume(rift_bench_result_t* result) {
+    result->started_allocations = rift_bench_allocations();
+    result->started_ns = rift_clock_ns();
+}
+
+static void rift_bench_pause(rift_bench_result_t* result) {
+    result->elapsed_ns += rift_clock_ns() - result->started_ns;
+    result->allocations += rift_bench_allocations() - result->started_allocations;
+}
+
+// Operators come from the mix, but a run of equal-precedence operators
+// (which the parser chains into one deepening spine) is cut at depth
+// whenever the mix offers another precedence
+static char rift_bench_pick_operator(const rift_bench_config_t* config,
+                                     const rift_operator_table_t* table, uint64_t* state,
+                                     int* run_precedence, size_t* run) {
+    size_t count = strlen(config->operators);
+    char op = config->operators[rift_bench_random(state) % count];
+    
+    for (int attempt = 0; attempt < 16 && *run >= config->depth &&
+         table->precedence[(unsigned char)op] == *run_precedence; attempt++) {
+        op = config->operators[rift_bench_random(state) % count];
+    }
+    
+    int precedence = table->precedence[(unsigned char)op];
+    if (precedence == *run_precedence) {
+        (*run)++;
+    } else {
+        *run_precedence = precedence;
+        *run = 1;
+    }
+    return op;
+}
+
+static bool rift_bench_generate(const rift_bench_config_t* config, const rift_operator_table_t* table,
+                                rift_bench_workload_t* workload) {
+    *workload = (rift_bench_workload_t){0};
+    if (config->operands > (SIZE_MAX / RIFT_BENCH_MAX_OPERAND - 1) / config->expressions) return false;
+    
+    size_t capacity = config->expressions * (config->operands * RIFT_BENCH_MAX_OPERAND + 1) + 1;
+    workload->text = malloc(capacity);
+    workload->offsets = malloc(sizeof(size_t) * config->expressions);
+    workload->lengths = malloc(sizeof(size_t) * config->expressions);
+    if (!workload->text || !workload->offsets || !workload->lengths) return false;
+    
+    uint64_t state = config->seed ^ 0x9E3779B97F4A7C15ULL;
+    if (state == 0) state = 1;
+    char* out = workload->text;
+    
+    for (size_t e = 0; e < config->expressions; e++) {
+        char* start = out;
+        int run_precedence = 0;
+        size_t run = 0;
+        
+        for (size_t o = 0; o < config->operands; o++) {
+            if (o > 0) {
+                char op = rift_bench_pick_operator(config, table, &state, &run_precedence, &run);
+                out += sprintf(out, " %c ", op);
+            }
+            
+            uint64_t r = rift_bench_random(&state);
+            if (r % 100 < config->number_percent) {
+                unsigned value = (unsigned)(r >> 8) % 10000;
+                if ((r >> 32) % 4 == 0) out += sprintf(out, "%u.%u", value, (unsigned)(r >> 40) % 100);
+                else out += sprintf(out, "%u", value);
+            } else {
+                out += sprintf(out, "v%zu", (size_t)((r >> 8) % config->vocabulary));
+            }
+        }
+        
+        workload->offsets[e] = (size_t)(start - workload->text);
+        workload->lengths[e] = (size_t)(out - start);
+        workload->bytes += workload->lengths[e];
+        *out++ = '\n';
+    }
+    *out = '\0';
+    workload->count = config->expressions;
+    return true;
+}
+
+static void rift_bench_workload_release(rift_bench_workload_t* workload) {
+    free(workload->text);
+    free(workload->offsets);
+    free(workload->lengths);
+}
+
+static void rift_bench_json_ratio(FILE* out, const char* key, double numerator, uint64_t denominator) {
+    if (denominator) fprintf(out, ",\"%s\":%.3f", key, numerator / (double)denominator);
+    else fprintf(out, ",\"%s\":null", key);
+}
+
+static bool rift_bench_write_json(const char* path, const rift_bench_config_t* config,
+                                  const rift_bench_workload_t* workload, size_t tokens,
+                                  size_t nodes, size_t max_depth,
+                                  const rift_bench_result_t* results, size_t result_count) {
+    FILE* out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    
+    fprintf(out, "{\"rift_bench\":{\"workload\":{\"seed\":%llu,\"expressions\":%zu,\"operands\":%zu,"
+            "\"depth\":%zu,\"operators\":\"%s\",\"vocabulary\":%zu,\"number_percent\":%lu,"
+            "\"repeat\":%zu,\"bytes\":%zu,\"tokens\":%zu,\"ast_nodes\":%zu,\"max_ast_depth\":%zu},\n"
+            "\"results\":[",
+            (unsigned long long)config->seed, config->expressions, config->operands, config->depth,
+            config->operators, config->vocabulary, config->number_percent, config->repeat,
+            workload->bytes, tokens, nodes, max_depth);
+    
+    for (size_t i = 0; i < result_count; i++) {
+        const rift_bench_result_t* r = &results[i];
+        fprintf(out, "%s\n{\"name\":\"%s\",\"ops\":%llu,\"total_ns\":%llu", i ? "," : "",
+                r->name, (unsigned long long)r->ops, (unsigned long long)r->elapsed_ns);
+        rift_bench_json_ratio(out, "ns_per_op", (double)r->elapsed_ns, r->ops);
+        rift_bench_json_ratio(out, "ns_per_token", (double)r->elapsed_ns, r->tokens);
+        rift_bench_json_ratio(out, "ns_per_node", (double)r->elapsed_ns, r->nodes);
+        // bytes per ns * 1000 = MB/s
+        rift_bench_json_ratio(out, "mb_per_s", r->bytes ? (double)r->bytes * 1000.0 : 0.0,
+                              r->bytes ? r->elapsed_ns : 0);
+        rift_bench_json_ratio(out, "allocations_per_op", (double)r->allocations, r->ops);
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n]}}\n");
+    
+    bool ok = !ferror(out);
+    if (out != stdout) ok = fclose(out) == 0 && ok;
+    else fflush(out);
+    return ok;
+}
+
+static bool rift_bench_parse_size(const char* text, size_t* value, size_t min, size_t max) {
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno || end == text || *end != '\0' || parsed < min || parsed > max) return false;
+    *value = (size_t)parsed;
+    return true;
+}
+
+static bool rift_bench_parse_args(rift_bench_config_t* config, const rift_operator_table_t* table,
+                                  int argc, char** argv) {
+    for (int i = 0; i < argc; i++) {
+        const char* option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        size_t parsed = 0;
+        bool ok = value != NULL;
+        
+        if (ok && strcmp(option, "--seed") == 0) {
+            ok = rift_bench_parse_size(value, &parsed, 0, SIZE_MAX);
+            config->seed = parsed;
+        } else if (ok && strcmp(option, "--expressions") == 0) {
+            ok = rift_bench_parse_size(value, &config->expressions, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--operands") == 0) {
+            ok = rift_bench_parse_size(value, &config->operands, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--depth") == 0) {
+            ok = rift_bench_parse_size(value, &config->depth, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--vocabulary") == 0) {
+            ok = rift_bench_parse_size(value, &config->vocabulary, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--numbers") == 0) {
+            ok = rift_bench_parse_size(value, &parsed, 0, 100);
+            config->number_percent = (unsigned long)parsed;
+        } else if (ok && strcmp(option, "--repeat") == 0) {
+            ok = rift_bench_parse_size(value, &config->repeat, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--operators") == 0) {
+            config->operators = value;
+            ok = *value != '\0';
+            for (const char* op = value; ok && *op; op++) {
+                ok = table->precedence[(unsigned char)*op] != 0;
+            }
+        } else if (ok && strcmp(option, "--output") == 0) {
+            config->output_path = value;
+        } else {
+            ok = false;
+        }
+        
+        if (!ok) {
+            fprintf(stderr, "--bench: invalid option %s%s%s\n", option, value ? " " : "", value ? value : "");
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+static int rift_bench_run(rift_governance_t* governance, int argc, char** argv) {
+    rift_bench_config_t config = {
+        .seed = 1, .expressions = 10000, .operands = 8, .depth = 3, .operators = "+-*/",
+        .vocabulary = 64, .number_percent = 30, .repeat = 5, .output_path = "rift_bench.json"
+    };
+    rift_operator_table_t table;
+    rift_operator_table_load(&table, governance);
+    if (!rift_bench_parse_args(&config, &table, argc, argv)) return 1;
+    
+    rift_bench_workload_t workload;
+    if (!rift_bench_generate(&config, &table, &workload)) {
+        fprintf(stderr, "Failed to generate benchmark workload\n");
+        rift_bench_workload_release(&workload);
+        return 1;
+    }
+    
+    // Stage timers would time the same calls twice; the tracking allocators
+    // are always used so allocations per op can be reported
+    bool timing = rift_timing_enabled;
+    rift_timing_enabled = false;
+    rift_stage_logging = false;
+    for (int s = RIFT_MEMORY_RIFT0; s < RIFT_MEMORY_STAGE_COUNT; s++) {
+        governance->allocators[s] = &rift_tracking_allocators[s];
+    }
+    
+    // config_load times the .rift parse path, so it needs files to parse
+    const char* gov_dir = rift_governance_find_dir();
+    if (!gov_dir) {
+        fprintf(stderr, "[BENCH] config_load: no governance files found; set RIFT_GOV_DIR\n");
+    }
+    
+    size_t count = workload.count;
+    rift_tokenizer_t* tokenizer = rift_tokenizer_create(governance);
+    rift_arena_t* arena = rift_arena_create(RIFT_ARENA_DEFAULT_BLOCK_SIZE,
+                                            rift_governance_allocator(governance, RIFT_MEMORY_RIFT1));
+    rift_parser_t* parser = arena ? rift_parser_create(governance, arena) : NULL;
+    rift_ast_coordinator_t* coordinator = arena ? rift_ast_coordinator_create(governance, arena) : NULL;
+    rift_output_stage_t* output = rift_output_stage_create(governance);
+    token_stream_t** streams = calloc(count, sizeof(token_stream_t*));
+    ast_node_t** asts = calloc(count, sizeof(ast_node_t*));
+    int null_fd = open("/dev/null", O_WRONLY);
+    rift_batch_t batch;
+    bool ok = rift_batch_init(&batch, governance) && tokenizer && parser && coordinator &&
+              output && streams && asts && null_fd >= 0;
+    
+    rift_bench_result_t results[RIFT_BENCH_MAX_RESULTS] = {
+        {.name = "config_load"}, {.name = "rift_tokenize"}, {.name = "rift_parse"},
+        {.name = "rift_coordinate_ast"}, {.name = "rift_generate_output"}, {.name = "pipeline"}
+    };
+    size_t result_count = 6;
+    size_t tokens = 0;
+    size_t nodes = 0;
+    size_t folded_nodes = 0;
+    size_t max_depth = 0;
+    
+    if (ok) {
+        tokenizer->trace_tokens = false;
+        output->output_fd = null_fd;
+        output->defer_flush = true;
+        batch.output->output_fd = null_fd;
+        
+        // Untimed preparation: token streams for RIFT-1, and the workload's
+        // token and node counts
+        for (size_t i = 0; ok && i < count; i++) {
+            streams[i] = rift_tokenize(tokenizer, workload.text + workload.offsets[i], workload.lengths[i]);
+            ok = streams[i] != NULL;
+            if (ok) tokens += token_stream_count(streams[i]);
+        }
+        for (size_t i = 0; ok && i < count; i++) {
+            asts[i] = rift_parse(parser, streams[i]);
+            ok = asts[i] != NULL;
+            if (!ok) break;
+            rift_ast_shape_t shape;
+            ok = measure_ast(&coordinator->walk, asts[i], &shape);
+            nodes += shape.nodes;
+            if (shape.depth > max_depth) max_depth = shape.depth;
+        }
+        if (!ok) fprintf(stderr, "Benchmark workload failed to tokenize or parse\n");
+    } else {
+        fprintf(stderr, "Failed to create benchmark stages\n");
+    }
+    
+    printf("\n[BENCH] %zu expressions, %zu tokens, %zu AST nodes (max depth %zu), %zu bytes, seed %llu\n",
+           count, tokens, nodes, max_depth, workload.bytes, (unsigned long long)config.seed);
+    fflush(stdout);
+    
+    for (size_t pass = 0; ok && pass < config.repeat; pass++) {
+        rift_bench_result_t* r = &results[0];
+        if (gov_dir) {
+            rift_bench_resume(r);
+            for (int i = 0; i < RIFT_BENCH_CONFIG_LOADS; i++) {
+                rift_governance_destroy(rift_load_governance(gov_dir, &rift_system_allocator));
+            }
+            rift_bench_pause(r);
+            r->ops += RIFT_BENCH_CONFIG_LOADS;
+        }
+        
+        r = &results[1];
+        rift_bench_resume(r);
+        for (size_t i = 0; i < count; i++) {
+            token_stream_destroy(rift_tokenize(tokenizer, workload.text + workload.offsets[i],
+                                               workload.lengths[i]));
+        }
+        rift_bench_pause(r);
+        r->ops += count;
+        r->bytes += workload.bytes;
+        r->tokens += tokens;
+        
+        r = &results[2];
+        rift_arena_reset(arena);
+        rift_bench_resume(r);
+        for (size_t i = 0; i < count; i++) asts[i] = rift_parse(parser, streams[i]);
+        rift_bench_pause(r);
+        r->ops += count;
+        r->bytes += workload.bytes;
+        r->tokens += tokens;
+        r->nodes += nodes;
+        
+        // Folding rewrites the AST, so this pass works on the fresh parse
+        r = &results[3];
+        folded_nodes = 0;
+        rift_bench_resume(r);
+        for (size_t i = 0; i < count; i++) {
+            rift_ast_coordinator_reset(coordinator);
+            asts[i] = rift_coordinate_ast(coordinator, asts[i]);
+            ok = ok && asts[i] != NULL;
+        }
+        rift_bench_pause(r);
+        for (size_t i = 0; ok && i < count; i++) {
+            rift_ast_shape_t shape;
+            ok = measure_ast(&coordinator->walk, asts[i], &shape);
+            folded_nodes += shape.nodes;
+        }
+        r->ops += count;
+        r->nodes += nodes;
+        
+        r = &results[4];
+        rift_bench_resume(r);
+        for (size_t i = 0; ok && i < count; i++) ok = rift_generate_output(output, asts[i]);
+        ok = rift_output_stage_flush(output) && ok;
+        rift_bench_pause(r);
+        r->ops += count;
+        r->nodes += folded_nodes;
+        
+        r = &results[5];
+        rift_bench_resume(r);
+        for (size_t i = 0; ok && i < count; i++) {
+            ok = rift_batch_process(&batch, workload.text + workload.offsets[i], workload.lengths[i]);
+        }
+        ok = rift_output_stage_flush(batch.output) && ok;
+        rift_bench_pause(r);
+        r->ops += count;
+        r->bytes += workload.bytes;
+        r->tokens += tokens;
+        r->nodes += nodes;
+        
+        if (!ok) fprintf(stderr, "Benchmark output could not be written\n");
+    }
+    
+    if (ok) {
+        for (size_t i = 0; i < result_count; i++) {
+            const rift_bench_result_t* r = &results[i];
+            if (!r->ops) {
+                printf("[BENCH] %-22s failed\n", r->name);
+                continue;
+            }
+            double per_op = (double)r->elapsed_ns / (double)r->ops;
+            printf("[BENCH] %-22s %12.1f ns/op", r->name, per_op);
+            if (r->tokens) printf("  %8.1f ns/token", (double)r->elapsed_ns / (double)r->tokens);
+            if (r->nodes) printf("  %8.1f ns/node", (double)r->elapsed_ns / (double)r->nodes);
+            if (r->bytes) printf("  %8.1f MB/s", (double)r->bytes * 1000.0 / (double)r->elapsed_ns);
+            printf("  %6.2f allocs/op\n", (double)r->allocations / (double)r->ops);
+        }
+        ok = rift_bench_write_json(config.output_path, &config, &workload, tokens, nodes, max_depth,
+                                   results, result_count);
+        if (ok && strcmp(config.output_path, "-") != 0) {
+            printf("[BENCH] Results saved to %s\n", config.output_path);
+        }
+    }
+    
+    rift_stage_logging = true;
+    rift_timing_enabled = timing;
+    
+    if (null_fd >= 0) close(null_fd);
+    rift_batch_release(&batch);
+    for (size_t i = 0; streams && i < count; i++) token_stream_destroy(streams[i]);
+    free(streams);
+    free(asts);
+    rift_output_stage_destroy(output);
+    rift_ast_coordinator_destroy(coordinator);
+    rift_parser_destroy(parser);
+    rift_arena_destroy(arena);
+    rift_tokenizer_destroy(tokenizer);
+    rift_bench_workload_release(&workload);
+    return ok && gov_dir ? 0 : 1;
+}
+
+// ================================
+// Classification Mode
+// --classify CORPUS RESULTS REPEAT; results format in rift_tokenizer_compare.c
+// ================================
+
+static int rift_classify_run(rift_governance_t* governance, const char* corpus_path,
+                             const char* results_path, const char* repeat_text) {
+    size_t repeat;
+    if (!rift_bench_parse_size(repeat_text, &repeat, 1, SIZE_MAX)) {
+        fprintf(stderr, "--classify: invalid repeat count %s\n", repeat_text);
+        return 1;
+    }
+    
+    rift_source_t corpus;
+    if (!rift_source_map_file(&corpus, corpus_path)) {
+        fprintf(stderr, "Failed to map corpus %s\n", corpus_path);
+        return 1;
+    }
+    FILE* results = fopen(results_path, "w");
+    if (!results) {
+        fprintf(stderr, "%s: %s\n", results_path, strerror(errno));
+        rift_source_close(&corpus);
+        return 1;
+    }
+    
+    bool timing = rift_timing_enabled;
+    rift_timing_enabled = false;
+    rift_stage_logging = false;
+    
+    rift_tokenizer_t* tokenizer = rift_tokenizer_create(governance);
+    token_stream_t stream;
+    bool ok = tokenizer && token_stream_init(&stream, tokenizer->allocator, corpus.data, 0, 64);
+    if (ok) {
+        tokenizer->trace_tokens = false;
+        fprintf(results, "E standalone-%s\n", tokenizer->dfa ? "dfa" :
+                tokenizer->lazy_dfa ? "lazy-dfa" : "regex");
+    }
+    
+    for (size_t pass = 0; ok && pass < repeat; pass++) {
+        size_t pos = 0;
+        while (ok && pos < corpus.length) {
+            const char* line = corpus.data + pos;
+            const char* newline = memchr(line, '\n', corpus.length - pos);
+            size_t line_length = newline ? (size_t)(newline - line) : corpus.length - pos;
+            
+            uint64_t start = rift_clock_ns();
+            ok = rift_tokenize_into(tokenizer, &stream, line, line_length);
+            uint64_t elapsed = rift_clock_ns() - start;
+            
+            fprintf(results, "%c %llu\n", pass ? 'R' : 'L', (unsigned long long)elapsed);
+            for (size_t i = 0; ok && pass == 0 && i < token_stream_count(&stream); i++) {
+                fprintf(results, "T %s %.*s\n", token_type_name(token_stream_type(&stream, i)),
+                        (int)token_stream_length(&stream, i), token_stream_text(&stream, i));
+            }
+            pos += line_length + 1;
+        }
+    }
+    
+    if (fclose(results) != 0) ok = false;
+    if (!ok) fprintf(stderr, "--classify: failed to classify %s\n", corpus_path);
+    
+    rift_stage_logging = true;
+    rift_timing_enabled = timing;
+    
+    if (tokenizer) {
+        token_stream_release(&stream);
+        rift_tokenizer_destroy(tokenizer);
+    }
+    rift_source_close(&corpus);
+    return ok ? 0 : 1;
+}
+
+// ================================
+// Main Execution Pipeline
+// OBINexus Framework - Complete RIFT Architecture
+// ================================
+
+int main(int argc, char** argv) {
+    printf("RIFT Complete Pipeline Simulation\n");
+    printf("==================================\n");
+    printf("OBINexus Framework - RIFT Architecture\n");
+    printf("Toolchain: riftlang.exe → .so.a → rift.exe → gosilang\n");
+    printf("Executing RIFT-0 → RIFT-1 → RIFT-2 → RIFT-3\n");
+    
+    // Initialize governance from .rift configuration files
+    uint64_t load_start = rift_clock_ns();
+    rift_governance_t* governance = rift_governance_open(rift_governance_find_dir());
+    if (!governance) {
+        fprintf(stderr, "Failed to load RIFT governance configuration\n");
+        return 1;
+    }
+    
+    // Classify mode times each line itself; stage timers and tracking
+    // allocators would add to those latencies and report over the results
+    if (argc == 5 && strcmp(argv[1], "--classify") == 0) {
+        int status = rift_classify_run(governance, argv[2], argv[3], argv[4]);
+        rift_governance_destroy(governance);
+        return status;
+    }
+    
+    rift_timing_configure(governance);
+    rift_memory_configure(governance);
+    rift_timer_stop(RIFT_TIMER_CONFIG_LOAD, load_start);
+    
+    if (argc > 1 && strcmp(argv[1], "--pipeline") == 0) {
+        int status = rift_pipeline_run(governance, (const char* const*)argv + 2, (size_t)argc - 2);
+        rift_governance_destroy(governance);
+        return status;
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int status = rift_bench_run(governance, argc - 2, argv + 2);
+        rift_governance_destroy(governance);
+        return status;
+    }
+    
+    if (argc > 1 && (strcmp(argv[1], "--batch") == 0 || strcmp(argv[1], "--batch-files") == 0)) {
+        int status = rift_batch_run(governance, (const char* const*)argv + 2, (size_t)argc - 2,
+                                    strcmp(argv[1], "--batch-files") == 0);
+        rift_governance_destroy(governance);
+        return status;
+    }
+    
+    // Input: a source file if given, otherwise the test expression
+    rift_source_t source = {"x + 2 * y", strlen("x + 2 * y"), false};
+    if (argc > 1) {
+        if (!rift_source_map_file(&source, argv[1])) {
+            fprintf(stderr, "Failed to map input file %s\n", argv[1]);
+            rift_governance_destroy(governance);
+            return 1;
+        }
+        printf("\nProcessing input file: %s (%zu bytes%s)\n", argv[1], source.length,
+               source.mapped ? ", memory-mapped" : "");
+    } else {
+        printf("\nProcessing input: \"%s\"\n", source.data);
+    }
+    
+    // RIFT-0: Tokenization Stage
+    rift_tokenizer_t* tokenizer = rift_tokenizer_create(governance);
+    if (!tokenizer) {
+        fprintf(stderr, "Failed to create tokenizer\n");
+        rift_source_close(&source);
+        rift_governance_destroy(governance);
         return 1;
     }
+    tokenizer->trace_tokens = !source.mapped;
     
-    // RIFT-1: Parser Bridge Stage
-    rift_parser_t* parser = rift_parser_create(governance);
+    token_stream_t* tokens = rift_tokenize(tokenizer, source.data, source.length);
+    if (!tokens) {
+        fprintf(stderr, "Failed to tokenize input\n");
+        rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
+        rift_governance_destroy(governance);
+        return 1;
+    }
+    
+    // RIFT-1: Parser Bridge Stage; the arena owns the AST for the whole run
+    rift_arena_t* arena = rift_arena_create(RIFT_ARENA_DEFAULT_BLOCK_SIZE,
+                                            rift_governance_allocator(governance, RIFT_MEMORY_RIFT1));
+    rift_parser_t* parser = arena ? rift_parser_create(governance, arena) : NULL;
     if (!parser) {
         fprintf(stderr, "Failed to create parser\n");
+        rift_arena_destroy(arena);
         token_stream_destroy(tokens);
         rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
         rift_governance_destroy(governance);
         return 1;
     }
@@ -596,40 +4604,76 @@ int main(void) {
     if (!ast) {
         fprintf(stderr, "Failed to parse tokens\n");
         rift_parser_destroy(parser);
+        rift_arena_destroy(arena);
         token_stream_destroy(tokens);
         rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
         rift_governance_destroy(governance);
         return 1;
     }
     
     // RIFT-2: AST Coordinator Stage
-    rift_ast_coordinator_t* coordinator = rift_ast_coordinator_create(governance);
+    rift_ast_coordinator_t* coordinator = rift_ast_coordinator_create(governance, arena);
     if (!coordinator) {
         fprintf(stderr, "Failed to create AST coordinator\n");
-        ast_node_destroy(ast);
         rift_parser_destroy(parser);
+        rift_arena_destroy(arena);
         token_stream_destroy(tokens);
         rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
         rift_governance_destroy(governance);
         return 1;
     }
     
     ast_node_t* coordinated_ast = rift_coordinate_ast(coordinator, ast);
+    if (!coordinated_ast) {
+        rift_ast_coordinator_destroy(coordinator);
+        rift_parser_destroy(parser);
+        rift_arena_destroy(arena);
+        token_stream_destroy(tokens);
+        rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
+        rift_governance_destroy(governance);
+        return 1;
+    }
     
     // RIFT-3: Output Stage
     rift_output_stage_t* output_stage = rift_output_stage_create(governance);
     if (!output_stage) {
         fprintf(stderr, "Failed to create output stage\n");
         rift_ast_coordinator_destroy(coordinator);
-        ast_node_destroy(ast);
         rift_parser_destroy(parser);
+        rift_arena_destroy(arena);
         token_stream_destroy(tokens);
         rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
         rift_governance_destroy(governance);
         return 1;
     }
     
-    rift_generate_output(output_stage, coordinated_ast);
+    // Optional second argument: write the rendered AST to this file
+    if (argc > 2) {
+        output_stage->output_fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output_stage->output_fd < 0) {
+            fprintf(stderr, "Failed to open output file %s\n", argv[2]);
+            output_stage->output_fd = STDOUT_FILENO;
+        }
+    }
+    
+    bool output_ok = rift_generate_output(output_stage, coordinated_ast);
+    if (output_stage->output_fd != STDOUT_FILENO) close(output_stage->output_fd);
+    if (!output_ok) {
+        fprintf(stderr, "Failed to write output\n");
+        rift_output_stage_destroy(output_stage);
+        rift_ast_coordinator_destroy(coordinator);
+        rift_parser_destroy(parser);
+        rift_arena_destroy(arena);
+        token_stream_destroy(tokens);
+        rift_tokenizer_destroy(tokenizer);
+        rift_source_close(&source);
+        rift_governance_destroy(governance);
+        return 1;
+    }
     
     printf("\n[PIPELINE] Complete RIFT execution successful\n");
     printf("[PIPELINE] All stages executed with SP alignment\n");
@@ -639,9 +4683,10 @@ int main(void) {
     rift_output_stage_destroy(output_stage);
     rift_ast_coordinator_destroy(coordinator);
     rift_parser_destroy(parser);
-    ast_node_destroy(ast);
+    rift_arena_destroy(arena);
     token_stream_destroy(tokens);
     rift_tokenizer_destroy(tokenizer);
+    rift_source_close(&source);
     rift_governance_destroy(governance);
     
     return 0;
@@ -0,0 +1,486 @@
+// ================================
+// RIFT Tokenizer Comparison Benchmark
+// OBINexus Framework - RIFT-0 engines side by side
+// Runs every tokenizer implementation over the same corpus, checks that
+// they classify it identically and reports throughput and latency for each
+// ================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// ================================
+// Usage
+// rift_tokenizer_compare [--seed N] [--expressions N] [--operands N]
+//                        [--vocabulary N] [--numbers PERCENT] [--operators STR]
+//                        [--corpus FILE] [--repeat N] [--output FILE|-]
+//                        [--engine NAME=COMMAND]...
+//
+// The corpus is either FILE or a seeded workload in the shape of
+// rift_sim_standalone --bench, one expression per line with whitespace
+// between lexemes, so whole-token and streaming tokenizers see the same
+// lexemes. Each engine is run through /bin/sh as
+//     COMMAND --classify CORPUS RESULTS REPEAT
+// with stdout discarded, and writes RESULTS as lines of
+//     E <engine label>        once, first
+//     L <ns>                  latency of one corpus line, first pass
+//     T <TYPE> <lexeme>       its tokens, whitespace dropped
+//     R <ns>                  latency of one corpus line, later passes
+// Any new engine is compared by implementing that mode. Without --engine
+// the four in-tree tokenizers are run from gov-process/; the first engine
+// is the reference for classifications and speedups.
+// ================================
+
+#define COMPARE_MAX_ENGINES 16
+#define COMPARE_MAX_REPORTED 3    // Mismatched lines printed per engine
+#define COMPARE_MAX_OPERAND 24    // "v" + 20 digits + " op "
+
+typedef struct {
+    const char* name;
+    const char* command;
+} compare_engine_spec_t;
+
+typedef struct {
+    uint64_t seed;
+    size_t expressions;
+    size_t operands;
+    size_t vocabulary;
+    size_t number_percent;
+    const char* operators;
+    const char* corpus_path;       // NULL: generate one
+    size_t repeat;
+    const char* output_path;       // "-" for stdout
+    compare_engine_spec_t engines[COMPARE_MAX_ENGINES];
+    size_t engine_count;
+} compare_config_t;
+
+typedef struct {
+    const char* type;
+    const char* lexeme;
+} compare_token_t;
+
+typedef struct {
+    const char* name;
+    char* results;                 // Results file text, split in place
+    const char* label;             // From the E line
+    compare_token_t* tokens;
+    size_t token_count;
+    size_t* line_tokens;           // First token of every line, plus an end marker
+    size_t line_count;
+    uint64_t* samples;             // Per-line latencies, every pass
+    size_t sample_count;
+    uint64_t total_ns;
+    size_t mismatched_lines;
+    bool ran;
+} compare_engine_t;
+
+static const compare_engine_spec_t compare_default_engines[] = {
+    {"librift-regex", "./tokenziation"},
+    {"poc-automaton", "./rift_poc"},
+    {"standalone", "./rift_sim_standalone"},
+    {"staged", "RIFT_GOV_DIR=../gov-stage/rift-gov ../gov-stage/rift-gov/rift_sim_staged"}
+};
+
+// xorshift64*, as in rift_sim_standalone's workload generator
+static uint64_t compare_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static bool compare_write_corpus(const compare_config_t* config, const char* path) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    
+    uint64_t state = config->seed ^ 0x9E3779B97F4A7C15ULL;
+    if (state == 0) state = 1;
+    size_t operator_count = strlen(config->operators);
+    
+    for (size_t e = 0; e < config->expressions; e++) {
+        for (size_t o = 0; o < config->operands; o++) {
+            uint64_t r = compare_random(&state);
+            if (o > 0) fprintf(out, " %c ", config->operators[(r >> 48) % operator_count]);
+            if (r % 100 < config->number_percent) {
+                fprintf(out, "%u", (unsigned)(r >> 8) % 10000);
+            } else {
+                fprintf(out, "v%zu", (size_t)((r >> 8) % config->vocabulary));
+            }
+        }
+        fputc('\n', out);
+    }
+    
+    bool ok = !ferror(out);
+    return fclose(out) == 0 && ok;
+}
+
+static char* compare_read_file(const char* path, size_t* length) {
+    FILE* in = fopen(path, "r");
+    if (!in) return NULL;
+    
+    char* text = NULL;
+    long size = fseek(in, 0, SEEK_END) == 0 ? ftell(in) : -1;
+    if (size >= 0 && fseek(in, 0, SEEK_SET) == 0) {
+        text = malloc((size_t)size + 1);
+        if (text && fread(text, 1, (size_t)size, in) != (size_t)size) {
+            free(text);
+            text = NULL;
+        }
+    }
+    fclose(in);
+    
+    if (text) {
+        text[size] = '\0';
+        *length = (size_t)size;
+    }
+    return text;
+}
+
+// Splits the results text in place into tokens, line boundaries and samples
+static bool compare_parse_results(compare_engine_t* engine, size_t length) {
+    size_t lines = 1;
+    for (size_t i = 0; i < length; i++) lines += engine->results[i] == '\n';
+    
+    engine->tokens = malloc(sizeof(compare_token_t) * lines);
+    engine->line_tokens = malloc(sizeof(size_t) * (lines + 1));
+    engine->samples = malloc(sizeof(uint64_t) * lines);
+    if (!engine->tokens || !engine->line_tokens || !engine->samples) return false;
+    
+    char* cursor = engine->results;
+    while (*cursor) {
+        char* line = cursor;
+        char* newline = strchr(line, '\n');
+        if (newline) *newline = '\0';
+        cursor = newline ? newline + 1 : line + strlen(line);
+        
+        char tag = line[0];
+        if (tag == '\0') continue;
+        if (line[1] != ' ') return false;
+        char* field = line + 2;
+        
+        if (tag == 'E') {
+            engine->label = field;
+        } else if (tag == 'L' || tag == 'R') {
+            engine->samples[engine->sample_count++] = strtoull(field, NULL, 10);
+            engine->total_ns += engine->samples[engine->sample_count - 1];
+            if (tag == 'L') engine->line_tokens[engine->line_count++] = engine->token_count;
+        } else if (tag == 'T' && engine->line_count > 0) {
+            char* space = strchr(field, ' ');
+            if (!space) return false;
+            *space = '\0';
+            engine->tokens[engine->token_count++] = (compare_token_t){field, space + 1};
+        } else {
+            return false;
+        }
+    }
+    
+    engine->line_tokens[engine->line_count] = engine->token_count;
+    return engine->label != NULL;
+}
+
+static bool compare_run_engine(compare_engine_t* engine, const char* command, const char* corpus_path,
+                               const char* results_path, size_t repeat) {
+    size_t size = strlen(command) + strlen(corpus_path) + strlen(results_path) + 64;
+    char* shell_command = malloc(size);
+    if (!shell_command) return false;
+    snprintf(shell_command, size, "%s --classify '%s' '%s' %zu >/dev/null",
+             command, corpus_path, results_path, repeat);
+    
+    remove(results_path);
+    int status = system(shell_command);
+    free(shell_command);
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "[COMPARE] %s: engine failed (status %d); does it support --classify?\n",
+                engine->name, status == -1 ? -1 : WIFEXITED(status) ? WEXITSTATUS(status) : 128);
+        return false;
+    }
+    
+    size_t length = 0;
+    engine->results = compare_read_file(results_path, &length);
+    if (!engine->results || !compare_parse_results(engine, length)) {
+        fprintf(stderr, "[COMPARE] %s: malformed results in %s\n", engine->name, results_path);
+        return false;
+    }
+    return true;
+}
+
+static bool compare_token_equal(const compare_token_t* a, const compare_token_t* b) {
+    return strcmp(a->type, b->type) == 0 && strcmp(a->lexeme, b->lexeme) == 0;
+}
+
+// Counts the lines engine classifies differently from reference, printing
+// the first token that differs on the first few
+static void compare_classifications(const compare_engine_t* reference, compare_engine_t* engine) {
+    if (engine->line_count != reference->line_count) {
+        printf("[COMPARE] %s: %zu lines, reference %s has %zu\n", engine->name,
+               engine->line_count, reference->name, reference->line_count);
+    }
+    
+    size_t lines = engine->line_count < reference->line_count ? engine->line_count : reference->line_count;
+    for (size_t l = 0; l < lines; l++) {
+        const compare_token_t* a = reference->tokens + reference->line_tokens[l];
+        const compare_token_t* b = engine->tokens + engine->line_tokens[l];
+        size_t a_count = reference->line_tokens[l + 1] - reference->line_tokens[l];
+        size_t b_count = engine->line_tokens[l + 1] - engine->line_tokens[l];
+        
+        size_t t = 0;
+        while (t < a_count && t < b_count && compare_token_equal(&a[t], &b[t])) t++;
+        if (t == a_count && t == b_count) continue;
+        
+        if (++engine->mismatched_lines <= COMPARE_MAX_REPORTED) {
+            printf("[COMPARE] %s: line %zu token %zu: %s '%s', reference %s '%s'\n",
+                   engine->name, l + 1, t + 1,
+                   t < b_count ? b[t].type : "(end)", t < b_count ? b[t].lexeme : "",
+                   t < a_count ? a[t].type : "(end)", t < a_count ? a[t].lexeme : "");
+        }
+    }
+    engine->mismatched_lines += engine->line_count > lines ? engine->line_count - lines : 0;
+    engine->mismatched_lines += reference->line_count > lines ? reference->line_count - lines : 0;
+}
+
+static int compare_samples(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank quantile of sorted samples
+static uint64_t compare_quantile(const compare_engine_t* engine, double q) {
+    if (engine->sample_count == 0) return 0;
+    size_t rank = (size_t)(q * (double)engine->sample_count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > engine->sample_count) rank = engine->sample_count;
+    return engine->samples[rank - 1];
+}
+
+static double compare_passes(const compare_engine_t* engine) {
+    return engine->line_count ? (double)engine->sample_count / (double)engine->line_count : 0.0;
+}
+
+static bool compare_write_json(const compare_config_t* config, size_t bytes,
+                               const compare_engine_t* engines, size_t engine_count,
+                               const compare_engine_t* reference) {
+    FILE* out = strcmp(config->output_path, "-") == 0 ? stdout : fopen(config->output_path, "w");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", config->output_path, strerror(errno));
+        return false;
+    }
+    
+    fprintf(out, "{\"rift_bench\":{\"workload\":{\"seed\":%llu,\"expressions\":%zu,\"operands\":%zu,"
+            "\"operators\":\"%s\",\"vocabulary\":%zu,\"number_percent\":%zu,\"repeat\":%zu,"
+            "\"bytes\":%zu,\"corpus\":",
+            (unsigned long long)config->seed, config->expressions, config->operands,
+            config->operators, config->vocabulary, config->number_percent, config->repeat, bytes);
+    if (config->corpus_path) fprintf(out, "\"%s\"", config->corpus_path);
+    else fprintf(out, "null");
+    fprintf(out, ",\"reference\":\"%s\"},\n\"results\":[", reference ? reference->name : "");
+    
+    bool first = true;
+    for (size_t i = 0; i < engine_count; i++) {
+        const compare_engine_t* e = &engines[i];
+        if (!e->ran) continue;
+        
+        double passes = compare_passes(e);
+        double ns = (double)e->total_ns;
+        fprintf(out, "%s\n{\"name\":\"%s\",\"engine\":\"%s\",\"ops\":%zu,\"total_ns\":%llu,"
+                "\"ns_per_op\":%.3f,\"ns_per_token\":",
+                first ? "" : ",", e->name, e->label, e->sample_count,
+                (unsigned long long)e->total_ns, e->sample_count ? ns / (double)e->sample_count : 0.0);
+        if (e->token_count) fprintf(out, "%.3f", ns / ((double)e->token_count * passes));
+        else fprintf(out, "null");
+        fprintf(out, ",\"ns_per_node\":null,\"mb_per_s\":%.3f,\"allocations_per_op\":null,"
+                "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,"
+                "\"speedup\":%.3f,\"mismatched_lines\":%zu}",
+                e->total_ns ? (double)bytes * passes * 1000.0 / ns : 0.0,
+                (unsigned long long)compare_quantile(e, 0.50),
+                (unsigned long long)compare_quantile(e, 0.90),
+                (unsigned long long)compare_quantile(e, 0.99),
+                (unsigned long long)compare_quantile(e, 1.0),
+                e->total_ns ? (double)reference->total_ns / ns : 0.0, e->mismatched_lines);
+        first = false;
+    }
+    fprintf(out, "\n]}}\n");
+    
+    bool ok = !ferror(out);
+    if (out != stdout) ok = fclose(out) == 0 && ok;
+    else fflush(out);
+    return ok;
+}
+
+static bool compare_parse_size(const char* text, size_t* value, size_t min, size_t max) {
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno || end == text || *end != '\0' || parsed < min || parsed > max) return false;
+    *value = (size_t)parsed;
+    return true;
+}
+
+static bool compare_parse_args(compare_config_t* config, int argc, char** argv) {
+    for (int i = 0; i < argc; i++) {
+        const char* option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        size_t parsed = 0;
+        bool ok = value != NULL;
+        
+        if (ok && strcmp(option, "--seed") == 0) {
+            ok = compare_parse_size(value, &parsed, 0, SIZE_MAX);
+            config->seed = parsed;
+        } else if (ok && strcmp(option, "--expressions") == 0) {
+            ok = compare_parse_size(value, &config->expressions, 1, SIZE_MAX / 2);
+        } else if (ok && strcmp(option, "--operands") == 0) {
+            ok = compare_parse_size(value, &config->operands, 1, SIZE_MAX / COMPARE_MAX_OPERAND);
+        } else if (ok && strcmp(option, "--vocabulary") == 0) {
+            ok = compare_parse_size(value, &config->vocabulary, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--numbers") == 0) {
+            ok = compare_parse_size(value, &config->number_percent, 0, 100);
+        } else if (ok && strcmp(option, "--repeat") == 0) {
+            ok = compare_parse_size(value, &config->repeat, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--operators") == 0) {
+            config->operators = value;
+            ok = *value != '\0' && strpbrk(value, " \t\r\n'") == NULL;
+        } else if (ok && strcmp(option, "--corpus") == 0) {
+            config->corpus_path = value;
+            ok = strchr(value, '\'') == NULL;
+        } else if (ok && strcmp(option, "--output") == 0) {
+            config->output_path = value;
+        } else if (ok && strcmp(option, "--engine") == 0) {
+            // NAME=COMMAND; the name is kept up to the '='
+            char* separator = strchr(argv[i + 1], '=');
+            ok = separator && separator != value && config->engine_count < COMPARE_MAX_ENGINES;
+            if (ok) {
+                *separator = '\0';
+                config->engines[config->engine_count++] = (compare_engine_spec_t){value, separator + 1};
+            }
+        } else {
+            ok = false;
+        }
+        
+        if (!ok) {
+            fprintf(stderr, "rift_tokenizer_compare: invalid option %s%s%s\n", option,
+                    value ? " " : "", value ? value : "");
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    printf("RIFT Tokenizer Comparison Benchmark\n");
+    printf("===================================\n");
+    
+    compare_config_t config = {
+        .seed = 1, .expressions = 2000, .operands = 8, .vocabulary = 64, .number_percent = 30,
+        .operators = "+-*/", .repeat = 5, .output_path = "rift_tokenizer_compare.json"
+    };
+    if (!compare_parse_args(&config, argc - 1, argv + 1)) return 1;
+    if (config.engine_count == 0) {
+        config.engine_count = sizeof(compare_default_engines) / sizeof(compare_default_engines[0]);
+        memcpy(config.engines, compare_default_engines, sizeof(compare_default_engines));
+    }
+    
+    char directory[] = "/tmp/rift-compare-XXXXXX";
+    if (!mkdtemp(directory)) {
+        fprintf(stderr, "mkdtemp: %s\n", strerror(errno));
+        return 1;
+    }
+    
+    char generated_path[sizeof(directory) + 16];
+    snprintf(generated_path, sizeof(generated_path), "%s/corpus.txt", directory);
+    const char* corpus_path = config.corpus_path ? config.corpus_path : generated_path;
+    bool ok = config.corpus_path || compare_write_corpus(&config, generated_path);
+    
+    // Corpus bytes per pass, newlines excluded
+    size_t bytes = 0;
+    size_t corpus_length = 0;
+    char* corpus = ok ? compare_read_file(corpus_path, &corpus_length) : NULL;
+    ok = corpus != NULL;
+    for (size_t i = 0; i < corpus_length; i++) bytes += corpus[i] != '\n';
+    free(corpus);
+    if (!ok) fprintf(stderr, "Failed to prepare corpus %s\n", corpus_path);
+    
+    compare_engine_t engines[COMPARE_MAX_ENGINES] = {{0}};
+    compare_engine_t* reference = NULL;
+    size_t failures = 0;
+    
+    for (size_t i = 0; ok && i < config.engine_count; i++) {
+        compare_engine_t* engine = &engines[i];
+        engine->name = config.engines[i].name;
+        
+        char results_path[sizeof(directory) + 32];
+        snprintf(results_path, sizeof(results_path), "%s/engine%zu.results", directory, i);
+        printf("[COMPARE] Running %s: %s\n", engine->name, config.engines[i].command);
+        fflush(stdout);
+        
+        engine->ran = compare_run_engine(engine, config.engines[i].command, corpus_path,
+                                         results_path, config.repeat);
+        remove(results_path);
+        if (!engine->ran) {
+            failures++;
+            continue;
+        }
+        
+        if (!reference) reference = engine;
+        else compare_classifications(reference, engine);
+    }
+    
+    remove(generated_path);
+    rmdir(directory);
+    
+    if (ok && reference) {
+        printf("\n[BENCH] %zu lines, %zu tokens, %zu bytes, %zu passes, reference %s\n",
+               reference->line_count, reference->token_count, bytes, config.repeat, reference->name);
+        printf("[BENCH] %-14s %-18s %10s %10s %9s %9s %9s %9s %9s %8s\n", "engine", "label",
+               "ns/token", "MB/s", "p50 ns", "p90 ns", "p99 ns", "max ns", "speedup", "match");
+        
+        for (size_t i = 0; i < config.engine_count; i++) {
+            compare_engine_t* e = &engines[i];
+            if (!e->ran) continue;
+            
+            qsort(e->samples, e->sample_count, sizeof(uint64_t), compare_samples);
+            double passes = compare_passes(e);
+            double ns = e->total_ns ? (double)e->total_ns : 1.0;
+            printf("[BENCH] %-14s %-18s %10.1f %10.2f %9llu %9llu %9llu %9llu %8.2fx %8s\n",
+                   e->name, e->label,
+                   e->token_count ? ns / ((double)e->token_count * passes) : 0.0,
+                   (double)bytes * passes * 1000.0 / ns,
+                   (unsigned long long)compare_quantile(e, 0.50),
+                   (unsigned long long)compare_quantile(e, 0.90),
+                   (unsigned long long)compare_quantile(e, 0.99),
+                   (unsigned long long)compare_quantile(e, 1.0),
+                   (double)reference->total_ns / ns,
+                   e == reference ? "ref" : e->mismatched_lines ? "DIFFERS" : "yes");
+        }
+        
+        ok = compare_write_json(&config, bytes, engines, config.engine_count, reference);
+        if (ok && strcmp(config.output_path, "-") != 0) {
+            printf("[BENCH] Results saved to %s\n", config.output_path);
+        }
+    } else if (ok) {
+        fprintf(stderr, "No engine produced results\n");
+        ok = false;
+    }
+    
+    size_t mismatches = 0;
+    for (size_t i = 0; i < config.engine_count; i++) {
+        mismatches += engines[i].mismatched_lines != 0;
+        free(engines[i].results);
+        free(engines[i].tokens);
+        free(engines[i].line_tokens);
+        free(engines[i].samples);
+    }
+    if (mismatches) printf("[COMPARE] %zu engine(s) classify the corpus differently\n", mismatches);
+    
+    return ok && failures == 0 && mismatches == 0 ? 0 : 1;
+}
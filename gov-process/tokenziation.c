@@ -1,8 +1,10 @@
 #include <regex.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 // State structure for the regex automaton
 typedef struct State {
@@ -57,17 +59,65 @@ state_matches(State *state, const char *text)
     return (result == 0);
 }
 
+// Token classes in the order they are tried; the labels are the type names
+// every tokenizer reports in --classify mode
+static const char *token_type_names[] = {"IDENTIFIER", "NUMBER", "OPERATOR"};
+#define TOKEN_TYPE_COUNT (sizeof(token_type_names) / sizeof(token_type_names[0]))
+
+// Creates the token patterns for a simple language, one per token class
+static bool
+create_token_states(State *states[TOKEN_TYPE_COUNT])
+{
+    // POSIX ERE has no \d, and a backslash in a bracket is literal
+    states[0] = state_create("^[a-zA-Z_]\\w*$", false);
+    states[1] = state_create("^[0-9]+$", false);
+    states[2] = state_create("^[-+*/]$", false);
+
+    for (size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        if (!states[i])
+            return false;
+    }
+    return true;
+}
+
+static void
+destroy_token_states(State *states[TOKEN_TYPE_COUNT])
+{
+    for (size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        if (states[i]) {
+            free(states[i]->pattern);
+            free(states[i]);
+        }
+    }
+}
+
+// Index of the first token class matching token, or -1 for Unknown
+static int
+classify_token(State *states[TOKEN_TYPE_COUNT], const char *token)
+{
+    for (size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        if (state_matches(states[i], token))
+            return (int)i;
+    }
+    return -1;
+}
+
 // Demo of LibRift's language processing capabilities
 void
 demonstrate_librift_tokenization()
 {
+    static const char *labels[] = {"Identifier", "Number", "Operator"};
+
     printf("LibRift Demonstration: Regex-Based Language Tokenization\n");
     printf("-----------------------------------------------------\n");
 
     // Define token patterns for a simple language
-    State *identifier = state_create("^[a-zA-Z_]\\w*$", false);
-    State *number = state_create("^\\d+$", false);
-    State *operator= state_create("^[+\\-*/]$", false);
+    State *states[TOKEN_TYPE_COUNT] = {NULL};
+    if (!create_token_states(states)) {
+        printf("Failed to create token states\n");
+        destroy_token_states(states);
+        return;
+    }
 
     // Test tokens to demonstrate tokenization
     const char *tokens[] = {"x", "+", "123", "*", "y", "42"};
@@ -78,33 +128,124 @@ demonstrate_librift_tokenization()
         const char *token = tokens[i];
 
         // Determine token type
-        State *matching_state = NULL;
-        if (state_matches(identifier, token)) {
-            matching_state = identifier;
-            printf("Token: %-5s | Type: Identifier\n", token);
-        } else if (state_matches(number, token)) {
-            matching_state = number;
-            printf("Token: %-5s | Type: Number\n", token);
-        } else if (state_matches(operator, token)) {
-            matching_state = operator;
-            printf("Token: %-5s | Type: Operator\n", token);
-        } else {
-            printf("Token: %-5s | Type: Unknown\n", token);
-        }
+        int type = classify_token(states, token);
+        printf("Token: %-5s | Type: %s\n", token, type >= 0 ? labels[type] : "Unknown");
     }
 
     // Clean up
-    free(identifier->pattern);
-    free(identifier);
-    free(number->pattern);
-    free(number);
-    free(operator->pattern);
-    free(operator);
+    destroy_token_states(states);
+}
+
+static uint64_t
+clock_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static bool
+is_lexeme_separator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// One classified lexeme of the current corpus line
+typedef struct {
+    size_t start;
+    size_t length;
+    int type;                   // Index into token_type_names, -1 if unmatched
+} ClassifiedLexeme;
+
+// --classify CORPUS RESULTS REPEAT; results format in rift_tokenizer_compare.c
+static int
+classify_corpus(const char *corpus_path, const char *results_path, const char *repeat_text)
+{
+    char *end;
+    unsigned long repeat = strtoul(repeat_text, &end, 10);
+    if (*end != '\0' || repeat == 0) {
+        fprintf(stderr, "--classify: invalid repeat count %s\n", repeat_text);
+        return 1;
+    }
+
+    FILE *corpus = fopen(corpus_path, "r");
+    if (!corpus) {
+        perror(corpus_path);
+        return 1;
+    }
+    FILE *results = fopen(results_path, "w");
+    if (!results) {
+        perror(results_path);
+        fclose(corpus);
+        return 1;
+    }
+
+    // The whole corpus is read up front so no pass includes I/O
+    State *states[TOKEN_TYPE_COUNT] = {NULL};
+    bool ok = create_token_states(states) && fseek(corpus, 0, SEEK_END) == 0;
+    long size = ok ? ftell(corpus) : -1;
+    size_t length = size > 0 ? (size_t)size : 0;
+    char *text = size >= 0 ? malloc(length + 1) : NULL;
+    ok = text && fseek(corpus, 0, SEEK_SET) == 0 && fread(text, 1, length, corpus) == length;
+
+    char *scratch = ok ? malloc(length + 1) : NULL;  // One lexeme, NUL-terminated
+    ClassifiedLexeme *lexemes = ok ? malloc(sizeof(ClassifiedLexeme) * (length / 2 + 1)) : NULL;
+    ok = scratch && lexemes;
+
+    fprintf(results, "E librift-regex\n");
+    for (unsigned long pass = 0; ok && pass < repeat; pass++) {
+        size_t pos = 0;
+        while (pos < length) {
+            size_t line_end = pos;
+            while (line_end < length && text[line_end] != '\n')
+                line_end++;
+
+            size_t count = 0;
+            uint64_t start = clock_ns();
+            for (size_t i = pos; i < line_end;) {
+                if (is_lexeme_separator(text[i])) {
+                    i++;
+                    continue;
+                }
+                size_t j = i;
+                while (j < line_end && !is_lexeme_separator(text[j]))
+                    j++;
+                memcpy(scratch, text + i, j - i);
+                scratch[j - i] = '\0';
+                lexemes[count++] = (ClassifiedLexeme){i, j - i, classify_token(states, scratch)};
+                i = j;
+            }
+            uint64_t elapsed = clock_ns() - start;
+
+            fprintf(results, "%c %llu\n", pass ? 'R' : 'L', (unsigned long long)elapsed);
+            for (size_t t = 0; pass == 0 && t < count; t++) {
+                const ClassifiedLexeme *lexeme = &lexemes[t];
+                fprintf(results, "T %s %.*s\n",
+                        lexeme->type >= 0 ? token_type_names[lexeme->type] : "UNKNOWN",
+                        (int)lexeme->length, text + lexeme->start);
+            }
+            pos = line_end + 1;
+        }
+    }
+
+    if (fclose(results) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "--classify: failed to classify %s\n", corpus_path);
+    fclose(corpus);
+    free(lexemes);
+    free(scratch);
+    free(text);
+    destroy_token_states(states);
+    return ok ? 0 : 1;
 }
 
 int
-main()
+main(int argc, char **argv)
 {
+    if (argc == 5 && strcmp(argv[1], "--classify") == 0)
+        return classify_corpus(argv[2], argv[3], argv[4]);
+
     demonstrate_librift_tokenization();
     return 0;
-}
\ No newline at end of file
+}
@@ -7,24 +7,66 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
 
 // ================================
 // Escape Sequence Mapping Types
 // ================================
 
+// Interned encoding_context IDs. The built-in layers are registered first
+// so their IDs, and the order their tables are built in, never change.
+enum {
+    ESCAPE_CONTEXT_GENERAL = 0,
+    ESCAPE_CONTEXT_CONFIG_TO_C,
+    ESCAPE_CONTEXT_C_TO_REGEX,
+    ESCAPE_CONTEXT_RAW_STRING,
+    ESCAPE_CONTEXT_BUILTIN_COUNT
+};
+
+#define ESCAPE_CONTEXT_ANY (-1)     // Apply every mapping regardless of context
+
 typedef struct {
     char* source_sequence;      // Input pattern (e.g., "\\\\w")
     char* target_sequence;      // Output pattern (e.g., "\\w")
     char* fault_token;          // Fallback if transformation fails
     char* encoding_context;     // Which layer this applies to
     int priority;               // Processing order
+    int context_id;             // Interned encoding_context
 } escape_mapping_t;
 
+typedef struct {
+    int next[256];              // Goto function with failure links folded in
+    int fail;                   // Longest proper suffix state (build only)
+    int match;                  // Mapping whose source ends here, or ESCAPE_NO_MATCH
+    int output_link;            // Nearest suffix state that also ends a mapping
+} escape_ac_state_t;
+
+typedef struct {
+    escape_ac_state_t* states;
+    size_t state_count;
+    size_t* mapping_ids;        // Automaton-local index -> mapping, by priority
+    size_t* source_lengths;
+    size_t mapping_count;
+    size_t longest_source;      // Width of the pending-match window
+    size_t max_expansion;       // Worst output bytes per input byte
+    size_t fault_capacity;      // Room to list every fault token once
+    int* window;                // Best match per pending start (scratch)
+    bool* applied;              // Mappings hit during the current pass (scratch)
+} escape_automaton_t;
+
 typedef struct {
     escape_mapping_t* mappings;
     size_t count;
     size_t capacity;
     char* default_fault_token;  // Universal fallback
+    char** context_names;       // Interned encoding_context strings, by ID
+    size_t context_count;
+    size_t context_capacity;
+    escape_automaton_t* automata;  // One per context ID, then ESCAPE_CONTEXT_ANY
+    size_t automaton_count;
+    bool compiled;
 } escape_processor_t;
 
 typedef struct {
@@ -34,10 +76,282 @@ typedef struct {
     int transformations_applied;
 } pattern_result_t;
 
+// ================================
+// Multi-Pattern Escape Automaton
+// ================================
+
+#define ESCAPE_NO_MATCH (-1)
+
+static void escape_automaton_release(escape_automaton_t* automaton) {
+    free(automaton->states);
+    free(automaton->mapping_ids);
+    free(automaton->source_lengths);
+    free(automaton->window);
+    free(automaton->applied);
+    memset(automaton, 0, sizeof(*automaton));
+}
+
+static void escape_processor_release_automata(escape_processor_t* processor) {
+    for (size_t i = 0; i < processor->automaton_count; i++) {
+        escape_automaton_release(&processor->automata[i]);
+    }
+    free(processor->automata);
+    processor->automata = NULL;
+    processor->automaton_count = 0;
+    processor->compiled = false;
+}
+
+static bool escape_mapping_in_context(const escape_mapping_t* mapping, int context_id) {
+    return context_id == ESCAPE_CONTEXT_ANY ||
+           mapping->context_id == context_id ||
+           mapping->context_id == ESCAPE_CONTEXT_GENERAL;
+}
+
+// Decides between two mappings matching at the same input position:
+// higher priority first, then the longer source, then table order.
+static bool escape_mapping_wins(const escape_processor_t* processor,
+                                const escape_automaton_t* automaton,
+                                int candidate, int current) {
+    const escape_mapping_t* a = &processor->mappings[automaton->mapping_ids[candidate]];
+    const escape_mapping_t* b = &processor->mappings[automaton->mapping_ids[current]];
+    
+    if (a->priority != b->priority) return a->priority > b->priority;
+    if (automaton->source_lengths[candidate] != automaton->source_lengths[current]) {
+        return automaton->source_lengths[candidate] > automaton->source_lengths[current];
+    }
+    return candidate < current;
+}
+
+static int escape_automaton_add_state(escape_automaton_t* automaton, size_t* capacity) {
+    if (automaton->state_count >= *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 16;
+        escape_ac_state_t* new_states = realloc(automaton->states,
+                                                sizeof(escape_ac_state_t) * new_capacity);
+        if (!new_states) return ESCAPE_NO_MATCH;
+        automaton->states = new_states;
+        *capacity = new_capacity;
+    }
+    
+    escape_ac_state_t* state = &automaton->states[automaton->state_count];
+    memset(state->next, 0, sizeof(state->next));
+    state->fail = 0;
+    state->match = ESCAPE_NO_MATCH;
+    state->output_link = 0;
+    return (int)automaton->state_count++;
+}
+
+// Builds the table for one context from `order`, every mapping index
+// already sorted by priority, so the table inherits that order.
+static bool escape_automaton_build(escape_automaton_t* automaton,
+                                   const escape_processor_t* processor,
+                                   const size_t* order,
+                                   int context_id) {
+    memset(automaton, 0, sizeof(*automaton));
+    automaton->max_expansion = 1;
+    
+    automaton->mapping_ids = malloc(sizeof(size_t) * (processor->count + 1));
+    automaton->source_lengths = malloc(sizeof(size_t) * (processor->count + 1));
+    automaton->applied = calloc(processor->count + 1, sizeof(bool));
+    if (!automaton->mapping_ids || !automaton->source_lengths || !automaton->applied) {
+        escape_automaton_release(automaton);
+        return false;
+    }
+    
+    size_t state_capacity = 0;
+    if (escape_automaton_add_state(automaton, &state_capacity) == ESCAPE_NO_MATCH) {
+        escape_automaton_release(automaton);
+        return false;
+    }
+    
+    // Trie of every source sequence visible from this context
+    for (size_t n = 0; n < processor->count; n++) {
+        size_t i = order[n];
+        const escape_mapping_t* mapping = &processor->mappings[i];
+        if (!mapping->source_sequence || !escape_mapping_in_context(mapping, context_id)) {
+            continue;
+        }
+        
+        size_t length = strlen(mapping->source_sequence);
+        if (length == 0) continue;  // An empty source would match everywhere
+        
+        int local = (int)automaton->mapping_count;
+        automaton->mapping_ids[local] = i;
+        automaton->source_lengths[local] = length;
+        automaton->mapping_count++;
+        
+        int state = 0;
+        for (size_t j = 0; j < length; j++) {
+            unsigned char byte = (unsigned char)mapping->source_sequence[j];
+            if (!automaton->states[state].next[byte]) {
+                int child = escape_automaton_add_state(automaton, &state_capacity);
+                if (child == ESCAPE_NO_MATCH) {
+                    escape_automaton_release(automaton);
+                    return false;
+                }
+                automaton->states[state].next[byte] = child;
+            }
+            state = automaton->states[state].next[byte];
+        }
+        
+        int* match = &automaton->states[state].match;
+        if (*match == ESCAPE_NO_MATCH || escape_mapping_wins(processor, automaton, local, *match)) {
+            *match = local;
+        }
+        
+        // Size the output so a pass never has to grow its buffer
+        size_t target_length = mapping->target_sequence ? strlen(mapping->target_sequence) : 0;
+        size_t fault_length = mapping->fault_token ? strlen(mapping->fault_token) : 0;
+        size_t widest = target_length > fault_length ? target_length : fault_length;
+        size_t expansion = (widest + length - 1) / length;
+        if (expansion > automaton->max_expansion) automaton->max_expansion = expansion;
+        if (length > automaton->longest_source) automaton->longest_source = length;
+        automaton->fault_capacity += fault_length + 1;
+    }
+    
+    // Breadth-first failure links, folded into a complete transition table
+    int* queue = malloc(sizeof(int) * automaton->state_count);
+    if (!queue) {
+        escape_automaton_release(automaton);
+        return false;
+    }
+    
+    size_t head = 0;
+    size_t tail = 0;
+    for (int byte = 0; byte < 256; byte++) {
+        int child = automaton->states[0].next[byte];
+        if (child) queue[tail++] = child;
+    }
+    
+    while (head < tail) {
+        int state = queue[head++];
+        escape_ac_state_t* current = &automaton->states[state];
+        
+        for (int byte = 0; byte < 256; byte++) {
+            int child = current->next[byte];
+            int fallback = automaton->states[current->fail].next[byte];
+            
+            if (!child) {
+                current->next[byte] = fallback;
+                continue;
+            }
+            
+            escape_ac_state_t* next = &automaton->states[child];
+            next->fail = fallback;
+            next->output_link = automaton->states[fallback].match != ESCAPE_NO_MATCH ?
+                                fallback : automaton->states[fallback].output_link;
+            queue[tail++] = child;
+        }
+    }
+    free(queue);
+    
+    size_t window_size = automaton->longest_source ? automaton->longest_source : 1;
+    automaton->window = malloc(sizeof(int) * window_size);
+    if (!automaton->window) {
+        escape_automaton_release(automaton);
+        return false;
+    }
+    for (size_t i = 0; i < window_size; i++) automaton->window[i] = ESCAPE_NO_MATCH;
+    
+    return true;
+}
+
+// Precomputes every context's table in one go: mappings are ordered by
+// descending priority (registration order breaks ties) and each context
+// keeps its own mappings plus the "general" ones.
+static bool escape_processor_compile(escape_processor_t* processor) {
+    if (processor->compiled) return true;
+    escape_processor_release_automata(processor);
+    
+    size_t* order = malloc(sizeof(size_t) * (processor->count + 1));
+    if (!order) return false;
+    
+    for (size_t i = 0; i < processor->count; i++) {
+        size_t j = i;
+        while (j > 0 && processor->mappings[order[j - 1]].priority < processor->mappings[i].priority) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    
+    size_t table_count = processor->context_count + 1;
+    processor->automata = calloc(table_count, sizeof(escape_automaton_t));
+    if (!processor->automata) {
+        free(order);
+        return false;
+    }
+    
+    for (size_t id = 0; id < table_count; id++) {
+        int context_id = id < processor->context_count ? (int)id : ESCAPE_CONTEXT_ANY;
+        if (!escape_automaton_build(&processor->automata[id], processor, order, context_id)) {
+            free(order);
+            escape_processor_release_automata(processor);
+            return false;
+        }
+        processor->automaton_count++;
+    }
+    
+    free(order);
+    processor->compiled = true;
+    return true;
+}
+
+static escape_automaton_t* escape_processor_automaton(escape_processor_t* processor,
+                                                      int context_id) {
+    if (!escape_processor_compile(processor)) return NULL;
+    
+    if (context_id == ESCAPE_CONTEXT_ANY) return &processor->automata[processor->context_count];
+    if (context_id < 0 || (size_t)context_id >= processor->context_count) return NULL;
+    return &processor->automata[context_id];
+}
+
 // ================================
 // Escape Processor Implementation
 // ================================
 
+static bool escape_processor_intern_context(escape_processor_t* processor,
+                                            const char* name,
+                                            int* context_id) {
+    for (size_t i = 0; i < processor->context_count; i++) {
+        if (strcmp(processor->context_names[i], name) == 0) {
+            *context_id = (int)i;
+            return true;
+        }
+    }
+    
+    if (processor->context_count >= processor->context_capacity) {
+        size_t new_capacity = processor->context_capacity ? processor->context_capacity * 2 : 8;
+        char** new_names = realloc(processor->context_names, sizeof(char*) * new_capacity);
+        if (!new_names) return false;
+        processor->context_names = new_names;
+        processor->context_capacity = new_capacity;
+    }
+    
+    char* interned = strdup(name);
+    if (!interned) return false;
+    
+    processor->context_names[processor->context_count] = interned;
+    *context_id = (int)processor->context_count++;
+    processor->compiled = false;  // New context needs its own table
+    return true;
+}
+
+// Resolves a context name once so callers can process many patterns by ID.
+// Unknown contexts only see "general" mappings; NULL applies all of them.
+static int escape_processor_context_id(const escape_processor_t* processor, const char* name) {
+    if (!name) return ESCAPE_CONTEXT_ANY;
+    
+    for (size_t i = 0; i < processor->context_count; i++) {
+        if (strcmp(processor->context_names[i], name) == 0) return (int)i;
+    }
+    return ESCAPE_CONTEXT_GENERAL;
+}
+
+static const char* escape_processor_context_name(const escape_processor_t* processor, int context_id) {
+    if (context_id < 0 || (size_t)context_id >= processor->context_count) return "general";
+    return processor->context_names[context_id];
+}
+
 static escape_processor_t* escape_processor_create(void) {
     escape_processor_t* processor = malloc(sizeof(escape_processor_t));
     if (!processor) return NULL;
@@ -46,8 +360,26 @@ static escape_processor_t* escape_processor_create(void) {
     processor->count = 0;
     processor->mappings = malloc(sizeof(escape_mapping_t) * processor->capacity);
     processor->default_fault_token = strdup("[UNKNOWN_ESCAPE]");
+    processor->context_names = NULL;
+    processor->context_count = 0;
+    processor->context_capacity = 0;
+    processor->automata = NULL;
+    processor->automaton_count = 0;
+    processor->compiled = false;
+    
+    // Fixed IDs for the built-in layers, in enum order
+    static const char* builtin_contexts[ESCAPE_CONTEXT_BUILTIN_COUNT] = {
+        "general", "config_to_c", "c_to_regex", "raw_string"
+    };
+    bool contexts_ready = true;
+    for (int i = 0; i < ESCAPE_CONTEXT_BUILTIN_COUNT && contexts_ready; i++) {
+        int context_id;
+        contexts_ready = escape_processor_intern_context(processor, builtin_contexts[i], &context_id);
+    }
     
-    if (!processor->mappings || !processor->default_fault_token) {
+    if (!processor->mappings || !processor->default_fault_token || !contexts_ready) {
+        for (size_t i = 0; i < processor->context_count; i++) free(processor->context_names[i]);
+        free(processor->context_names);
         free(processor->mappings);
         free(processor->default_fault_token);
         free(processor);
@@ -67,6 +399,12 @@ static void escape_processor_destroy(escape_processor_t* processor) {
         free(processor->mappings[i].encoding_context);
     }
     
+    for (size_t i = 0; i < processor->context_count; i++) {
+        free(processor->context_names[i]);
+    }
+    
+    escape_processor_release_automata(processor);
+    free(processor->context_names);
     free(processor->mappings);
     free(processor->default_fault_token);
     free(processor);
@@ -80,6 +418,11 @@ static bool escape_processor_add_mapping(escape_processor_t* processor,
                                         int priority) {
     if (!processor || !source || !target) return false;
     
+    int context_id;
+    if (!escape_processor_intern_context(processor, context ? context : "general", &context_id)) {
+        return false;
+    }
+    
     // Resize if needed
     if (processor->count >= processor->capacity) {
         processor->capacity *= 2;
@@ -95,8 +438,10 @@ static bool escape_processor_add_mapping(escape_processor_t* processor,
     mapping->fault_token = fault_token ? strdup(fault_token) : strdup(processor->default_fault_token);
     mapping->encoding_context = context ? strdup(context) : strdup("general");
     mapping->priority = priority;
+    mapping->context_id = context_id;
     
     processor->count++;
+    processor->compiled = false;  // Tables are rebuilt on next use
     return true;
 }
 
@@ -104,105 +449,157 @@ static bool escape_processor_add_mapping(escape_processor_t* processor,
 // Pattern Transformation with Fault Tolerance
 // ================================
 
-static char* safe_string_replace(const char* source, const char* find, const char* replace) {
-    if (!source || !find || !replace) return NULL;
-    
-    size_t find_len = strlen(find);
-    size_t replace_len = strlen(replace);
-    size_t source_len = strlen(source);
-    
-    // Count occurrences to calculate result size
-    size_t count = 0;
-    const char* temp = source;
-    while ((temp = strstr(temp, find)) != NULL) {
-        count++;
-        temp += find_len;
+// Per-pattern progress lines; the benchmark switches them off
+static bool escape_trace = true;
+
+// Blocks handed out for pattern results, counted for the benchmark
+static size_t escape_allocations = 0;
+
+static void* escape_alloc(size_t size) {
+    escape_allocations++;
+    return malloc(size);
+}
+
+typedef struct {
+    const char* input;
+    char* output;               // Write cursor into the single output buffer
+    size_t resume;              // First input byte not yet consumed
+    char* fault_tokens_used;
+    bool transformation_successful;
+} escape_rewrite_t;
+
+// Settles the input byte at `position` once every match that could start
+// there has been seen: emit the winning replacement, or copy the byte.
+static void escape_rewrite_emit(escape_rewrite_t* rewrite,
+                                const escape_processor_t* processor,
+                                escape_automaton_t* automaton,
+                                size_t position) {
+    int* slot = &automaton->window[position % automaton->longest_source];
+    int local = *slot;
+    *slot = ESCAPE_NO_MATCH;
+    
+    if (position < rewrite->resume) return;  // Inside an earlier replacement
+    
+    if (local == ESCAPE_NO_MATCH) {
+        *rewrite->output++ = rewrite->input[position];
+        rewrite->resume = position + 1;
+        return;
     }
     
-    // Calculate new string size
-    size_t new_size = source_len + count * (replace_len - find_len) + 1;
-    char* result = malloc(new_size);
-    if (!result) return NULL;
+    const escape_mapping_t* mapping = &processor->mappings[automaton->mapping_ids[local]];
+    const char* replacement = mapping->target_sequence;
     
-    // Perform replacement
-    char* dest = result;
-    const char* src = source;
-    while (*src) {
-        if (strncmp(src, find, find_len) == 0) {
-            strcpy(dest, replace);
-            dest += replace_len;
-            src += find_len;
-        } else {
-            *dest++ = *src++;
+    if (!replacement) {
+        // Target was never materialised, fall back to the fault token
+        replacement = mapping->fault_token ? mapping->fault_token : "";
+        if (!automaton->applied[local]) {
+            strcat(rewrite->fault_tokens_used, replacement);
+            strcat(rewrite->fault_tokens_used, " ");
         }
+        rewrite->transformation_successful = false;
     }
-    *dest = '\0';
     
-    return result;
+    size_t length = strlen(replacement);
+    memcpy(rewrite->output, replacement, length);
+    rewrite->output += length;
+    rewrite->resume = position + automaton->source_lengths[local];
+    automaton->applied[local] = true;
 }
 
 static pattern_result_t* process_escape_pattern(escape_processor_t* processor, 
                                               const char* input_pattern,
-                                              const char* encoding_context) {
+                                              int context_id) {
     if (!processor || !input_pattern) return NULL;
     
-    pattern_result_t* result = malloc(sizeof(pattern_result_t));
+    escape_automaton_t* automaton = escape_processor_automaton(processor, context_id);
+    if (!automaton) return NULL;
+    
+    pattern_result_t* result = escape_alloc(sizeof(pattern_result_t));
     if (!result) return NULL;
     
-    result->processed_pattern = strdup(input_pattern);  // Start with original
-    result->transformation_successful = true;
-    result->fault_tokens_used = malloc(256);  // Buffer for fault token tracking
+    size_t input_length = strlen(input_pattern);
+    result->processed_pattern = escape_alloc(input_length * automaton->max_expansion + 1);
+    result->fault_tokens_used = escape_alloc(automaton->fault_capacity + 1);
+    if (!result->processed_pattern || !result->fault_tokens_used) {
+        free(result->processed_pattern);
+        free(result->fault_tokens_used);
+        free(result);
+        return NULL;
+    }
     result->fault_tokens_used[0] = '\0';
     result->transformations_applied = 0;
     
-    printf("  → Processing escape pattern: \"%s\" in context: %s\n", 
-           input_pattern, encoding_context ? encoding_context : "general");
+    if (escape_trace) {
+        printf("  → Processing escape pattern: \"%s\" in context: %s\n", 
+               input_pattern, escape_processor_context_name(processor, context_id));
+    }
     
-    // Apply transformations in priority order
-    for (size_t i = 0; i < processor->count; i++) {
-        escape_mapping_t* mapping = &processor->mappings[i];
+    escape_rewrite_t rewrite = {
+        .input = input_pattern,
+        .output = result->processed_pattern,
+        .resume = 0,
+        .fault_tokens_used = result->fault_tokens_used,
+        .transformation_successful = true
+    };
+    
+    // One left-to-right pass; a byte is settled once the scan is a full
+    // source length past it, so overlapping matches resolve by priority
+    size_t window = automaton->longest_source;
+    if (window == 0) {
+        memcpy(rewrite.output, input_pattern, input_length);
+        rewrite.output += input_length;
+    } else {
+        int state = 0;
+        for (size_t i = 0; i < input_length; i++) {
+            state = automaton->states[state].next[(unsigned char)input_pattern[i]];
+            
+            int hit = automaton->states[state].match != ESCAPE_NO_MATCH ?
+                      state : automaton->states[state].output_link;
+            for (; hit; hit = automaton->states[hit].output_link) {
+                int local = automaton->states[hit].match;
+                size_t start = i + 1 - automaton->source_lengths[local];
+                int* slot = &automaton->window[start % window];
+                if (*slot == ESCAPE_NO_MATCH ||
+                    escape_mapping_wins(processor, automaton, local, *slot)) {
+                    *slot = local;
+                }
+            }
+            
+            if (i + 1 >= window) {
+                escape_rewrite_emit(&rewrite, processor, automaton, i + 1 - window);
+            }
+        }
         
-        // Check if this mapping applies to the current context
-        if (encoding_context && strcmp(mapping->encoding_context, encoding_context) != 0 &&
-            strcmp(mapping->encoding_context, "general") != 0) {
-            continue;
+        size_t pending = input_length >= window ? input_length - window + 1 : 0;
+        for (; pending < input_length; pending++) {
+            escape_rewrite_emit(&rewrite, processor, automaton, pending);
         }
+    }
+    *rewrite.output = '\0';
+    result->transformation_successful = rewrite.transformation_successful;
+    
+    // Report per mapping in the table's priority order
+    for (size_t i = 0; i < automaton->mapping_count; i++) {
+        if (!automaton->applied[i]) continue;
+        automaton->applied[i] = false;
         
-        // Check if pattern contains the source sequence
-        if (strstr(result->processed_pattern, mapping->source_sequence)) {
-            char* new_pattern = safe_string_replace(result->processed_pattern, 
-                                                   mapping->source_sequence,
-                                                   mapping->target_sequence);
-            
-            if (new_pattern) {
+        const escape_mapping_t* mapping = &processor->mappings[automaton->mapping_ids[i]];
+        if (mapping->target_sequence) {
+            if (escape_trace) {
                 printf("    ↳ Applied mapping: \"%s\" → \"%s\"\n", 
                        mapping->source_sequence, mapping->target_sequence);
-                
-                free(result->processed_pattern);
-                result->processed_pattern = new_pattern;
-                result->transformations_applied++;
-            } else {
-                // Transformation failed, apply fault token
-                char* fault_pattern = safe_string_replace(result->processed_pattern,
-                                                         mapping->source_sequence,
-                                                         mapping->fault_token);
-                if (fault_pattern) {
-                    printf("    ↳ Transformation failed, applied fault token: \"%s\"\n", 
-                           mapping->fault_token);
-                    
-                    strcat(result->fault_tokens_used, mapping->fault_token);
-                    strcat(result->fault_tokens_used, " ");
-                    
-                    free(result->processed_pattern);
-                    result->processed_pattern = fault_pattern;
-                    result->transformation_successful = false;
-                }
             }
+            result->transformations_applied++;
+        } else if (escape_trace) {
+            printf("    ↳ Transformation failed, applied fault token: \"%s\"\n", 
+                   mapping->fault_token);
         }
     }
     
-    printf("    ↳ Final pattern: \"%s\" (transformations: %d)\n", 
-           result->processed_pattern, result->transformations_applied);
+    if (escape_trace) {
+        printf("    ↳ Final pattern: \"%s\" (transformations: %d)\n", 
+               result->processed_pattern, result->transformations_applied);
+    }
     
     return result;
 }
@@ -277,19 +674,23 @@ static void demonstrate_escape_processing(void) {
     
     size_t test_count = sizeof(test_patterns) / sizeof(test_patterns[0]);
     
+    // Resolve the layers once rather than per pattern
+    int config_to_c = escape_processor_context_id(processor, "config_to_c");
+    int c_to_regex = escape_processor_context_id(processor, "c_to_regex");
+    
     for (size_t i = 0; i < test_count; i++) {
         printf("\n[PATTERN_TEST] Processing %s\n", pattern_names[i]);
         
         // First transformation: config_to_c context
         pattern_result_t* config_result = process_escape_pattern(processor, 
                                                                test_patterns[i], 
-                                                               "config_to_c");
+                                                               config_to_c);
         
         if (config_result) {
             // Second transformation: c_to_regex context  
             pattern_result_t* regex_result = process_escape_pattern(processor,
                                                                   config_result->processed_pattern,
-                                                                  "c_to_regex");
+                                                                  c_to_regex);
             
             if (regex_result) {
                 printf("  → Final regex-ready pattern: \"%s\"\n", regex_result->processed_pattern);
@@ -310,16 +711,247 @@ static void demonstrate_escape_processing(void) {
     escape_processor_destroy(processor);
 }
 
+// ================================
+// Benchmark Harness
+// --bench [--seed N] [--patterns N] [--length N] [--escapes PERCENT]
+//         [--repeat N] [--output FILE|-]
+// Times process_escape_pattern per encoding context over seeded synthetic
+// patterns; the JSON matches rift_sim_standalone's --bench results.
+// ================================
+
+typedef struct {
+    uint64_t seed;
+    size_t patterns;
+    size_t length;             // Bytes per pattern, before escapes complete
+    size_t escape_percent;     // Positions that start an escape sequence
+    size_t repeat;
+    const char* output_path;
+} escape_bench_config_t;
+
+typedef struct {
+    const char* name;
+    int context_id;
+    uint64_t ops;
+    uint64_t bytes;
+    uint64_t elapsed_ns;
+    uint64_t allocations;
+} escape_bench_result_t;
+
+// xorshift64*, as in rift_sim_standalone's workload generator
+static uint64_t escape_bench_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t escape_bench_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// Patterns mix regex literals with the source sequences of every mapping
+static char** escape_bench_generate(const escape_bench_config_t* config,
+                                    const escape_processor_t* processor, size_t* total_bytes) {
+    static const char literals[] = "abcxyz019_^$[]()*+?|-";
+    char** patterns = calloc(config->patterns, sizeof(char*));
+    if (!patterns) return NULL;
+    
+    size_t longest = 0;
+    for (size_t m = 0; m < processor->count; m++) {
+        size_t length = strlen(processor->mappings[m].source_sequence);
+        if (length > longest) longest = length;
+    }
+    
+    uint64_t state = config->seed ^ 0x9E3779B97F4A7C15ULL;
+    if (state == 0) state = 1;
+    *total_bytes = 0;
+    
+    for (size_t p = 0; p < config->patterns; p++) {
+        char* pattern = malloc(config->length + longest + 1);
+        if (!pattern) return patterns;
+        patterns[p] = pattern;
+        
+        size_t length = 0;
+        while (length < config->length) {
+            uint64_t r = escape_bench_random(&state);
+            if (processor->count && r % 100 < config->escape_percent) {
+                const char* source = processor->mappings[(r >> 8) % processor->count].source_sequence;
+                size_t source_length = strlen(source);
+                memcpy(pattern + length, source, source_length);
+                length += source_length;
+            } else {
+                pattern[length++] = literals[(r >> 8) % (sizeof(literals) - 1)];
+            }
+        }
+        pattern[length] = '\0';
+        *total_bytes += length;
+    }
+    return patterns;
+}
+
+static bool escape_bench_parse_size(const char* text, size_t* value, size_t min, size_t max) {
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno || end == text || *end != '\0' || parsed < min || parsed > max) return false;
+    *value = (size_t)parsed;
+    return true;
+}
+
+static bool escape_bench_parse_args(escape_bench_config_t* config, int argc, char** argv) {
+    for (int i = 0; i < argc; i++) {
+        const char* option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        size_t parsed = 0;
+        bool ok = value != NULL;
+        
+        if (ok && strcmp(option, "--seed") == 0) {
+            ok = escape_bench_parse_size(value, &parsed, 0, SIZE_MAX);
+            config->seed = parsed;
+        } else if (ok && strcmp(option, "--patterns") == 0) {
+            ok = escape_bench_parse_size(value, &config->patterns, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--length") == 0) {
+            ok = escape_bench_parse_size(value, &config->length, 1, SIZE_MAX / 2);
+        } else if (ok && strcmp(option, "--escapes") == 0) {
+            ok = escape_bench_parse_size(value, &config->escape_percent, 0, 100);
+        } else if (ok && strcmp(option, "--repeat") == 0) {
+            ok = escape_bench_parse_size(value, &config->repeat, 1, SIZE_MAX);
+        } else if (ok && strcmp(option, "--output") == 0) {
+            config->output_path = value;
+        } else {
+            ok = false;
+        }
+        
+        if (!ok) {
+            fprintf(stderr, "--bench: invalid option %s%s%s\n", option, value ? " " : "", value ? value : "");
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+static bool escape_bench_write_json(const escape_bench_config_t* config, size_t total_bytes,
+                                    const escape_bench_result_t* results, size_t result_count) {
+    FILE* out = strcmp(config->output_path, "-") == 0 ? stdout : fopen(config->output_path, "w");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", config->output_path, strerror(errno));
+        return false;
+    }
+    
+    fprintf(out, "{\"rift_bench\":{\"workload\":{\"seed\":%llu,\"patterns\":%zu,\"length\":%zu,"
+            "\"escape_percent\":%zu,\"repeat\":%zu,\"bytes\":%zu},\n\"results\":[",
+            (unsigned long long)config->seed, config->patterns, config->length,
+            config->escape_percent, config->repeat, total_bytes);
+    for (size_t i = 0; i < result_count; i++) {
+        const escape_bench_result_t* r = &results[i];
+        fprintf(out, "%s\n{\"name\":\"%s\",\"ops\":%llu,\"total_ns\":%llu,\"ns_per_op\":%.3f,"
+                "\"ns_per_token\":null,\"ns_per_node\":null,\"mb_per_s\":%.3f,"
+                "\"allocations_per_op\":%.3f}",
+                i ? "," : "", r->name, (unsigned long long)r->ops, (unsigned long long)r->elapsed_ns,
+                (double)r->elapsed_ns / (double)r->ops,
+                r->elapsed_ns ? (double)r->bytes * 1000.0 / (double)r->elapsed_ns : 0.0,
+                (double)r->allocations / (double)r->ops);
+    }
+    fprintf(out, "\n]}}\n");
+    
+    bool ok = !ferror(out);
+    if (out != stdout) ok = fclose(out) == 0 && ok;
+    else fflush(out);
+    return ok;
+}
+
+static int run_escape_benchmark(int argc, char** argv) {
+    escape_bench_config_t config = {
+        .seed = 1, .patterns = 10000, .length = 48, .escape_percent = 20, .repeat = 5,
+        .output_path = "escape_bench.json"
+    };
+    if (!escape_bench_parse_args(&config, argc, argv)) return 1;
+    
+    escape_processor_t* processor = create_obinexus_escape_processor();
+    if (!processor) {
+        fprintf(stderr, "Failed to create escape processor\n");
+        return 1;
+    }
+    
+    size_t total_bytes = 0;
+    char** patterns = escape_bench_generate(&config, processor, &total_bytes);
+    bool ok = patterns != NULL;
+    for (size_t p = 0; ok && p < config.patterns; p++) ok = patterns[p] != NULL;
+    
+    escape_bench_result_t results[] = {
+        {"process_escape_pattern.config_to_c", escape_processor_context_id(processor, "config_to_c"), 0, 0, 0, 0},
+        {"process_escape_pattern.c_to_regex", escape_processor_context_id(processor, "c_to_regex"), 0, 0, 0, 0},
+        {"process_escape_pattern.raw_string", escape_processor_context_id(processor, "raw_string"), 0, 0, 0, 0},
+        {"process_escape_pattern.any", ESCAPE_CONTEXT_ANY, 0, 0, 0, 0}
+    };
+    size_t result_count = sizeof(results) / sizeof(results[0]);
+    
+    escape_trace = false;
+    
+    // The first call builds the context tables; keep that out of the timings
+    if (ok) pattern_result_destroy(process_escape_pattern(processor, "", ESCAPE_CONTEXT_ANY));
+    
+    for (size_t pass = 0; ok && pass < config.repeat; pass++) {
+        for (size_t c = 0; ok && c < result_count; c++) {
+            escape_bench_result_t* r = &results[c];
+            size_t allocations = escape_allocations;
+            uint64_t start = escape_bench_clock_ns();
+            for (size_t p = 0; ok && p < config.patterns; p++) {
+                pattern_result_t* result = process_escape_pattern(processor, patterns[p], r->context_id);
+                ok = result != NULL;
+                pattern_result_destroy(result);
+            }
+            r->elapsed_ns += escape_bench_clock_ns() - start;
+            r->allocations += escape_allocations - allocations;
+            r->ops += config.patterns;
+            r->bytes += total_bytes;
+        }
+    }
+    escape_trace = true;
+    
+    if (ok) {
+        printf("\n[BENCH] %zu patterns, %zu bytes, seed %llu\n", config.patterns, total_bytes,
+               (unsigned long long)config.seed);
+        for (size_t c = 0; c < result_count; c++) {
+            const escape_bench_result_t* r = &results[c];
+            printf("[BENCH] %-36s %10.1f ns/op  %8.1f MB/s  %6.2f allocs/op\n", r->name,
+                   (double)r->elapsed_ns / (double)r->ops,
+                   (double)r->bytes * 1000.0 / (double)r->elapsed_ns,
+                   (double)r->allocations / (double)r->ops);
+        }
+        ok = escape_bench_write_json(&config, total_bytes, results, result_count);
+        if (ok && strcmp(config.output_path, "-") != 0) {
+            printf("[BENCH] Results saved to %s\n", config.output_path);
+        }
+    } else {
+        fprintf(stderr, "Escape benchmark failed\n");
+    }
+    
+    for (size_t p = 0; patterns && p < config.patterns; p++) free(patterns[p]);
+    free(patterns);
+    escape_processor_destroy(processor);
+    return ok ? 0 : 1;
+}
+
 // ================================
 // Main Function for Testing
 // ================================
 
-int main(void) {
+int main(int argc, char** argv) {
     printf("OBINexus Framework - Fault-Tolerant Escape Sequence Processing\n");
     printf("=============================================================\n");
     printf("Handling multi-layer character encoding transitions\n");
     printf("Supporting R'' and R'' mapping with systematic fault tolerance\n");
     
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return run_escape_benchmark(argc - 2, argv + 2);
+    }
+    
     demonstrate_escape_processing();
     
     printf("\n[SYSTEM] Escape sequence processing validation complete\n");
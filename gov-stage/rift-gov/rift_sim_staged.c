@@ -8,37 +8,86 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
 #include <regex.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // ================================
 // Stage-Bound Governance Types
 // ================================
 
+// Keys and values point into the text of the file they were parsed from
 typedef struct {
-    char* key;
-    char* value;
+    const char* key;
+    const char* value;
+    size_t hash;           // rift_hash_string(key)
 } config_pair_t;
 
+typedef struct {
+    size_t hash;
+    size_t position;       // Index into the indexed array + 1, 0 = empty
+} config_index_slot_t;
+
+typedef struct {
+    config_index_slot_t* slots;
+    size_t capacity;
+    size_t count;
+    bool borrowed;         // slots live in a governance snapshot mapping
+} config_index_t;
+
 typedef struct {
     config_pair_t* pairs;
     size_t count;
     size_t capacity;
+    config_index_t index;  // Key lookup into pairs
 } config_section_t;
 
+// Text of one governance file, privately mapped (or copied) and writable
+typedef struct {
+    char* data;
+    size_t length;
+    bool mapped;
+} config_file_t;
+
+typedef void (*config_visit_fn)(void* context, const char* section, const char* key,
+                                const char* value);
+
 typedef struct {
     int stage_id;
-    char* stage_name;
-    char* sp_alignment;
-    char* governance_version;
+    int declared_stage_id;             // stage_id from [STAGE_METADATA]
+    const char* stage_name;            // Strings borrowed from file
+    const char* sp_alignment;
+    const char* governance_version;
     config_section_t** sections;
     size_t section_count;
-    char** section_names;
+    size_t section_capacity;
+    const char** section_names;
+    config_index_t section_index;      // Name lookup into sections
+    config_section_t* current_section; // Parser state: section of the last key
+    const char* current_name;
+    config_file_t file;
 } stage_config_t;
 
+typedef struct rift_snapshot rift_snapshot_t;
+
 typedef struct {
-    stage_config_t* stage_configs[4];  // RIFT-0 through RIFT-3
-    config_section_t* global_config;
+    stage_config_t* stage_configs[4];  // RIFT-0 through RIFT-3, from .riftrc.N
+    stage_config_t* global_config;     // global.rift
     bool stage_loaded[4];
+    const char* config_dir;
+    uint64_t content_hash;             // Of the governance files, keys the snapshot
+    rift_snapshot_t* snapshot;         // Compiled governance in use, NULL when parsing
+    uint8_t operator_precedence[256];  // From .riftrc.1, 0 = not a binary operator
+    size_t operator_count;
+    char** token_patterns;             // Escape-normalized .riftrc.0 [TOKEN_PATTERNS]
+    size_t token_pattern_count;        //   values, by pair; NULL for non-pattern keys
+    bool token_patterns_borrowed;      // Strings live in the snapshot mapping
 } rift_governance_system_t;
 
 // ================================
@@ -55,7 +104,8 @@ typedef enum {
 
 typedef struct {
     token_type_t type;
-    char* value;
+    size_t offset;  // Token text is source[offset, offset + length)
+    size_t length;
     size_t line;
     size_t column;
     int priority;  // Added for stage-bound prioritization
@@ -65,6 +115,8 @@ typedef struct {
     rift_token_t* tokens;
     size_t count;
     size_t capacity;
+    const char* source;  // Borrowed input; must outlive the stream and its AST
+    size_t source_length;
 } token_stream_t;
 
 typedef enum {
@@ -76,7 +128,8 @@ typedef enum {
 
 typedef struct ast_node {
     ast_node_type_t type;
-    char* value;
+    const char* value;  // Span into the token stream source, not terminated
+    size_t value_length;
     struct ast_node* left;
     struct ast_node* right;
 } ast_node_t;
@@ -85,12 +138,40 @@ typedef struct ast_node {
 // Stage-Bound Processor Types
 // ================================
 
+// Bounded LRU cache of compiled regular expressions, sized by
+// regex_cache_size from .riftrc.0 [PERFORMANCE_TUNING]
+typedef struct {
+    char* pattern;
+    size_t hash;
+    regex_t regex;
+    bool compiled;         // false if regcomp rejected the pattern
+    size_t last_used;
+} rift_regex_cache_entry_t;
+
+typedef struct {
+    rift_regex_cache_entry_t* entries;
+    size_t count;
+    size_t capacity;
+    size_t clock;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+} rift_regex_cache_t;
+
+typedef struct rift_dfa rift_dfa_t;
+
 typedef struct {
     rift_governance_system_t* governance;
     stage_config_t* stage_config;
     char** token_patterns;
     int* token_priorities;
+    token_type_t* token_types;
+    size_t* pattern_hashes;    // Precomputed for regex cache lookups
+    size_t* cache_slots;       // Last known regex cache slot per pattern
     size_t pattern_count;
+    rift_regex_cache_t* regex_cache;
+    rift_dfa_t* dfa;           // Combined token automaton, NULL → regex fallback
+    bool trace_tokens;         // Print stage progress and every classification
 } rift_stage0_processor_t;
 
 typedef struct {
@@ -121,12 +202,74 @@ typedef struct {
 // Configuration Loading Functions
 // ================================
 
+static size_t rift_hash_string(const char* str);
+
+// Open-addressing hash index over an external array. Each slot keeps the
+// item's hash and its position + 1 (0 marks an empty slot); capacity is a
+// power of two kept at most half full. Items are never removed, so the probe
+// sequence returns duplicates in insertion order.
+#define CONFIG_INDEX_END ((size_t)-1)
+
+static bool config_index_grow(config_index_t* index) {
+    size_t capacity = index->capacity ? index->capacity * 2 : 16;
+    config_index_slot_t* slots = calloc(capacity, sizeof(config_index_slot_t));
+    if (!slots) return false;
+    
+    for (size_t i = 0; i < index->capacity; i++) {
+        config_index_slot_t slot = index->slots[i];
+        if (!slot.position) continue;
+        size_t probe = slot.hash & (capacity - 1);
+        while (slots[probe].position) probe = (probe + 1) & (capacity - 1);
+        slots[probe] = slot;
+    }
+    
+    free(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    return true;
+}
+
+static bool config_index_insert(config_index_t* index, size_t hash, size_t position) {
+    if ((index->count + 1) * 2 > index->capacity && !config_index_grow(index)) return false;
+    
+    size_t probe = hash & (index->capacity - 1);
+    while (index->slots[probe].position) probe = (probe + 1) & (index->capacity - 1);
+    index->slots[probe].hash = hash;
+    index->slots[probe].position = position + 1;
+    index->count++;
+    return true;
+}
+
+// Iterates the positions whose hash equals hash; start with *cursor = hash.
+// Returns CONFIG_INDEX_END when the probe reaches an empty slot.
+static size_t config_index_next(const config_index_t* index, size_t hash, size_t* cursor) {
+    if (!index->capacity) return CONFIG_INDEX_END;
+    
+    size_t mask = index->capacity - 1;
+    for (size_t probe = *cursor & mask; index->slots[probe].position; probe = (probe + 1) & mask) {
+        if (index->slots[probe].hash == hash) {
+            *cursor = probe + 1;
+            return index->slots[probe].position - 1;
+        }
+    }
+    return CONFIG_INDEX_END;
+}
+
+static void config_index_release(config_index_t* index) {
+    if (!index->borrowed) free(index->slots);
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+
 static config_section_t* config_section_create(void) {
     config_section_t* section = malloc(sizeof(config_section_t));
     if (!section) return NULL;
     
     section->capacity = 10;
     section->count = 0;
+    section->index = (config_index_t){0};
     section->pairs = malloc(sizeof(config_pair_t) * section->capacity);
     if (!section->pairs) {
         free(section);
@@ -139,14 +282,12 @@ static config_section_t* config_section_create(void) {
 static void config_section_destroy(config_section_t* section) {
     if (!section) return;
     
-    for (size_t i = 0; i < section->count; i++) {
-        free(section->pairs[i].key);
-        free(section->pairs[i].value);
-    }
+    config_index_release(&section->index);
     free(section->pairs);
     free(section);
 }
 
+// key and value are borrowed and must outlive the section
 static bool config_section_add(config_section_t* section, const char* key, const char* value) {
     if (!section || !key || !value) return false;
     
@@ -159,176 +300,484 @@ static bool config_section_add(config_section_t* section, const char* key, const
         section->pairs = new_pairs;
     }
     
-    section->pairs[section->count].key = strdup(key);
-    section->pairs[section->count].value = strdup(value);
+    config_pair_t* pair = &section->pairs[section->count];
+    pair->key = key;
+    pair->value = value;
+    pair->hash = rift_hash_string(key);
+    if (!config_index_insert(&section->index, pair->hash, section->count)) return false;
     section->count++;
     
     return true;
 }
 
-static const char* config_section_get(config_section_t* section, const char* key) {
+// Resolves key to its pair. Pairs are not moved once loading has finished, so
+// the result can be kept as a handle and read through config_pair_value.
+static const config_pair_t* config_section_find(const config_section_t* section, const char* key) {
     if (!section || !key) return NULL;
     
-    for (size_t i = 0; i < section->count; i++) {
-        if (strcmp(section->pairs[i].key, key) == 0) {
-            return section->pairs[i].value;
-        }
+    size_t hash = rift_hash_string(key);
+    size_t cursor = hash;
+    for (size_t i; (i = config_index_next(&section->index, hash, &cursor)) != CONFIG_INDEX_END; ) {
+        if (strcmp(section->pairs[i].key, key) == 0) return &section->pairs[i];
     }
     return NULL;
 }
 
-// Simulated configuration file parser - in real implementation would read actual files
-static stage_config_t* load_stage_config(int stage_id) {
-    stage_config_t* config = malloc(sizeof(stage_config_t));
-    if (!config) return NULL;
+static inline const char* config_pair_value(const config_pair_t* pair) {
+    return pair ? pair->value : NULL;
+}
+
+static const char* config_section_get(const config_section_t* section, const char* key) {
+    return config_pair_value(config_section_find(section, key));
+}
+
+static config_section_t* stage_config_section(const stage_config_t* config, const char* name) {
+    if (!config || !name) return NULL;
     
-    config->stage_id = stage_id;
-    config->sections = malloc(sizeof(config_section_t*) * 5);  // Max 5 sections per stage
-    config->section_names = malloc(sizeof(char*) * 5);
-    config->section_count = 0;
+    size_t hash = rift_hash_string(name);
+    size_t cursor = hash;
+    for (size_t i; (i = config_index_next(&config->section_index, hash, &cursor)) != CONFIG_INDEX_END; ) {
+        if (strcmp(config->section_names[i], name) == 0) return config->sections[i];
+    }
+    return NULL;
+}
+
+// Maps a governance file privately and writable, so the parser can terminate
+// keys and values in place. Falls back to a heap copy when the file has no
+// spare byte after its end within the last page.
+static bool config_file_open(config_file_t* file, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
     
-    printf("  → Loading .riftrc.%d configuration\n", stage_id);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
     
-    // Simulate loading stage-specific configuration based on stage_id
-    switch (stage_id) {
-        case 0: {  // RIFT-0 Tokenizer configuration
-            config->stage_name = strdup("TOKENIZER");
-            config->sp_alignment = strdup("LEXICAL_ANALYSIS");
-            config->governance_version = strdup("1.0.0");
-            
-            // TOKEN_PATTERNS section
-            config_section_t* patterns = config_section_create();
-            config_section_add(patterns, "IDENTIFIER_PATTERN", "^[a-zA-Z_]\\\\w*$");
-            config_section_add(patterns, "IDENTIFIER_PRIORITY", "100");
-            config_section_add(patterns, "NUMBER_PATTERN", "^\\\\d+(\\\\.\\\\d+)?$");
-            config_section_add(patterns, "NUMBER_PRIORITY", "90");
-            config_section_add(patterns, "OPERATOR_PATTERN", "^[+\\\\-*/=<>!&|]$");
-            config_section_add(patterns, "OPERATOR_PRIORITY", "80");
-            config_section_add(patterns, "WHITESPACE_PATTERN", "^\\\\s+$");
-            config_section_add(patterns, "WHITESPACE_PRIORITY", "10");
-            
-            config->sections[config->section_count] = patterns;
-            config->section_names[config->section_count] = strdup("TOKEN_PATTERNS");
-            config->section_count++;
-            
-            // DFA_CONFIGURATION section
-            config_section_t* dfa = config_section_create();
-            config_section_add(dfa, "initial_state", "START");
-            config_section_add(dfa, "final_states", "IDENTIFIER,NUMBER,OPERATOR");
-            config_section_add(dfa, "error_recovery", "true");
-            
-            config->sections[config->section_count] = dfa;
-            config->section_names[config->section_count] = strdup("DFA_CONFIGURATION");
-            config->section_count++;
-            break;
+    file->length = (size_t)st.st_size;
+    file->mapped = false;
+    long page_size = sysconf(_SC_PAGESIZE);
+    
+    if (file->length > 0 && page_size > 0 && file->length % (size_t)page_size != 0) {
+        void* data = mmap(NULL, file->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            file->data = data;
+            file->mapped = true;
+            close(fd);
+            return true;
         }
+    }
+    
+    file->data = malloc(file->length + 1);
+    size_t filled = 0;
+    while (file->data && filled < file->length) {
+        ssize_t got = read(fd, file->data + filled, file->length - filled);
+        if (got <= 0) break;
+        filled += (size_t)got;
+    }
+    close(fd);
+    
+    if (!file->data || filled != file->length) {
+        free(file->data);
+        return false;
+    }
+    file->data[file->length] = '\0';
+    return true;
+}
+
+static void config_file_close(config_file_t* file) {
+    if (file->mapped) munmap(file->data, file->length);
+    else free(file->data);
+    file->data = NULL;
+    file->length = 0;
+}
+
+static char* config_trim(char* begin, char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+    *end = '\0';
+    return begin;
+}
+
+// Single pass over the file text: [SECTION] headers, key=value lines and
+// '#'/';' comments. Strings are terminated in place, nothing is copied. Lines
+// before the first section header are ignored.
+static void config_file_parse(config_file_t* file, config_visit_fn visit, void* context) {
+    char* text = file->data;
+    char* end = text + file->length;
+    const char* section = NULL;
+    
+    while (text < end) {
+        char* line_end = memchr(text, '\n', (size_t)(end - text));
+        if (!line_end) line_end = end;
         
-        case 1: {  // RIFT-1 Parser configuration
-            config->stage_name = strdup("PARSER_BRIDGE");
-            config->sp_alignment = strdup("SYNTACTIC_ANALYSIS");
-            config->governance_version = strdup("1.0.0");
-            
-            // GRAMMAR_RULES section
-            config_section_t* grammar = config_section_create();
-            config_section_add(grammar, "EXPRESSION_RULE", "expression -> term ((PLUS | MINUS) term)*");
-            config_section_add(grammar, "TERM_RULE", "term -> factor ((MULTIPLY | DIVIDE) factor)*");
-            config_section_add(grammar, "FACTOR_RULE", "factor -> IDENTIFIER | NUMBER | LPAREN expression RPAREN");
-            
-            config->sections[config->section_count] = grammar;
-            config->section_names[config->section_count] = strdup("GRAMMAR_RULES");
-            config->section_count++;
-            
-            // PRECEDENCE_TABLE section
-            config_section_t* precedence = config_section_create();
-            config_section_add(precedence, "MULTIPLY_PRECEDENCE", "20");
-            config_section_add(precedence, "DIVIDE_PRECEDENCE", "20");
-            config_section_add(precedence, "PLUS_PRECEDENCE", "10");
-            config_section_add(precedence, "MINUS_PRECEDENCE", "10");
-            
-            config->sections[config->section_count] = precedence;
-            config->section_names[config->section_count] = strdup("PRECEDENCE_TABLE");
-            config->section_count++;
-            break;
-        }
+        char* line = text;
+        while (line < line_end && (*line == ' ' || *line == '\t')) line++;
         
-        case 2: {  // RIFT-2 AST Coordinator configuration
-            config->stage_name = strdup("AST_COORDINATOR");
-            config->sp_alignment = strdup("SEMANTIC_ANALYSIS");
-            config->governance_version = strdup("1.0.0");
-            
-            // OPTIMIZATION_PASSES section
-            config_section_t* optimization = config_section_create();
-            config_section_add(optimization, "constant_folding", "enabled");
-            config_section_add(optimization, "dead_code_elimination", "enabled");
-            config_section_add(optimization, "common_subexpression_elimination", "disabled");
-            
-            config->sections[config->section_count] = optimization;
-            config->section_names[config->section_count] = strdup("OPTIMIZATION_PASSES");
-            config->section_count++;
-            break;
+        if (line < line_end && *line == '[') {
+            char* close = memchr(line, ']', (size_t)(line_end - line));
+            if (close) section = config_trim(line + 1, close);
+        } else if (section && line < line_end && *line != '#' && *line != ';') {
+            char* equals = memchr(line, '=', (size_t)(line_end - line));
+            if (equals) {
+                char* key = config_trim(line, equals);
+                char* value = config_trim(equals + 1, line_end);
+                if (*key) visit(context, section, key, value);
+            }
         }
         
-        case 3: {  // RIFT-3 Output configuration
-            config->stage_name = strdup("OUTPUT_GENERATOR");
-            config->sp_alignment = strdup("CODE_GENERATION");
-            config->governance_version = strdup("1.0.0");
-            
-            // OUTPUT_FORMATS section
-            config_section_t* formats = config_section_create();
-            config_section_add(formats, "primary_format", "LISP_STYLE_AST");
-            config_section_add(formats, "secondary_format", "C_CODE");
-            config_section_add(formats, "debug_format", "DOT_GRAPH");
-            config_section_add(formats, "json_export", "enabled");
-            
-            config->sections[config->section_count] = formats;
-            config->section_names[config->section_count] = strdup("OUTPUT_FORMATS");
-            config->section_count++;
-            break;
+        text = line_end + 1;
+    }
+}
+
+static void stage_config_visit(void* context, const char* section, const char* key, const char* value) {
+    stage_config_t* config = context;
+    
+    // Consecutive keys share the parser's section pointer; a header seen again
+    // later reopens the existing section
+    if (section != config->current_name) {
+        config->current_name = section;
+        config->current_section = stage_config_section(config, section);
+    }
+    
+    if (!config->current_section) {
+        if (config->section_count == config->section_capacity) {
+            size_t capacity = config->section_capacity * 2;
+            config_section_t** sections = realloc(config->sections, sizeof(config_section_t*) * capacity);
+            if (sections) config->sections = sections;
+            const char** names = realloc(config->section_names, sizeof(char*) * capacity);
+            if (names) config->section_names = names;
+            if (!sections || !names) return;
+            config->section_capacity = capacity;
         }
+        config_section_t* created = config_section_create();
+        if (!created) return;
+        if (!config_index_insert(&config->section_index, rift_hash_string(section),
+                                 config->section_count)) {
+            config_section_destroy(created);
+            return;
+        }
+        config->sections[config->section_count] = created;
+        config->section_names[config->section_count] = section;
+        config->section_count++;
+        config->current_section = created;
     }
     
-    printf("    ↳ Stage %s loaded with SP alignment: %s\n", 
-           config->stage_name, config->sp_alignment);
-    printf("    ↳ Configuration sections: %zu\n", config->section_count);
+    config_section_add(config->current_section, key, value);
+    
+    if (strcmp(section, "STAGE_METADATA") == 0) {
+        if (strcmp(key, "stage_name") == 0) config->stage_name = value;
+        else if (strcmp(key, "sp_alignment") == 0) config->sp_alignment = value;
+        else if (strcmp(key, "governance_version") == 0) config->governance_version = value;
+        else if (strcmp(key, "stage_id") == 0) config->declared_stage_id = atoi(value);
+    }
+}
+
+// Loads dir/name into a stage config; stage_id -1 marks global.rift
+static stage_config_t* load_config_file(const char* dir, const char* name, int stage_id) {
+    char path[1024];
+    size_t dir_length = strlen(dir);
+    const char* separator = dir_length && dir[dir_length - 1] == '/' ? "" : "/";
+    snprintf(path, sizeof(path), "%s%s%s", dir, separator, name);
+    
+    stage_config_t* config = calloc(1, sizeof(stage_config_t));
+    if (!config) return NULL;
+    
+    config->stage_id = stage_id;
+    config->declared_stage_id = stage_id;
+    config->stage_name = "UNNAMED";
+    config->sp_alignment = "UNSPECIFIED";
+    config->governance_version = "0.0.0";
+    config->section_capacity = 8;
+    config->sections = malloc(sizeof(config_section_t*) * config->section_capacity);
+    config->section_names = malloc(sizeof(char*) * config->section_capacity);
+    
+    if (!config->sections || !config->section_names || !config_file_open(&config->file, path)) {
+        fprintf(stderr, "Failed to load governance file %s\n", path);
+        free(config->sections);
+        free(config->section_names);
+        free(config);
+        return NULL;
+    }
+    
+    config_file_parse(&config->file, stage_config_visit, config);
     
+    if (config->declared_stage_id != stage_id) {
+        fprintf(stderr, "Warning: %s declares stage_id=%d, loaded as stage %d\n",
+                path, config->declared_stage_id, stage_id);
+    }
     return config;
 }
 
+static stage_config_t* load_stage_config(const char* dir, int stage_id) {
+    char name[32];
+    snprintf(name, sizeof(name), ".riftrc.%d", stage_id);
+    
+    printf("  → Loading .riftrc.%d configuration\n", stage_id);
+    return load_config_file(dir, name, stage_id);
+}
+
 static void stage_config_destroy(stage_config_t* config) {
     if (!config) return;
     
-    free(config->stage_name);
-    free(config->sp_alignment);
-    free(config->governance_version);
-    
     for (size_t i = 0; i < config->section_count; i++) {
         config_section_destroy(config->sections[i]);
-        free(config->section_names[i]);
     }
     
     free(config->sections);
     free(config->section_names);
+    config_index_release(&config->section_index);
+    config_file_close(&config->file);
     free(config);
 }
 
+// ================================
+// Governance Escape Normalization
+// Token patterns are escaped twice in the governance files: once for the
+// config layer and once for the regex layer (^[a-zA-Z_]\\w*$). Loading
+// removes the config layer and spells the class escapes as POSIX bracket
+// classes, so the same text compiles under regcomp and the token DFA.
+// ================================
+
+typedef struct {
+    char escape;
+    const char* bare;        // Replacement outside a bracket expression
+    const char* bracketed;   // Replacement inside [...], NULL if inexpressible
+} pattern_class_escape_t;
+
+static const pattern_class_escape_t pattern_class_escapes[] = {
+    {'w', "[[:alnum:]_]", "[:alnum:]_"},
+    {'W', "[^[:alnum:]_]", NULL},
+    {'d', "[[:digit:]]", "[:digit:]"},
+    {'D', "[^[:digit:]]", NULL},
+    {'s', "[[:space:]]", "[:space:]"},
+    {'S', "[^[:space:]]", NULL}
+};
+
+static const pattern_class_escape_t* pattern_class_escape(char escape) {
+    for (size_t i = 0; i < sizeof(pattern_class_escapes) / sizeof(pattern_class_escapes[0]); i++) {
+        if (pattern_class_escapes[i].escape == escape) return &pattern_class_escapes[i];
+    }
+    return NULL;
+}
+
+// Length of NAME in a NAME_PATTERN key, 0 if key does not name a token pattern
+static size_t token_pattern_name_length(const char* key) {
+    size_t length = strlen(key);
+    if (length <= 8 || strcmp(key + length - 8, "_PATTERN") != 0) return 0;
+    return length - 8;
+}
+
+// Returns the regex-ready form of a governance pattern, counting rewritten
+// escapes in *rewrites; NULL if it cannot be expressed (e.g. \W in [...])
+static char* governance_normalize_pattern(const char* pattern, size_t* rewrites) {
+    size_t length = strlen(pattern);
+    char* unescaped = malloc(length + 1);
+    char* normalized = malloc(length * 7 + 1);  // "\d" -> "[[:digit:]]" is the widest growth
+    if (!unescaped || !normalized) {
+        free(unescaped);
+        free(normalized);
+        return NULL;
+    }
+    
+    // Config layer: "\\" stands for one backslash
+    char* u = unescaped;
+    for (const char* p = pattern; *p; p++) {
+        *u++ = *p;
+        if (p[0] == '\\' && p[1] == '\\') p++;
+    }
+    *u = '\0';
+    
+    // Regex layer: class escapes become POSIX classes. ERE brackets take no
+    // escapes, so escaped members are written bare and '-' moves to the end.
+    char* out = normalized;
+    bool in_bracket = false;
+    bool trailing_dash = false;
+    bool ok = true;
+    
+    for (const char* p = unescaped; *p && ok; p++) {
+        if (in_bracket && p[0] == '[' && p[1] == ':') {
+            const char* end = strstr(p + 2, ":]");
+            if (!end) {
+                ok = false;
+                break;
+            }
+            memcpy(out, p, (size_t)(end + 2 - p));
+            out += end + 2 - p;
+            p = end + 1;
+        } else if (p[0] == '\\' && p[1]) {
+            const pattern_class_escape_t* class_escape = pattern_class_escape(p[1]);
+            const char* replacement = class_escape
+                ? (in_bracket ? class_escape->bracketed : class_escape->bare) : NULL;
+            
+            if (replacement) {
+                size_t replacement_length = strlen(replacement);
+                memcpy(out, replacement, replacement_length);
+                out += replacement_length;
+                (*rewrites)++;
+            } else if (class_escape) {
+                ok = false;
+            } else if (in_bracket && p[1] == '-') {
+                trailing_dash = true;
+                (*rewrites)++;
+            } else if (in_bracket && !strchr("]^\\", p[1])) {
+                *out++ = p[1];
+                (*rewrites)++;
+            } else {
+                *out++ = p[0];
+                *out++ = p[1];
+            }
+            p++;
+        } else if (!in_bracket && *p == '[') {
+            *out++ = *p;
+            in_bracket = true;
+            if (p[1] == '^') *out++ = *++p;
+            if (p[1] == ']') *out++ = *++p;  // Leading ']' is a member
+        } else if (in_bracket && *p == ']') {
+            if (trailing_dash) *out++ = '-';
+            *out++ = ']';
+            in_bracket = false;
+            trailing_dash = false;
+        } else {
+            *out++ = *p;
+        }
+    }
+    *out = '\0';
+    
+    free(unescaped);
+    if (!ok || in_bracket) {
+        free(normalized);
+        return NULL;
+    }
+    return normalized;
+}
+
 // ================================
 // Stage-Bound Governance System
 // ================================
 
-static rift_governance_system_t* governance_system_create(void) {
+// Governance snapshot functions (defined after the token DFA)
+static uint64_t governance_content_hash(const char* dir);
+static rift_snapshot_t* snapshot_open(const char* dir, uint64_t content_hash);
+static void snapshot_close(rift_snapshot_t* snapshot);
+static stage_config_t* snapshot_load_config(const rift_snapshot_t* snapshot, int which);
+static size_t snapshot_load_precedence(const rift_snapshot_t* snapshot, uint8_t* precedence);
+static bool snapshot_load_patterns(const rift_snapshot_t* snapshot, rift_governance_system_t* system);
+
+// Normalizes every NAME_PATTERN value of .riftrc.0 once at load, so RIFT-0
+// compiles them as they are
+static void governance_normalize_patterns(rift_governance_system_t* system) {
+    config_section_t* patterns = stage_config_section(system->stage_configs[0], "TOKEN_PATTERNS");
+    if (!patterns) return;
+    
+    system->token_patterns = calloc(patterns->count ? patterns->count : 1, sizeof(char*));
+    if (!system->token_patterns) return;
+    system->token_pattern_count = patterns->count;
+    system->token_patterns_borrowed = false;
+    
+    size_t normalized = 0;
+    size_t rewrites = 0;
+    for (size_t i = 0; i < patterns->count; i++) {
+        if (!token_pattern_name_length(patterns->pairs[i].key)) continue;
+        
+        system->token_patterns[i] = governance_normalize_pattern(patterns->pairs[i].value, &rewrites);
+        if (system->token_patterns[i]) {
+            normalized++;
+        } else {
+            fprintf(stderr, "Warning: %s keeps its governance escapes\n", patterns->pairs[i].key);
+        }
+    }
+    
+    printf("    ↳ Token patterns normalized: %zu (%zu escapes rewritten)\n", normalized, rewrites);
+}
+
+// Fills the byte-indexed precedence table from every NAME_PRECEDENCE entry
+// of .riftrc.1 that has a single-byte NAME_SYMBOL
+static void governance_build_precedence(rift_governance_system_t* system) {
+    stage_config_t* config = system->stage_configs[1];
+    config_section_t* table = stage_config_section(config, "PRECEDENCE_TABLE");
+    config_section_t* symbols = stage_config_section(config, "OPERATOR_SYMBOLS");
+    
+    memset(system->operator_precedence, 0, sizeof(system->operator_precedence));
+    system->operator_count = 0;
+    
+    for (size_t i = 0; table && i < table->count; i++) {
+        const char* key = table->pairs[i].key;
+        size_t key_length = strlen(key);
+        if (key_length <= 11 || strcmp(key + key_length - 11, "_PRECEDENCE") != 0) continue;
+        
+        char symbol_key[128];
+        snprintf(symbol_key, sizeof(symbol_key), "%.*s_SYMBOL", (int)(key_length - 11), key);
+        const char* symbol = config_section_get(symbols, symbol_key);
+        long precedence = strtol(table->pairs[i].value, NULL, 10);
+        if (!symbol || strlen(symbol) != 1 || precedence < 1 || precedence > UINT8_MAX) continue;
+        
+        unsigned char byte = (unsigned char)symbol[0];
+        if (!system->operator_precedence[byte]) system->operator_count++;
+        system->operator_precedence[byte] = (uint8_t)precedence;
+    }
+}
+
+static double elapsed_microseconds(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e6 + (double)(now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+// Picks the governance directory: $RIFT_GOV_DIR, then rift-gov/ below the
+// working directory, then the working directory itself
+static const char* governance_find_dir(void) {
+    const char* env = getenv("RIFT_GOV_DIR");
+    if (env && *env) return env;
+    if (access("rift-gov/.riftrc.0", R_OK) == 0) return "rift-gov";
+    return ".";
+}
+
+// With use_snapshot, a governance.snapshot matching the current files is
+// mapped and used instead of parsing them
+static rift_governance_system_t* governance_system_create(bool use_snapshot) {
     rift_governance_system_t* system = malloc(sizeof(rift_governance_system_t));
     if (!system) return NULL;
     
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
     // Initialize all stage configs to NULL
     for (int i = 0; i < 4; i++) {
         system->stage_configs[i] = NULL;
         system->stage_loaded[i] = false;
     }
     
-    system->global_config = config_section_create();
+    system->config_dir = governance_find_dir();
+    system->content_hash = governance_content_hash(system->config_dir);
+    system->snapshot = use_snapshot ? snapshot_open(system->config_dir, system->content_hash) : NULL;
+    system->operator_count = 0;
+    memset(system->operator_precedence, 0, sizeof(system->operator_precedence));
+    system->token_patterns = NULL;
+    system->token_pattern_count = 0;
+    system->token_patterns_borrowed = false;
+    
+    system->global_config = system->snapshot ? snapshot_load_config(system->snapshot, 4) : NULL;
+    if (!system->global_config && system->snapshot) {
+        // A damaged snapshot is dropped and the files are parsed instead
+        snapshot_close(system->snapshot);
+        system->snapshot = NULL;
+    }
+    if (!system->global_config) {
+        system->global_config = load_config_file(system->config_dir, "global.rift", -1);
+    }
+    if (!system->global_config) {
+        snapshot_close(system->snapshot);
+        free(system);
+        return NULL;
+    }
     
     printf("[GOVERNANCE_SYSTEM] Initializing stage-bound governance\n");
-    printf("  → rift-gov/ directory structure established\n");
+    printf("  → %s/ directory structure established (global.rift: %zu sections, %.0f µs)\n",
+           system->config_dir, system->global_config->section_count, elapsed_microseconds(&start));
+    printf("  → %s\n", system->snapshot ? "Using compiled governance snapshot"
+                                        : "Parsing governance files (no current snapshot)");
     
     return system;
 }
@@ -342,7 +791,15 @@ static void governance_system_destroy(rift_governance_system_t* system) {
         }
     }
     
-    config_section_destroy(system->global_config);
+    if (system->token_patterns && !system->token_patterns_borrowed) {
+        for (size_t i = 0; i < system->token_pattern_count; i++) {
+            free(system->token_patterns[i]);
+        }
+    }
+    free(system->token_patterns);
+    
+    stage_config_destroy(system->global_config);
+    snapshot_close(system->snapshot);
     free(system);
 }
 
@@ -354,170 +811,1710 @@ static bool governance_load_stage(rift_governance_system_t* system, int stage_id
         return true;
     }
     
-    system->stage_configs[stage_id] = load_stage_config(stage_id);
-    if (!system->stage_configs[stage_id]) return false;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    if (system->snapshot) {
+        printf("  → Loading .riftrc.%d configuration from snapshot\n", stage_id);
+        system->stage_configs[stage_id] = snapshot_load_config(system->snapshot, stage_id);
+        if (!system->stage_configs[stage_id]) {
+            printf("  → Falling back to parsing .riftrc.%d\n", stage_id);
+            system->stage_configs[stage_id] = load_stage_config(system->config_dir, stage_id);
+        }
+    } else {
+        system->stage_configs[stage_id] = load_stage_config(system->config_dir, stage_id);
+    }
+    stage_config_t* config = system->stage_configs[stage_id];
+    if (!config) return false;
+    
+    printf("    ↳ Stage %s loaded with SP alignment: %s\n", 
+           config->stage_name, config->sp_alignment);
+    printf("    ↳ Configuration sections: %zu\n", config->section_count);
+    
+    if (stage_id == 0) {
+        if (system->snapshot && snapshot_load_patterns(system->snapshot, system)) {
+            size_t normalized = 0;
+            for (size_t i = 0; i < system->token_pattern_count; i++) {
+                if (system->token_patterns[i]) normalized++;
+            }
+            printf("    ↳ Token patterns normalized: %zu (from snapshot)\n", normalized);
+        } else {
+            governance_normalize_patterns(system);
+        }
+    }
+    
+    if (stage_id == 1) {
+        if (system->snapshot) {
+            system->operator_count = snapshot_load_precedence(system->snapshot,
+                                                              system->operator_precedence);
+        } else {
+            governance_build_precedence(system);
+        }
+    }
     
+    printf("    ↳ Loaded in %.0f µs\n", elapsed_microseconds(&start));
     system->stage_loaded[stage_id] = true;
     return true;
 }
 
 // ================================
-// RIFT-0: Stage-Bound Tokenizer
+// Regex Cache
 // ================================
 
-static rift_stage0_processor_t* rift_stage0_create(rift_governance_system_t* governance) {
-    if (!governance_load_stage(governance, 0)) return NULL;
-    
-    rift_stage0_processor_t* processor = malloc(sizeof(rift_stage0_processor_t));
-    if (!processor) return NULL;
-    
-    processor->governance = governance;
-    processor->stage_config = governance->stage_configs[0];
-    
-    // Extract token patterns from configuration
-    config_section_t* patterns = NULL;
-    for (size_t i = 0; i < processor->stage_config->section_count; i++) {
-        if (strcmp(processor->stage_config->section_names[i], "TOKEN_PATTERNS") == 0) {
-            patterns = processor->stage_config->sections[i];
-            break;
-        }
+static size_t rift_hash_string(const char* str) {
+    // FNV-1a
+    size_t hash = (size_t)14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        hash ^= *p;
+        hash *= (size_t)1099511628211ULL;
     }
+    return hash;
+}
+
+static rift_regex_cache_t* rift_regex_cache_create(size_t capacity) {
+    rift_regex_cache_t* cache = malloc(sizeof(rift_regex_cache_t));
+    if (!cache) return NULL;
     
-    if (patterns) {
-        processor->pattern_count = 4;  // IDENTIFIER, NUMBER, OPERATOR, WHITESPACE
-        processor->token_patterns = malloc(sizeof(char*) * processor->pattern_count);
-        processor->token_priorities = malloc(sizeof(int) * processor->pattern_count);
-        
-        processor->token_patterns[0] = strdup(config_section_get(patterns, "IDENTIFIER_PATTERN"));
-        processor->token_priorities[0] = atoi(config_section_get(patterns, "IDENTIFIER_PRIORITY"));
-        
-        processor->token_patterns[1] = strdup(config_section_get(patterns, "NUMBER_PATTERN"));
-        processor->token_priorities[1] = atoi(config_section_get(patterns, "NUMBER_PRIORITY"));
-        
-        processor->token_patterns[2] = strdup(config_section_get(patterns, "OPERATOR_PATTERN"));
-        processor->token_priorities[2] = atoi(config_section_get(patterns, "OPERATOR_PRIORITY"));
-        
-        processor->token_patterns[3] = strdup(config_section_get(patterns, "WHITESPACE_PATTERN"));
-        processor->token_priorities[3] = atoi(config_section_get(patterns, "WHITESPACE_PRIORITY"));
+    cache->entries = malloc(sizeof(rift_regex_cache_entry_t) * capacity);
+    if (!cache->entries) {
+        free(cache);
+        return NULL;
     }
     
-    return processor;
+    cache->count = 0;
+    cache->capacity = capacity;
+    cache->clock = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    return cache;
 }
 
-static void rift_stage0_destroy(rift_stage0_processor_t* processor) {
-    if (!processor) return;
+static void rift_regex_cache_entry_release(rift_regex_cache_entry_t* entry) {
+    if (entry->compiled) regfree(&entry->regex);
+    free(entry->pattern);
+}
+
+static void rift_regex_cache_destroy(rift_regex_cache_t* cache) {
+    if (!cache) return;
     
-    if (processor->token_patterns) {
-        for (size_t i = 0; i < processor->pattern_count; i++) {
-            free(processor->token_patterns[i]);
-        }
-        free(processor->token_patterns);
-        free(processor->token_priorities);
+    for (size_t i = 0; i < cache->count; i++) {
+        rift_regex_cache_entry_release(&cache->entries[i]);
     }
-    
-    free(processor);
+    free(cache->entries);
+    free(cache);
 }
 
-static bool pattern_matches(const char* pattern, const char* text) {
-    if (!pattern || !text) return false;
-    
-    regex_t regex;
-    int result = regcomp(&regex, pattern, REG_EXTENDED);
-    if (result) return false;
-    
-    result = regexec(&regex, text, 0, NULL, 0);
-    regfree(&regex);
-    return (result == 0);
+static bool regex_cache_entry_is(rift_regex_cache_entry_t* entry, const char* pattern, size_t hash) {
+    return entry->hash == hash && strcmp(entry->pattern, pattern) == 0;
 }
 
-static token_stream_t* rift_stage0_process(rift_stage0_processor_t* processor, const char* input) {
-    printf("\n[RIFT-0] Stage-bound tokenization with governance\n");
-    printf("  → SP Alignment: %s\n", processor->stage_config->sp_alignment);
-    printf("  → Using %zu configured token patterns\n", processor->pattern_count);
+// Returns the compiled form of pattern, compiling it on a miss and evicting the
+// least recently used entry when full. slot_hint remembers where the pattern
+// was last found so repeated lookups skip the scan. NULL if regcomp failed.
+static const regex_t* rift_regex_cache_get(rift_regex_cache_t* cache, const char* pattern,
+                                           size_t hash, size_t* slot_hint) {
+    rift_regex_cache_entry_t* entry = NULL;
     
-    token_stream_t* stream = malloc(sizeof(token_stream_t));
-    stream->capacity = 10;
-    stream->count = 0;
-    stream->tokens = malloc(sizeof(rift_token_t) * stream->capacity);
+    if (*slot_hint < cache->count && regex_cache_entry_is(&cache->entries[*slot_hint], pattern, hash)) {
+        entry = &cache->entries[*slot_hint];
+    } else {
+        for (size_t i = 0; i < cache->count; i++) {
+            if (regex_cache_entry_is(&cache->entries[i], pattern, hash)) {
+                entry = &cache->entries[i];
+                *slot_hint = i;
+                break;
+            }
+        }
+    }
     
-    // Tokenize input using stage-bound configuration
-    char* input_copy = strdup(input);
-    char* token_str = strtok(input_copy, " ");
+    if (entry) {
+        cache->hits++;
+        entry->last_used = ++cache->clock;
+        return entry->compiled ? &entry->regex : NULL;
+    }
     
-    while (token_str != NULL) {
-        if (strlen(token_str) > 0 && token_str[0] != ' ') {
-            // Resize if needed
-            if (stream->count >= stream->capacity) {
-                stream->capacity *= 2;
-                stream->tokens = realloc(stream->tokens, sizeof(rift_token_t) * stream->capacity);
-            }
-            
-            rift_token_t* token = &stream->tokens[stream->count++];
-            token->value = strdup(token_str);
-            token->line = 1;
-            token->column = stream->count;
-            token->type = TOKEN_UNKNOWN;
-            token->priority = 0;
-            
-            // Classify using governance-configured patterns with priority
-            int highest_priority = -1;
-            for (size_t i = 0; i < processor->pattern_count; i++) {
-                if (pattern_matches(processor->token_patterns[i], token_str)) {
-                    if (processor->token_priorities[i] > highest_priority) {
-                        highest_priority = processor->token_priorities[i];
-                        token->priority = processor->token_priorities[i];
-                        
-                        // Map pattern index to token type
-                        switch (i) {
-                            case 0: token->type = TOKEN_IDENTIFIER; break;
-                            case 1: token->type = TOKEN_NUMBER; break;
-                            case 2: token->type = TOKEN_OPERATOR; break;
-                            case 3: token->type = TOKEN_WHITESPACE; break;
-                        }
-                    }
-                }
-            }
-            
-            const char* type_name = "UNKNOWN";
-            switch (token->type) {
-                case TOKEN_IDENTIFIER: type_name = "IDENTIFIER"; break;
-                case TOKEN_NUMBER: type_name = "NUMBER"; break;
-                case TOKEN_OPERATOR: type_name = "OPERATOR"; break;
-                case TOKEN_WHITESPACE: type_name = "WHITESPACE"; break;
-                default: break;
-            }
-            
-            printf("  → Token: '%s' classified as %s (priority: %d)\n", 
-                   token_str, type_name, token->priority);
+    cache->misses++;
+    
+    // Copy the key first so a failed copy leaves the cache untouched
+    char* copy = strdup(pattern);
+    if (!copy) return NULL;
+    
+    size_t slot = cache->count;
+    if (cache->count < cache->capacity) {
+        cache->count++;
+    } else {
+        slot = 0;
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].last_used < cache->entries[slot].last_used) slot = i;
         }
-        
-        token_str = strtok(NULL, " ");
+        rift_regex_cache_entry_release(&cache->entries[slot]);
+        cache->evictions++;
     }
     
-    free(input_copy);
-    printf("  → Stage-bound tokenization complete: %zu tokens\n", stream->count);
-    return stream;
+    entry = &cache->entries[slot];
+    entry->pattern = copy;
+    entry->hash = hash;
+    entry->compiled = (regcomp(&entry->regex, pattern, REG_EXTENDED | REG_NOSUB) == 0);
+    entry->last_used = ++cache->clock;
+    *slot_hint = slot;
+    
+    return entry->compiled ? &entry->regex : NULL;
 }
 
 // ================================
-// Utility Functions
+// RIFT-0: Token DFA Compiler
+// Governance patterns → Thompson NFA → subset DFA → minimized DFA
 // ================================
 
-static void token_stream_destroy(token_stream_t* stream) {
-    if (!stream) return;
-    
-    for (size_t i = 0; i < stream->count; i++) {
-        free(stream->tokens[i].value);
-    }
-    free(stream->tokens);
-    free(stream);
-}
+// Supported pattern dialect: literals, '.', [...] classes (with ranges,
+// negation, escapes and [:posix:] classes), \w \d \s \W \D \S, grouping,
+// '|', '*', '+', '?'.
+// Leading '^' and trailing '$' are implied for token patterns and ignored.
 
-static void rift_print_stage_info(const char* stage, const char* message) {
-    printf("\n[%s] %s\n", stage, message);
-}
+#define RIFT_DFA_MAX_STATES 4096
 
-// ================================
+typedef struct {
+    uint64_t set[4];       // Bytes accepted by the consuming edge
+    int next;              // Target of the consuming edge, -1 if none
+    int eps[2];            // Epsilon edges, -1 if unused
+    int accept;            // Pattern index accepted here, -1 otherwise
+} rift_nfa_node_t;
+
+typedef struct {
+    rift_nfa_node_t* nodes;
+    size_t count;
+    size_t capacity;
+} rift_nfa_t;
+
+typedef struct {
+    int start;
+    int end;
+} rift_nfa_frag_t;
+
+typedef struct {
+    const char* p;
+    rift_nfa_t* nfa;
+    bool failed;
+} rift_pattern_parser_t;
+
+struct rift_dfa {
+    uint8_t byte_class[256];   // Byte → equivalence class
+    size_t class_count;
+    size_t state_count;
+    int32_t* transitions;      // [state * class_count + class], -1 = dead
+    int* accept;               // Pattern index accepted per state, -1 otherwise
+    int start;
+    bool borrowed;             // Tables live in a governance snapshot mapping
+};
+
+static int nfa_new_node(rift_nfa_t* nfa) {
+    if (nfa->count >= nfa->capacity) {
+        size_t new_capacity = nfa->capacity ? nfa->capacity * 2 : 64;
+        rift_nfa_node_t* new_nodes = realloc(nfa->nodes, sizeof(rift_nfa_node_t) * new_capacity);
+        if (!new_nodes) return -1;
+        nfa->nodes = new_nodes;
+        nfa->capacity = new_capacity;
+    }
+    
+    rift_nfa_node_t* node = &nfa->nodes[nfa->count];
+    memset(node->set, 0, sizeof(node->set));
+    node->next = -1;
+    node->eps[0] = -1;
+    node->eps[1] = -1;
+    node->accept = -1;
+    return (int)nfa->count++;
+}
+
+static void byte_set_add(uint64_t* set, unsigned char c) {
+    set[c >> 6] |= (uint64_t)1 << (c & 63);
+}
+
+static bool byte_set_has(const uint64_t* set, unsigned char c) {
+    return (set[c >> 6] >> (c & 63)) & 1;
+}
+
+static void byte_set_add_range(uint64_t* set, unsigned char lo, unsigned char hi) {
+    for (unsigned c = lo; c <= hi; c++) byte_set_add(set, (unsigned char)c);
+}
+
+// Adds the meaning of the escape letter c to set
+static void byte_set_add_escape(uint64_t* set, char c) {
+    uint64_t class_set[4] = {0, 0, 0, 0};
+    bool negate = false;
+    
+    switch (c) {
+        case 'W': negate = true; // fall through
+        case 'w':
+            byte_set_add_range(class_set, 'a', 'z');
+            byte_set_add_range(class_set, 'A', 'Z');
+            byte_set_add_range(class_set, '0', '9');
+            byte_set_add(class_set, '_');
+            break;
+        case 'D': negate = true; // fall through
+        case 'd':
+            byte_set_add_range(class_set, '0', '9');
+            break;
+        case 'S': negate = true; // fall through
+        case 's':
+            byte_set_add(class_set, ' ');
+            byte_set_add_range(class_set, '\t', '\r');
+            break;
+        case 'n': byte_set_add(class_set, '\n'); break;
+        case 't': byte_set_add(class_set, '\t'); break;
+        case 'r': byte_set_add(class_set, '\r'); break;
+        default:  byte_set_add(class_set, (unsigned char)c); break;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        set[i] |= negate ? ~class_set[i] : class_set[i];
+    }
+}
+
+// Adds the members of the POSIX class [:name:] (C locale) to set
+static bool byte_set_add_posix_class(uint64_t* set, const char* name, size_t length) {
+    static const struct { const char* name; int (*member)(int); } classes[] = {
+        {"alnum", isalnum}, {"alpha", isalpha}, {"blank", isblank}, {"cntrl", iscntrl},
+        {"digit", isdigit}, {"graph", isgraph}, {"lower", islower}, {"print", isprint},
+        {"punct", ispunct}, {"space", isspace}, {"upper", isupper}, {"xdigit", isxdigit}
+    };
+    
+    for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+        if (strlen(classes[i].name) != length || strncmp(classes[i].name, name, length) != 0) continue;
+        for (int c = 0; c < 128; c++) {
+            if (classes[i].member(c)) byte_set_add(set, (unsigned char)c);
+        }
+        return true;
+    }
+    return false;
+}
+
+static rift_nfa_frag_t nfa_frag_set(rift_pattern_parser_t* parser, const uint64_t* set) {
+    int start = nfa_new_node(parser->nfa);
+    int end = nfa_new_node(parser->nfa);
+    if (start < 0 || end < 0) {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    
+    memcpy(parser->nfa->nodes[start].set, set, sizeof(parser->nfa->nodes[start].set));
+    parser->nfa->nodes[start].next = end;
+    return (rift_nfa_frag_t){start, end};
+}
+
+static rift_nfa_frag_t parse_pattern_alternation(rift_pattern_parser_t* parser);
+
+static rift_nfa_frag_t parse_pattern_bracket(rift_pattern_parser_t* parser) {
+    uint64_t set[4] = {0, 0, 0, 0};
+    bool negate = false;
+    
+    if (*parser->p == '^') {
+        negate = true;
+        parser->p++;
+    }
+    
+    bool first = true;
+    while (*parser->p && (*parser->p != ']' || first)) {
+        first = false;
+        
+        if (parser->p[0] == '[' && parser->p[1] == ':') {
+            const char* end = strstr(parser->p + 2, ":]");
+            if (!end || !byte_set_add_posix_class(set, parser->p + 2, (size_t)(end - parser->p - 2))) {
+                parser->failed = true;
+                return (rift_nfa_frag_t){-1, -1};
+            }
+            parser->p = end + 2;
+            continue;
+        }
+        
+        unsigned char lo = (unsigned char)*parser->p++;
+        
+        if (lo == '\\') {
+            char escaped = *parser->p++;
+            if (!escaped) break;
+            if (strchr("wdsWDS", escaped)) {
+                byte_set_add_escape(set, escaped);
+                continue;
+            }
+            lo = (unsigned char)escaped;
+        }
+        
+        if (parser->p[0] == '-' && parser->p[1] && parser->p[1] != ']') {
+            unsigned char hi = (unsigned char)parser->p[1];
+            parser->p += 2;
+            if (hi == '\\') {
+                hi = (unsigned char)*parser->p++;
+                if (!hi) break;
+            }
+            if (hi < lo) {
+                parser->failed = true;
+                return (rift_nfa_frag_t){-1, -1};
+            }
+            byte_set_add_range(set, lo, hi);
+        } else {
+            byte_set_add(set, lo);
+        }
+    }
+    
+    if (*parser->p != ']') {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    parser->p++;
+    
+    if (negate) {
+        for (int i = 0; i < 4; i++) set[i] = ~set[i];
+    }
+    return nfa_frag_set(parser, set);
+}
+
+static rift_nfa_frag_t parse_pattern_atom(rift_pattern_parser_t* parser) {
+    uint64_t set[4] = {0, 0, 0, 0};
+    char c = *parser->p++;
+    
+    switch (c) {
+        case '(': {
+            rift_nfa_frag_t inner = parse_pattern_alternation(parser);
+            if (*parser->p != ')') {
+                parser->failed = true;
+                return (rift_nfa_frag_t){-1, -1};
+            }
+            parser->p++;
+            return inner;
+        }
+        case '[':
+            return parse_pattern_bracket(parser);
+        case '.':
+            byte_set_add_range(set, 0, 255);
+            return nfa_frag_set(parser, set);
+        case '\\':
+            if (!*parser->p) break;
+            byte_set_add_escape(set, *parser->p++);
+            return nfa_frag_set(parser, set);
+        case '{': case '}': case '*': case '+': case '?': case ')': case '\0':
+            break;
+        default:
+            byte_set_add(set, (unsigned char)c);
+            return nfa_frag_set(parser, set);
+    }
+    
+    parser->failed = true;
+    return (rift_nfa_frag_t){-1, -1};
+}
+
+static rift_nfa_frag_t parse_pattern_repeat(rift_pattern_parser_t* parser) {
+    rift_nfa_frag_t frag = parse_pattern_atom(parser);
+    
+    while (!parser->failed && (*parser->p == '*' || *parser->p == '+' || *parser->p == '?')) {
+        char op = *parser->p++;
+        rift_nfa_t* nfa = parser->nfa;
+        int start = (op == '+') ? frag.start : nfa_new_node(nfa);
+        int end = nfa_new_node(nfa);
+        if (start < 0 || end < 0) {
+            parser->failed = true;
+            break;
+        }
+        
+        if (op == '*') {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else if (op == '+') {
+            nfa->nodes[frag.end].eps[0] = frag.start;
+            nfa->nodes[frag.end].eps[1] = end;
+        } else {
+            nfa->nodes[start].eps[0] = frag.start;
+            nfa->nodes[start].eps[1] = end;
+            nfa->nodes[frag.end].eps[0] = end;
+        }
+        frag = (rift_nfa_frag_t){start, end};
+    }
+    
+    return frag;
+}
+
+static rift_nfa_frag_t parse_pattern_concat(rift_pattern_parser_t* parser) {
+    int start = nfa_new_node(parser->nfa);
+    if (start < 0) {
+        parser->failed = true;
+        return (rift_nfa_frag_t){-1, -1};
+    }
+    rift_nfa_frag_t frag = {start, start};
+    
+    while (!parser->failed && *parser->p && *parser->p != '|' && *parser->p != ')') {
+        // Trailing '$' anchors the whole token and is implied
+        if (parser->p[0] == '$' && parser->p[1] == '\0') {
+            parser->p++;
+            break;
+        }
+        
+        rift_nfa_frag_t next = parse_pattern_repeat(parser);
+        if (parser->failed) break;
+        parser->nfa->nodes[frag.end].eps[0] = next.start;
+        frag.end = next.end;
+    }
+    
+    return frag;
+}
+
+static rift_nfa_frag_t parse_pattern_alternation(rift_pattern_parser_t* parser) {
+    rift_nfa_frag_t frag = parse_pattern_concat(parser);
+    
+    while (!parser->failed && *parser->p == '|') {
+        parser->p++;
+        rift_nfa_frag_t other = parse_pattern_concat(parser);
+        int start = nfa_new_node(parser->nfa);
+        int end = nfa_new_node(parser->nfa);
+        if (parser->failed || start < 0 || end < 0) {
+            parser->failed = true;
+            break;
+        }
+        
+        rift_nfa_node_t* nodes = parser->nfa->nodes;
+        nodes[start].eps[0] = frag.start;
+        nodes[start].eps[1] = other.start;
+        nodes[frag.end].eps[0] = end;
+        nodes[other.end].eps[0] = end;
+        frag = (rift_nfa_frag_t){start, end};
+    }
+    
+    return frag;
+}
+
+// Compiles one pattern into nfa; its final node accepts pattern_index
+static int nfa_add_pattern(rift_nfa_t* nfa, const char* pattern, int pattern_index) {
+    rift_pattern_parser_t parser = {pattern, nfa, false};
+    if (*parser.p == '^') parser.p++;
+    
+    rift_nfa_frag_t frag = parse_pattern_alternation(&parser);
+    if (parser.failed || *parser.p != '\0') return -1;
+    
+    nfa->nodes[frag.end].accept = pattern_index;
+    return frag.start;
+}
+
+static void rift_dfa_destroy(rift_dfa_t* dfa) {
+    if (!dfa) return;
+    if (!dfa->borrowed) {
+        free(dfa->transitions);
+        free(dfa->accept);
+    }
+    free(dfa);
+}
+
+// Collapses bytes that no edge distinguishes into shared classes
+static size_t nfa_byte_classes(const rift_nfa_t* nfa, uint8_t* byte_class, uint8_t* representative) {
+    size_t class_count = 1;
+    memset(byte_class, 0, 256);
+    
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (nfa->nodes[n].next < 0) continue;
+        
+        int split[256][2];
+        memset(split, -1, sizeof(split));
+        size_t new_count = 0;
+        uint8_t refined[256];
+        
+        for (int b = 0; b < 256; b++) {
+            int in_set = byte_set_has(nfa->nodes[n].set, (unsigned char)b);
+            int* slot = &split[byte_class[b]][in_set];
+            if (*slot < 0) *slot = (int)new_count++;
+            refined[b] = (uint8_t)*slot;
+        }
+        
+        memcpy(byte_class, refined, 256);
+        class_count = new_count;
+    }
+    
+    for (int b = 255; b >= 0; b--) representative[byte_class[b]] = (uint8_t)b;
+    return class_count;
+}
+
+// Merges equivalent states (Moore partition refinement)
+static bool rift_dfa_minimize(rift_dfa_t* dfa) {
+    size_t n = dfa->state_count;
+    size_t k = dfa->class_count;
+    int* block = malloc(sizeof(int) * n);
+    int* next_block = malloc(sizeof(int) * n);
+    int* table = malloc(sizeof(int) * n * 2);
+    if (!block || !next_block || !table) {
+        free(block);
+        free(next_block);
+        free(table);
+        return false;
+    }
+    
+    // Initial partition: states accepting the same pattern
+    size_t block_count = 0;
+    for (size_t s = 0; s < n; s++) {
+        block[s] = -1;
+        for (size_t r = 0; r < s; r++) {
+            if (dfa->accept[r] == dfa->accept[s]) {
+                block[s] = block[r];
+                break;
+            }
+        }
+        if (block[s] < 0) block[s] = (int)block_count++;
+    }
+    
+    for (;;) {
+        size_t table_size = n * 2;
+        size_t new_count = 0;
+        int* representative = malloc(sizeof(int) * n);
+        if (!representative) break;
+        for (size_t i = 0; i < table_size; i++) table[i] = -1;
+        
+        for (size_t s = 0; s < n; s++) {
+            size_t hash = (size_t)block[s] * 31;
+            for (size_t c = 0; c < k; c++) {
+                int32_t t = dfa->transitions[s * k + c];
+                hash = hash * 1099511628211ULL + (size_t)(t < 0 ? -1 : block[t]);
+            }
+            
+            size_t slot = hash % table_size;
+            while (table[slot] >= 0) {
+                int r = table[slot];
+                bool same = block[r] == block[s];
+                for (size_t c = 0; same && c < k; c++) {
+                    int32_t a = dfa->transitions[(size_t)r * k + c];
+                    int32_t b = dfa->transitions[s * k + c];
+                    same = (a < 0 ? -1 : block[a]) == (b < 0 ? -1 : block[b]);
+                }
+                if (same) break;
+                slot = (slot + 1) % table_size;
+            }
+            
+            if (table[slot] < 0) {
+                table[slot] = (int)s;
+                representative[new_count] = (int)s;
+                next_block[s] = (int)new_count++;
+            } else {
+                next_block[s] = next_block[table[slot]];
+            }
+        }
+        
+        int* swap = block;
+        block = next_block;
+        next_block = swap;
+        
+        if (new_count == block_count) {
+            // Stable: rebuild the table with one state per block
+            int32_t* transitions = malloc(sizeof(int32_t) * new_count * k);
+            int* accept = malloc(sizeof(int) * new_count);
+            if (transitions && accept) {
+                for (size_t b = 0; b < new_count; b++) {
+                    size_t r = (size_t)representative[b];
+                    accept[b] = dfa->accept[r];
+                    for (size_t c = 0; c < k; c++) {
+                        int32_t t = dfa->transitions[r * k + c];
+                        transitions[b * k + c] = t < 0 ? -1 : block[t];
+                    }
+                }
+                dfa->start = block[dfa->start];
+                free(dfa->transitions);
+                free(dfa->accept);
+                dfa->transitions = transitions;
+                dfa->accept = accept;
+                dfa->state_count = new_count;
+            } else {
+                free(transitions);
+                free(accept);
+            }
+            free(representative);
+            break;
+        }
+        
+        block_count = new_count;
+        free(representative);
+    }
+    
+    free(block);
+    free(next_block);
+    free(table);
+    return true;
+}
+
+// Subset construction state: DFA states are sets of NFA nodes
+typedef struct {
+    const rift_nfa_t* nfa;
+    const int* priorities;
+    rift_dfa_t* dfa;
+    size_t words;              // uint64_t words per NFA node set
+    uint64_t* sets;            // One set per DFA state
+    size_t capacity;
+    int* stack;
+    int* lookup;               // Open-addressing index of sets
+    size_t lookup_size;
+} rift_dfa_builder_t;
+
+// Returns the DFA state for the epsilon closure of set, creating it if new
+static int32_t dfa_builder_intern(rift_dfa_builder_t* builder, uint64_t* set) {
+    const rift_nfa_t* nfa = builder->nfa;
+    rift_dfa_t* dfa = builder->dfa;
+    size_t words = builder->words;
+    
+    size_t top = 0;
+    for (size_t n = 0; n < nfa->count; n++) {
+        if (set[n >> 6] >> (n & 63) & 1) builder->stack[top++] = (int)n;
+    }
+    if (top == 0) return -1;
+    
+    while (top > 0) {
+        const rift_nfa_node_t* node = &nfa->nodes[builder->stack[--top]];
+        for (int e = 0; e < 2; e++) {
+            int t = node->eps[e];
+            if (t >= 0 && !(set[t >> 6] >> (t & 63) & 1)) {
+                set[t >> 6] |= (uint64_t)1 << (t & 63);
+                builder->stack[top++] = t;
+            }
+        }
+    }
+    
+    size_t hash = 0;
+    for (size_t w = 0; w < words; w++) hash = hash * 1099511628211ULL + set[w];
+    size_t slot = hash % builder->lookup_size;
+    while (builder->lookup[slot] >= 0) {
+        int32_t existing = builder->lookup[slot];
+        if (memcmp(builder->sets + words * (size_t)existing, set, sizeof(uint64_t) * words) == 0) {
+            return existing;
+        }
+        slot = (slot + 1) % builder->lookup_size;
+    }
+    
+    if (dfa->state_count >= RIFT_DFA_MAX_STATES) return -2;
+    
+    if (dfa->state_count >= builder->capacity) {
+        size_t new_capacity = builder->capacity * 2;
+        uint64_t* new_sets = realloc(builder->sets, sizeof(uint64_t) * words * new_capacity);
+        int32_t* new_transitions = new_sets ? realloc(dfa->transitions,
+                                                      sizeof(int32_t) * dfa->class_count * new_capacity) : NULL;
+        int* new_accept = new_transitions ? realloc(dfa->accept, sizeof(int) * new_capacity) : NULL;
+        if (new_sets) builder->sets = new_sets;
+        if (new_transitions) dfa->transitions = new_transitions;
+        if (!new_accept) return -2;
+        dfa->accept = new_accept;
+        builder->capacity = new_capacity;
+    }
+    
+    int32_t state = (int32_t)dfa->state_count++;
+    memcpy(builder->sets + words * (size_t)state, set, sizeof(uint64_t) * words);
+    builder->lookup[slot] = state;
+    
+    // Highest priority accepting pattern in the set wins, then the earliest
+    const int* priorities = builder->priorities;
+    int best = -1;
+    for (size_t n = 0; n < nfa->count; n++) {
+        int a = nfa->nodes[n].accept;
+        if (a >= 0 && (set[n >> 6] >> (n & 63) & 1) &&
+            (best < 0 || priorities[a] > priorities[best] ||
+             (priorities[a] == priorities[best] && a < best))) {
+            best = a;
+        }
+    }
+    dfa->accept[state] = best;
+    return state;
+}
+
+// Builds one minimized DFA recognizing every pattern. When several patterns
+// accept the same lexeme the highest priority wins, then the earliest pattern.
+// Returns NULL if a pattern is outside the supported dialect.
+static rift_dfa_t* rift_dfa_compile(char** patterns, const int* priorities, size_t pattern_count) {
+    rift_nfa_t nfa = {NULL, 0, 0};
+    rift_dfa_builder_t builder = {0};
+    uint64_t* scratch = NULL;
+    rift_dfa_t* dfa = NULL;
+    
+    // Thompson construction, all patterns joined under one start node
+    int start = nfa_new_node(&nfa);
+    int link = start;
+    for (size_t i = 0; i < pattern_count; i++) {
+        int pattern_start = nfa_add_pattern(&nfa, patterns[i], (int)i);
+        int next_link = nfa_new_node(&nfa);
+        if (pattern_start < 0 || next_link < 0) goto fail;
+        nfa.nodes[link].eps[0] = pattern_start;
+        nfa.nodes[link].eps[1] = next_link;
+        link = next_link;
+    }
+    
+    dfa = calloc(1, sizeof(rift_dfa_t));
+    if (!dfa) goto fail;
+    
+    uint8_t representative[256];
+    dfa->class_count = nfa_byte_classes(&nfa, dfa->byte_class, representative);
+    
+    builder.nfa = &nfa;
+    builder.priorities = priorities;
+    builder.dfa = dfa;
+    builder.words = (nfa.count + 63) / 64;
+    builder.capacity = 16;
+    builder.lookup_size = RIFT_DFA_MAX_STATES * 2;
+    builder.sets = malloc(sizeof(uint64_t) * builder.words * builder.capacity);
+    builder.stack = malloc(sizeof(int) * nfa.count);
+    builder.lookup = malloc(sizeof(int) * builder.lookup_size);
+    scratch = malloc(sizeof(uint64_t) * builder.words);
+    dfa->transitions = malloc(sizeof(int32_t) * dfa->class_count * builder.capacity);
+    dfa->accept = malloc(sizeof(int) * builder.capacity);
+    if (!builder.sets || !builder.stack || !builder.lookup || !scratch ||
+        !dfa->transitions || !dfa->accept) goto fail;
+    for (size_t i = 0; i < builder.lookup_size; i++) builder.lookup[i] = -1;
+    
+    memset(scratch, 0, sizeof(uint64_t) * builder.words);
+    scratch[start >> 6] |= (uint64_t)1 << (start & 63);
+    dfa->start = dfa_builder_intern(&builder, scratch);
+    
+    // Subset construction over byte classes; states are appended as discovered
+    for (size_t s = 0; s < dfa->state_count; s++) {
+        for (size_t c = 0; c < dfa->class_count; c++) {
+            const uint64_t* from = builder.sets + builder.words * s;
+            memset(scratch, 0, sizeof(uint64_t) * builder.words);
+            for (size_t n = 0; n < nfa.count; n++) {
+                if ((from[n >> 6] >> (n & 63) & 1) && nfa.nodes[n].next >= 0 &&
+                    byte_set_has(nfa.nodes[n].set, representative[c])) {
+                    int t = nfa.nodes[n].next;
+                    scratch[t >> 6] |= (uint64_t)1 << (t & 63);
+                }
+            }
+            
+            int32_t target = dfa_builder_intern(&builder, scratch);
+            if (target == -2) goto fail;
+            dfa->transitions[s * dfa->class_count + c] = target;
+        }
+    }
+    
+    free(builder.sets);
+    free(builder.stack);
+    free(builder.lookup);
+    free(scratch);
+    free(nfa.nodes);
+    
+    if (!rift_dfa_minimize(dfa)) {
+        rift_dfa_destroy(dfa);
+        return NULL;
+    }
+    return dfa;
+
+fail:
+    free(builder.sets);
+    free(builder.stack);
+    free(builder.lookup);
+    free(scratch);
+    free(nfa.nodes);
+    rift_dfa_destroy(dfa);
+    return NULL;
+}
+
+// Maximal munch: length of the longest prefix of input accepted by the DFA,
+// and the pattern that accepts it (0 and -1 if nothing matches)
+static size_t rift_dfa_longest_match(const rift_dfa_t* dfa, const char* input, size_t length,
+                                     int* accept) {
+    const int32_t* transitions = dfa->transitions;
+    const uint8_t* byte_class = dfa->byte_class;
+    size_t class_count = dfa->class_count;
+    int32_t state = dfa->start;
+    size_t match_length = 0;
+    
+    *accept = -1;
+    for (size_t i = 0; i < length; i++) {
+        state = transitions[(size_t)state * class_count + byte_class[(unsigned char)input[i]]];
+        if (state < 0) break;
+        if (dfa->accept[state] >= 0) {
+            *accept = dfa->accept[state];
+            match_length = i + 1;
+        }
+    }
+    
+    return match_length;
+}
+
+// ================================
+// Governance Snapshot
+// Compiled governance (stage configs, hash indexes, token automaton,
+// precedence table) in one position-independent file. Every reference is a
+// byte offset from the start of the file, so the loader maps it and points
+// straight into it; nothing is parsed or rehashed.
+// ================================
+
+#define RIFT_SNAPSHOT_MAGIC "RIFTGOV"
+#define RIFT_SNAPSHOT_VERSION 2
+#define RIFT_SNAPSHOT_NAME "governance.snapshot"
+#define RIFT_SNAPSHOT_FILES 5  // .riftrc.0-3, then global.rift
+
+enum {
+    SNAPSHOT_DFA_NONE = 0,     // No token patterns configured
+    SNAPSHOT_DFA_COMPILED = 1,
+    SNAPSHOT_DFA_UNSUPPORTED = 2  // Patterns outside the DFA dialect
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t word_size;        // sizeof(size_t) of the writer
+    uint64_t content_hash;     // Of the governance files the snapshot was built from
+    uint64_t total_size;
+    uint64_t configs[RIFT_SNAPSHOT_FILES];  // Offsets of snapshot_config_t
+    uint64_t dfa;              // Offset of snapshot_dfa_t, 0 if none
+    uint64_t dfa_status;
+    uint64_t operator_count;
+    uint8_t precedence[256];
+    uint64_t token_pattern_count;
+    uint64_t token_patterns;   // uint64_t[token_pattern_count] string offsets, 0 = none
+} snapshot_header_t;
+
+typedef struct {
+    int64_t stage_id;
+    int64_t declared_stage_id;
+    uint64_t stage_name;       // String offsets
+    uint64_t sp_alignment;
+    uint64_t governance_version;
+    uint64_t section_count;
+    uint64_t sections;         // snapshot_section_t[section_count]
+    uint64_t section_names;    // uint64_t[section_count] string offsets
+    uint64_t section_index;    // config_index_slot_t[section_index_capacity]
+    uint64_t section_index_capacity;
+    uint64_t section_index_count;
+} snapshot_config_t;
+
+typedef struct {
+    uint64_t pair_count;
+    uint64_t pairs;            // snapshot_pair_t[pair_count]
+    uint64_t index;            // config_index_slot_t[index_capacity]
+    uint64_t index_capacity;
+} snapshot_section_t;
+
+typedef struct {
+    uint64_t key;
+    uint64_t value;
+    uint64_t hash;
+} snapshot_pair_t;
+
+typedef struct {
+    uint64_t class_count;
+    uint64_t state_count;
+    int64_t start;
+    uint64_t transitions;      // int32_t[state_count * class_count]
+    uint64_t accept;           // int32_t[state_count]
+    uint8_t byte_class[256];
+} snapshot_dfa_t;
+
+struct rift_snapshot {
+    const uint8_t* base;
+    size_t size;
+};
+
+static const char* governance_file_name(int index) {
+    static const char* names[RIFT_SNAPSHOT_FILES] = {
+        ".riftrc.0", ".riftrc.1", ".riftrc.2", ".riftrc.3", "global.rift"
+    };
+    return names[index];
+}
+
+static void governance_file_path(char* path, size_t size, const char* dir, const char* name) {
+    size_t dir_length = strlen(dir);
+    const char* separator = dir_length && dir[dir_length - 1] == '/' ? "" : "/";
+    snprintf(path, size, "%s%s%s", dir, separator, name);
+}
+
+// FNV-1a over the name, length and bytes of every governance file
+static uint64_t governance_content_hash(const char* dir) {
+    uint64_t hash = 14695981039346656037ULL;
+    
+    for (int i = 0; i < RIFT_SNAPSHOT_FILES; i++) {
+        char path[1024];
+        governance_file_path(path, sizeof(path), dir, governance_file_name(i));
+        
+        config_file_t file;
+        bool found = config_file_open(&file, path);
+        uint64_t length = found ? file.length : UINT64_MAX;
+        const uint8_t* parts[2] = {(const uint8_t*)&length, found ? (const uint8_t*)file.data : NULL};
+        size_t sizes[2] = {sizeof(length), found ? file.length : 0};
+        
+        for (int p = 0; p < 2; p++) {
+            for (size_t b = 0; b < sizes[p]; b++) {
+                hash ^= parts[p][b];
+                hash *= 1099511628211ULL;
+            }
+        }
+        if (found) config_file_close(&file);
+    }
+    return hash;
+}
+
+// Bounds-checked pointer into the snapshot, NULL if [offset, offset + size)
+// falls outside it
+static const void* snapshot_at(const rift_snapshot_t* snapshot, uint64_t offset, uint64_t size) {
+    if (offset > snapshot->size || size > snapshot->size - offset) return NULL;
+    return snapshot->base + offset;
+}
+
+// Bounds-checked pointer to count elements of element_size bytes. Arrays are
+// written at 8-byte boundaries, and count * element_size must not overflow.
+static const void* snapshot_array(const rift_snapshot_t* snapshot, uint64_t offset,
+                                  uint64_t count, uint64_t element_size) {
+    if (offset % 8 != 0 || (element_size && count > UINT64_MAX / element_size)) return NULL;
+    return snapshot_at(snapshot, offset, count * element_size);
+}
+
+static const char* snapshot_string(const rift_snapshot_t* snapshot, uint64_t offset) {
+    const char* str = snapshot_at(snapshot, offset, 1);
+    if (!str || !memchr(str, '\0', snapshot->size - offset)) return NULL;
+    return str;
+}
+
+static const snapshot_header_t* snapshot_header(const rift_snapshot_t* snapshot) {
+    return (const snapshot_header_t*)snapshot->base;
+}
+
+// Maps dir/governance.snapshot if it was built from the current governance
+// files by a compatible writer; NULL otherwise
+static rift_snapshot_t* snapshot_open(const char* dir, uint64_t content_hash) {
+    char path[1024];
+    governance_file_path(path, sizeof(path), dir, RIFT_SNAPSHOT_NAME);
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(snapshot_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    
+    const snapshot_header_t* header = data;
+    if (memcmp(header->magic, RIFT_SNAPSHOT_MAGIC, sizeof(RIFT_SNAPSHOT_MAGIC)) != 0 ||
+        header->version != RIFT_SNAPSHOT_VERSION || header->word_size != sizeof(size_t) ||
+        header->total_size != (uint64_t)st.st_size || header->content_hash != content_hash) {
+        munmap(data, (size_t)st.st_size);
+        return NULL;
+    }
+    
+    rift_snapshot_t* snapshot = malloc(sizeof(rift_snapshot_t));
+    if (!snapshot) {
+        munmap(data, (size_t)st.st_size);
+        return NULL;
+    }
+    snapshot->base = data;
+    snapshot->size = (size_t)st.st_size;
+    return snapshot;
+}
+
+static size_t snapshot_load_precedence(const rift_snapshot_t* snapshot, uint8_t* precedence) {
+    const snapshot_header_t* header = snapshot_header(snapshot);
+    memcpy(precedence, header->precedence, sizeof(header->precedence));
+    return (size_t)header->operator_count;
+}
+
+// Borrows the escape-normalized token patterns; false if the snapshot's
+// table does not line up with the loaded [TOKEN_PATTERNS] section
+static bool snapshot_load_patterns(const rift_snapshot_t* snapshot, rift_governance_system_t* system) {
+    const snapshot_header_t* header = snapshot_header(snapshot);
+    config_section_t* patterns = stage_config_section(system->stage_configs[0], "TOKEN_PATTERNS");
+    if (!patterns || header->token_pattern_count != patterns->count) return false;
+    
+    size_t count = patterns->count;
+    const uint64_t* offsets = snapshot_array(snapshot, header->token_patterns, count, sizeof(uint64_t));
+    char** table = calloc(count ? count : 1, sizeof(char*));
+    if (!offsets || !table) {
+        free(table);
+        return false;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!offsets[i]) continue;
+        table[i] = (char*)snapshot_string(snapshot, offsets[i]);
+        if (!table[i]) {
+            free(table);
+            return false;
+        }
+    }
+    
+    system->token_patterns = table;
+    system->token_pattern_count = count;
+    system->token_patterns_borrowed = true;
+    return true;
+}
+
+static void snapshot_close(rift_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    munmap((void*)snapshot->base, snapshot->size);
+    free(snapshot);
+}
+
+// Borrows a hash index over an array of element_count entries. Every slot
+// must point inside that array and one slot must stay empty, so lookups
+// neither read past the array nor probe forever.
+static bool snapshot_index(const rift_snapshot_t* snapshot, config_index_t* index,
+                           uint64_t offset, uint64_t capacity, uint64_t element_count) {
+    if (capacity & (capacity - 1)) return false;  // Must be a power of two
+    
+    const config_index_slot_t* slots = snapshot_array(snapshot, offset, capacity,
+                                                      sizeof(config_index_slot_t));
+    if (capacity && !slots) return false;
+    
+    size_t used = 0;
+    for (uint64_t i = 0; i < capacity; i++) {
+        if (!slots[i].position) continue;
+        if (slots[i].position > element_count) return false;
+        used++;
+    }
+    if (capacity && used >= capacity) return false;
+    
+    index->slots = (config_index_slot_t*)slots;
+    index->capacity = (size_t)capacity;
+    index->count = used;
+    index->borrowed = true;
+    return true;
+}
+
+// Rebuilds the stage_config_t of configs[which] (4 is global.rift) on top of
+// the mapping. Only the pointer arrays are allocated; strings and
+// hash indexes are used in place.
+static stage_config_t* snapshot_load_config(const rift_snapshot_t* snapshot, int which) {
+    const snapshot_config_t* record = snapshot_at(snapshot, snapshot_header(snapshot)->configs[which],
+                                                  sizeof(snapshot_config_t));
+    if (!record) return NULL;
+    
+    stage_config_t* config = calloc(1, sizeof(stage_config_t));
+    if (!config) return NULL;
+    
+    const snapshot_section_t* sections = snapshot_array(snapshot, record->sections,
+                                                        record->section_count,
+                                                        sizeof(snapshot_section_t));
+    const uint64_t* names = snapshot_array(snapshot, record->section_names,
+                                           record->section_count, sizeof(uint64_t));
+    size_t count = sections && names ? (size_t)record->section_count : 0;
+    
+    config->stage_id = (int)record->stage_id;
+    config->declared_stage_id = (int)record->declared_stage_id;
+    config->stage_name = snapshot_string(snapshot, record->stage_name);
+    config->sp_alignment = snapshot_string(snapshot, record->sp_alignment);
+    config->governance_version = snapshot_string(snapshot, record->governance_version);
+    config->section_capacity = count ? count : 1;
+    config->sections = malloc(sizeof(config_section_t*) * config->section_capacity);
+    config->section_names = malloc(sizeof(char*) * config->section_capacity);
+    
+    bool ok = sections && names && config->sections && config->section_names &&
+              config->stage_name && config->sp_alignment && config->governance_version &&
+              snapshot_index(snapshot, &config->section_index, record->section_index,
+                             record->section_index_capacity, count);
+    
+    for (size_t i = 0; ok && i < count; i++) {
+        const snapshot_pair_t* pairs = snapshot_array(snapshot, sections[i].pairs,
+                                                      sections[i].pair_count, sizeof(snapshot_pair_t));
+        config_section_t* section = malloc(sizeof(config_section_t));
+        config->section_names[i] = snapshot_string(snapshot, names[i]);
+        if (!section) {
+            ok = false;
+            break;
+        }
+        config->sections[i] = section;
+        config->section_count++;
+        
+        section->count = pairs ? (size_t)sections[i].pair_count : 0;
+        section->capacity = section->count ? section->count : 1;
+        section->pairs = malloc(sizeof(config_pair_t) * section->capacity);
+        section->index = (config_index_t){0};
+        ok = pairs && section->pairs && config->section_names[i] &&
+             snapshot_index(snapshot, &section->index, sections[i].index,
+                            sections[i].index_capacity, section->count);
+        
+        for (size_t p = 0; ok && p < section->count; p++) {
+            section->pairs[p].key = snapshot_string(snapshot, pairs[p].key);
+            section->pairs[p].value = snapshot_string(snapshot, pairs[p].value);
+            section->pairs[p].hash = (size_t)pairs[p].hash;
+            ok = section->pairs[p].key && section->pairs[p].value;
+        }
+    }
+    
+    if (!ok) {
+        fprintf(stderr, "Governance snapshot is corrupt\n");
+        stage_config_destroy(config);
+        return NULL;
+    }
+    return config;
+}
+
+// Token automaton stored in the snapshot; its tables stay in the mapping.
+// Every class, transition target and accepted pattern index is checked, so a
+// damaged table cannot send the scanner outside its arrays.
+static rift_dfa_t* snapshot_load_dfa(const rift_snapshot_t* snapshot, size_t pattern_count) {
+    const snapshot_dfa_t* record = snapshot_at(snapshot, snapshot_header(snapshot)->dfa,
+                                               sizeof(snapshot_dfa_t));
+    if (!record || sizeof(int) != sizeof(int32_t)) return NULL;
+    
+    uint64_t states = record->state_count;
+    uint64_t classes = record->class_count;
+    if (classes == 0 || classes > 256 || states == 0 || states > INT32_MAX ||
+        record->start < 0 || (uint64_t)record->start >= states) {
+        return NULL;
+    }
+    
+    const int32_t* transitions = snapshot_array(snapshot, record->transitions, states * classes,
+                                                sizeof(int32_t));
+    const int32_t* accept = snapshot_array(snapshot, record->accept, states, sizeof(int32_t));
+    if (!transitions || !accept) return NULL;
+    
+    for (int b = 0; b < 256; b++) {
+        if (record->byte_class[b] >= classes) return NULL;
+    }
+    for (uint64_t i = 0; i < states * classes; i++) {
+        if (transitions[i] < -1 || transitions[i] >= (int64_t)states) return NULL;
+    }
+    for (uint64_t i = 0; i < states; i++) {
+        if (accept[i] < -1 || accept[i] >= (int64_t)pattern_count) return NULL;
+    }
+    
+    rift_dfa_t* dfa = calloc(1, sizeof(rift_dfa_t));
+    if (!dfa) return NULL;
+    
+    memcpy(dfa->byte_class, record->byte_class, sizeof(dfa->byte_class));
+    dfa->class_count = (size_t)record->class_count;
+    dfa->state_count = (size_t)record->state_count;
+    dfa->transitions = (int32_t*)transitions;
+    dfa->accept = (int*)accept;
+    dfa->start = (int)record->start;
+    dfa->borrowed = true;
+    return dfa;
+}
+
+// Growable image of the snapshot being written
+typedef struct {
+    uint8_t* data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} snapshot_writer_t;
+
+// Appends size zeroed bytes at an 8-byte boundary and returns their offset
+static uint64_t snapshot_reserve(snapshot_writer_t* writer, size_t size) {
+    size_t offset = (writer->length + 7) & ~(size_t)7;
+    if (offset + size > writer->capacity) {
+        size_t capacity = writer->capacity ? writer->capacity : 4096;
+        while (capacity < offset + size) capacity *= 2;
+        uint8_t* data = realloc(writer->data, capacity);
+        if (!data) {
+            writer->failed = true;
+            return 0;
+        }
+        writer->data = data;
+        writer->capacity = capacity;
+    }
+    memset(writer->data + writer->length, 0, offset + size - writer->length);
+    writer->length = offset + size;
+    return offset;
+}
+
+static uint64_t snapshot_put(snapshot_writer_t* writer, const void* data, size_t size) {
+    uint64_t offset = snapshot_reserve(writer, size);
+    if (!writer->failed && size) memcpy(writer->data + offset, data, size);
+    return offset;
+}
+
+static uint64_t snapshot_put_string(snapshot_writer_t* writer, const char* str) {
+    return snapshot_put(writer, str, strlen(str) + 1);
+}
+
+static uint64_t snapshot_put_index(snapshot_writer_t* writer, const config_index_t* index) {
+    return snapshot_put(writer, index->slots, index->capacity * sizeof(config_index_slot_t));
+}
+
+static uint64_t snapshot_put_config(snapshot_writer_t* writer, const stage_config_t* config) {
+    snapshot_config_t record = {0};
+    size_t count = config->section_count;
+    snapshot_section_t* sections = calloc(count ? count : 1, sizeof(snapshot_section_t));
+    uint64_t* names = calloc(count ? count : 1, sizeof(uint64_t));
+    if (!sections || !names) {
+        free(sections);
+        free(names);
+        writer->failed = true;
+        return 0;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        const config_section_t* section = config->sections[i];
+        snapshot_pair_t* pairs = calloc(section->count ? section->count : 1, sizeof(snapshot_pair_t));
+        if (!pairs) {
+            writer->failed = true;
+            break;
+        }
+        for (size_t p = 0; p < section->count; p++) {
+            pairs[p].key = snapshot_put_string(writer, section->pairs[p].key);
+            pairs[p].value = snapshot_put_string(writer, section->pairs[p].value);
+            pairs[p].hash = section->pairs[p].hash;
+        }
+        names[i] = snapshot_put_string(writer, config->section_names[i]);
+        sections[i].pair_count = section->count;
+        sections[i].pairs = snapshot_put(writer, pairs, section->count * sizeof(snapshot_pair_t));
+        sections[i].index = snapshot_put_index(writer, &section->index);
+        sections[i].index_capacity = section->index.capacity;
+        free(pairs);
+    }
+    
+    record.stage_id = config->stage_id;
+    record.declared_stage_id = config->declared_stage_id;
+    record.stage_name = snapshot_put_string(writer, config->stage_name);
+    record.sp_alignment = snapshot_put_string(writer, config->sp_alignment);
+    record.governance_version = snapshot_put_string(writer, config->governance_version);
+    record.section_count = count;
+    record.sections = snapshot_put(writer, sections, count * sizeof(snapshot_section_t));
+    record.section_names = snapshot_put(writer, names, count * sizeof(uint64_t));
+    record.section_index = snapshot_put_index(writer, &config->section_index);
+    record.section_index_capacity = config->section_index.capacity;
+    record.section_index_count = config->section_index.count;
+    
+    free(sections);
+    free(names);
+    return snapshot_put(writer, &record, sizeof(record));
+}
+
+static uint64_t snapshot_put_dfa(snapshot_writer_t* writer, const rift_dfa_t* dfa) {
+    snapshot_dfa_t record = {0};
+    int32_t* accept = malloc(sizeof(int32_t) * (dfa->state_count ? dfa->state_count : 1));
+    if (!accept) {
+        writer->failed = true;
+        return 0;
+    }
+    for (size_t s = 0; s < dfa->state_count; s++) accept[s] = dfa->accept[s];
+    
+    memcpy(record.byte_class, dfa->byte_class, sizeof(record.byte_class));
+    record.class_count = dfa->class_count;
+    record.state_count = dfa->state_count;
+    record.start = dfa->start;
+    record.transitions = snapshot_put(writer, dfa->transitions,
+                                      dfa->state_count * dfa->class_count * sizeof(int32_t));
+    record.accept = snapshot_put(writer, accept, dfa->state_count * sizeof(int32_t));
+    free(accept);
+    return snapshot_put(writer, &record, sizeof(record));
+}
+
+static uint64_t snapshot_put_patterns(snapshot_writer_t* writer, rift_governance_system_t* system) {
+    size_t count = system->token_pattern_count;
+    uint64_t* offsets = calloc(count ? count : 1, sizeof(uint64_t));
+    if (!offsets) {
+        writer->failed = true;
+        return 0;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (system->token_patterns[i]) offsets[i] = snapshot_put_string(writer, system->token_patterns[i]);
+    }
+    uint64_t offset = snapshot_put(writer, offsets, count * sizeof(uint64_t));
+    free(offsets);
+    return offset;
+}
+
+// Writes the fully loaded governance and the compiled token automaton to
+// dir/governance.snapshot, atomically replacing any previous snapshot
+static bool governance_write_snapshot(rift_governance_system_t* system, const rift_dfa_t* dfa,
+                                      int dfa_status) {
+    snapshot_writer_t writer = {0};
+    uint64_t header_offset = snapshot_reserve(&writer, sizeof(snapshot_header_t));
+    snapshot_header_t header = {0};
+    
+    memcpy(header.magic, RIFT_SNAPSHOT_MAGIC, sizeof(RIFT_SNAPSHOT_MAGIC));
+    header.version = RIFT_SNAPSHOT_VERSION;
+    header.word_size = sizeof(size_t);
+    header.content_hash = system->content_hash;
+    for (int i = 0; i < 4; i++) {
+        header.configs[i] = snapshot_put_config(&writer, system->stage_configs[i]);
+    }
+    header.configs[4] = snapshot_put_config(&writer, system->global_config);
+    header.dfa = dfa ? snapshot_put_dfa(&writer, dfa) : 0;
+    header.dfa_status = (uint64_t)dfa_status;
+    header.operator_count = system->operator_count;
+    memcpy(header.precedence, system->operator_precedence, sizeof(header.precedence));
+    header.token_pattern_count = system->token_pattern_count;
+    header.token_patterns = snapshot_put_patterns(&writer, system);
+    header.total_size = writer.length;
+    
+    if (writer.failed) {
+        free(writer.data);
+        return false;
+    }
+    memcpy(writer.data + header_offset, &header, sizeof(header));
+    
+    char path[1024], temp_path[1100];
+    governance_file_path(path, sizeof(path), system->config_dir, RIFT_SNAPSHOT_NAME);
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0;
+    for (size_t written = 0; ok && written < writer.length; ) {
+        ssize_t n = write(fd, writer.data + written, writer.length - written);
+        if (n < 0 && errno == EINTR) continue;
+        ok = n > 0;
+        if (ok) written += (size_t)n;
+    }
+    if (fd >= 0 && close(fd) != 0) ok = false;
+    ok = ok && rename(temp_path, path) == 0;
+    if (!ok) unlink(temp_path);
+    
+    if (ok) printf("  → Wrote %s (%zu bytes)\n", path, writer.length);
+    free(writer.data);
+    return ok;
+}
+
+// ================================
+// RIFT-0: Stage-Bound Tokenizer
+// ================================
+
+static token_type_t token_type_from_name(const char* name, size_t length) {
+    static const struct { const char* name; token_type_t type; } names[] = {
+        {"IDENTIFIER", TOKEN_IDENTIFIER},
+        {"NUMBER", TOKEN_NUMBER},
+        {"OPERATOR", TOKEN_OPERATOR},
+        {"WHITESPACE", TOKEN_WHITESPACE}
+    };
+    
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strlen(names[i].name) == length && strncmp(names[i].name, name, length) == 0) {
+            return names[i].type;
+        }
+    }
+    return TOKEN_UNKNOWN;
+}
+
+static void rift_stage0_destroy(rift_stage0_processor_t* processor);
+static void token_stream_destroy(token_stream_t* stream);
+
+static rift_stage0_processor_t* rift_stage0_create(rift_governance_system_t* governance) {
+    if (!governance_load_stage(governance, 0)) return NULL;
+    
+    rift_stage0_processor_t* processor = malloc(sizeof(rift_stage0_processor_t));
+    if (!processor) return NULL;
+    
+    processor->governance = governance;
+    processor->stage_config = governance->stage_configs[0];
+    
+    // Extract token patterns and tuning from configuration
+    config_section_t* patterns = stage_config_section(processor->stage_config, "TOKEN_PATTERNS");
+    config_section_t* tuning = stage_config_section(processor->stage_config, "PERFORMANCE_TUNING");
+    
+    const char* cache_size = config_section_get(tuning, "regex_cache_size");
+    size_t cache_capacity = cache_size ? strtoul(cache_size, NULL, 10) : 0;
+    processor->regex_cache = rift_regex_cache_create(cache_capacity ? cache_capacity : 256);
+    if (!processor->regex_cache) {
+        free(processor);
+        return NULL;
+    }
+    
+    processor->token_patterns = NULL;
+    processor->token_priorities = NULL;
+    processor->token_types = NULL;
+    processor->pattern_hashes = NULL;
+    processor->cache_slots = NULL;
+    processor->pattern_count = 0;
+    processor->dfa = NULL;
+    processor->trace_tokens = true;
+    
+    if (patterns) {
+        // Every NAME_PATTERN key defines a token class ranked by NAME_PRIORITY
+        size_t capacity = patterns->count ? patterns->count : 1;
+        processor->token_patterns = malloc(sizeof(char*) * capacity);
+        processor->token_priorities = malloc(sizeof(int) * capacity);
+        processor->token_types = malloc(sizeof(token_type_t) * capacity);
+        if (!processor->token_patterns || !processor->token_priorities || !processor->token_types) {
+            rift_stage0_destroy(processor);
+            return NULL;
+        }
+        
+        for (size_t i = 0; i < patterns->count; i++) {
+            const char* key = patterns->pairs[i].key;
+            size_t name_length = token_pattern_name_length(key);
+            if (!name_length) continue;
+            
+            // Normalized at governance load; raw text if it could not be
+            const char* pattern = i < governance->token_pattern_count && governance->token_patterns[i]
+                ? governance->token_patterns[i] : patterns->pairs[i].value;
+            
+            char priority_key[128];
+            snprintf(priority_key, sizeof(priority_key), "%.*s_PRIORITY", (int)name_length, key);
+            const char* priority = config_section_get(patterns, priority_key);
+            
+            char* copy = strdup(pattern);
+            if (!copy) {
+                rift_stage0_destroy(processor);
+                return NULL;
+            }
+            
+            size_t index = processor->pattern_count++;
+            processor->token_patterns[index] = copy;
+            processor->token_priorities[index] = priority ? atoi(priority) : 0;
+            processor->token_types[index] = token_type_from_name(key, name_length);
+        }
+        
+        // Compile all patterns into one automaton, unless the snapshot has it
+        const rift_snapshot_t* snapshot = governance->snapshot;
+        uint64_t dfa_status = snapshot ? snapshot_header(snapshot)->dfa_status : SNAPSHOT_DFA_NONE;
+        if (dfa_status == SNAPSHOT_DFA_COMPILED) {
+            processor->dfa = snapshot_load_dfa(snapshot, processor->pattern_count);
+            if (!processor->dfa) fprintf(stderr, "Governance snapshot token automaton is corrupt\n");
+        }
+        if (!processor->dfa && dfa_status != SNAPSHOT_DFA_UNSUPPORTED) {
+            processor->dfa = rift_dfa_compile(processor->token_patterns, processor->token_priorities,
+                                              processor->pattern_count);
+        }
+        
+        // Without a DFA, compile every pattern once up front for the regex path
+        processor->pattern_hashes = malloc(sizeof(size_t) * capacity);
+        processor->cache_slots = malloc(sizeof(size_t) * capacity);
+        if (!processor->pattern_hashes || !processor->cache_slots) {
+            rift_stage0_destroy(processor);
+            return NULL;
+        }
+        for (size_t i = 0; i < processor->pattern_count; i++) {
+            processor->pattern_hashes[i] = rift_hash_string(processor->token_patterns[i]);
+            processor->cache_slots[i] = 0;
+            if (!processor->dfa) {
+                rift_regex_cache_get(processor->regex_cache, processor->token_patterns[i],
+                                     processor->pattern_hashes[i], &processor->cache_slots[i]);
+            }
+        }
+    }
+    
+    return processor;
+}
+
+static void rift_stage0_destroy(rift_stage0_processor_t* processor) {
+    if (!processor) return;
+    
+    if (processor->token_patterns) {
+        for (size_t i = 0; i < processor->pattern_count; i++) {
+            free(processor->token_patterns[i]);
+        }
+        free(processor->token_patterns);
+    }
+    free(processor->token_priorities);
+    free(processor->token_types);
+    free(processor->pattern_hashes);
+    free(processor->cache_slots);
+    
+    rift_regex_cache_destroy(processor->regex_cache);
+    rift_dfa_destroy(processor->dfa);
+    free(processor);
+}
+
+static bool pattern_matches(rift_stage0_processor_t* processor, size_t index, const char* text) {
+    if (!processor->token_patterns[index] || !text) return false;
+    
+    const regex_t* regex = rift_regex_cache_get(processor->regex_cache,
+                                                processor->token_patterns[index],
+                                                processor->pattern_hashes[index],
+                                                &processor->cache_slots[index]);
+    if (!regex) return false;
+    
+    return regexec(regex, text, 0, NULL, 0) == 0;
+}
+
+static const char* token_type_name(token_type_t type) {
+    switch (type) {
+        case TOKEN_IDENTIFIER: return "IDENTIFIER";
+        case TOKEN_NUMBER: return "NUMBER";
+        case TOKEN_OPERATOR: return "OPERATOR";
+        case TOKEN_WHITESPACE: return "WHITESPACE";
+        default: return "UNKNOWN";
+    }
+}
+
+// Returns the next free token, or NULL if the stream cannot grow
+static rift_token_t* token_stream_push(token_stream_t* stream) {
+    // Resize if needed
+    if (stream->count >= stream->capacity) {
+        size_t new_capacity = stream->capacity * 2;
+        rift_token_t* new_tokens = realloc(stream->tokens, sizeof(rift_token_t) * new_capacity);
+        if (!new_tokens) return NULL;
+        stream->tokens = new_tokens;
+        stream->capacity = new_capacity;
+    }
+    return &stream->tokens[stream->count++];
+}
+
+// Single pass over the input with maximal munch; whitespace is dropped.
+// Returns false if the token stream cannot grow.
+static bool rift_stage0_scan_dfa(rift_stage0_processor_t* processor, token_stream_t* stream) {
+    const char* input = stream->source;
+    size_t length = stream->source_length;
+    size_t line = 1;
+    size_t column = 1;
+    size_t pos = 0;
+    
+    while (pos < length) {
+        int accept;
+        size_t match = rift_dfa_longest_match(processor->dfa, input + pos, length - pos, &accept);
+        token_type_t type = TOKEN_UNKNOWN;
+        int priority = 0;
+        
+        if (match == 0) {
+            match = 1;  // Unrecognized byte becomes a one-byte UNKNOWN token
+        } else {
+            type = processor->token_types[accept];
+            priority = processor->token_priorities[accept];
+        }
+        
+        if (type != TOKEN_WHITESPACE) {
+            rift_token_t* token = token_stream_push(stream);
+            if (!token) return false;
+            token->offset = pos;
+            token->length = match;
+            token->line = line;
+            token->column = column;
+            token->type = type;
+            token->priority = priority;
+            
+            if (processor->trace_tokens) {
+                printf("  → Token: '%.*s' classified as %s (priority: %d)\n",
+                       (int)match, input + pos, token_type_name(type), priority);
+            }
+        }
+        
+        for (size_t i = pos; i < pos + match; i++) {
+            if (input[i] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        pos += match;
+    }
+    return true;
+}
+
+// Fallback for patterns outside the DFA dialect: split on spaces and
+// classify each piece against the cached regexes. Returns false if out of memory.
+static bool rift_stage0_scan_regex(rift_stage0_processor_t* processor, token_stream_t* stream) {
+    const char* input = stream->source;
+    size_t length = stream->source_length;
+    char* scratch = NULL;  // NUL-terminated copy of one piece for regexec
+    size_t scratch_capacity = 0;
+    size_t pos = 0;
+    
+    while (pos < length) {
+        if (input[pos] == ' ') {
+            pos++;
+            continue;
+        }
+        
+        size_t end = pos;
+        while (end < length && input[end] != ' ') end++;
+        
+        size_t piece_length = end - pos;
+        if (piece_length + 1 > scratch_capacity) {
+            size_t new_capacity = (piece_length + 1) * 2;
+            char* new_scratch = realloc(scratch, new_capacity);
+            if (!new_scratch) {
+                free(scratch);
+                return false;
+            }
+            scratch = new_scratch;
+            scratch_capacity = new_capacity;
+        }
+        memcpy(scratch, input + pos, piece_length);
+        scratch[piece_length] = '\0';
+        
+        rift_token_t* token = token_stream_push(stream);
+        if (!token) {
+            free(scratch);
+            return false;
+        }
+        token->offset = pos;
+        token->length = piece_length;
+        token->line = 1;
+        token->column = stream->count;
+        token->type = TOKEN_UNKNOWN;
+        token->priority = 0;
+        
+        // Classify using governance-configured patterns with priority
+        int highest_priority = -1;
+        for (size_t i = 0; i < processor->pattern_count; i++) {
+            if (pattern_matches(processor, i, scratch)) {
+                if (processor->token_priorities[i] > highest_priority) {
+                    highest_priority = processor->token_priorities[i];
+                    token->priority = processor->token_priorities[i];
+                    token->type = processor->token_types[i];
+                }
+            }
+        }
+        
+        if (processor->trace_tokens) {
+            printf("  → Token: '%s' classified as %s (priority: %d)\n", 
+                   scratch, token_type_name(token->type), token->priority);
+        }
+        pos = end;
+    }
+    
+    free(scratch);
+    return true;
+}
+
+static token_stream_t* rift_stage0_process(rift_stage0_processor_t* processor, const char* input) {
+    bool trace = processor->trace_tokens;
+    if (trace) {
+        printf("\n[RIFT-0] Stage-bound tokenization with governance\n");
+        printf("  → SP Alignment: %s\n", processor->stage_config->sp_alignment);
+        printf("  → Using %zu configured token patterns\n", processor->pattern_count);
+    }
+    
+    token_stream_t* stream = malloc(sizeof(token_stream_t));
+    if (!stream) return NULL;
+    stream->capacity = 10;
+    stream->count = 0;
+    stream->tokens = malloc(sizeof(rift_token_t) * stream->capacity);
+    stream->source = input;
+    stream->source_length = strlen(input);
+    if (!stream->tokens) {
+        free(stream);
+        return NULL;
+    }
+    
+    bool scanned;
+    if (processor->dfa) {
+        if (trace) {
+            printf("  → Token automaton: %zu states, %zu byte classes\n",
+                   processor->dfa->state_count, processor->dfa->class_count);
+        }
+        scanned = rift_stage0_scan_dfa(processor, stream);
+    } else {
+        if (trace) printf("  → Token automaton unavailable, classifying with regex cache\n");
+        scanned = rift_stage0_scan_regex(processor, stream);
+    }
+    if (!scanned) {
+        fprintf(stderr, "RIFT-0: out of memory while tokenizing\n");
+        token_stream_destroy(stream);
+        return NULL;
+    }
+    
+    if (trace) {
+        printf("  → Stage-bound tokenization complete: %zu tokens\n", stream->count);
+        if (!processor->dfa) {
+            printf("  → Regex cache: %zu hits, %zu misses, %zu evictions (capacity %zu)\n",
+                   processor->regex_cache->hits, processor->regex_cache->misses,
+                   processor->regex_cache->evictions, processor->regex_cache->capacity);
+        }
+    }
+    return stream;
+}
+
+// ================================
+// Utility Functions
+// ================================
+
+static void token_stream_destroy(token_stream_t* stream) {
+    if (!stream) return;
+    
+    free(stream->tokens);
+    free(stream);
+}
+
+static void rift_print_stage_info(const char* stage, const char* message) {
+    printf("\n[%s] %s\n", stage, message);
+}
+
+// ================================
 // Simplified remaining stages for demonstration
 // (In full implementation, each would have similar stage-bound processing)
 // ================================
@@ -530,7 +2527,8 @@ static ast_node_t* create_simple_ast(token_stream_t* tokens) {
         if (tokens->tokens[i].type == TOKEN_IDENTIFIER) {
             ast_node_t* node = malloc(sizeof(ast_node_t));
             node->type = AST_IDENTIFIER;
-            node->value = strdup(tokens->tokens[i].value);
+            node->value = tokens->source + tokens->tokens[i].offset;
+            node->value_length = tokens->tokens[i].length;
             node->left = NULL;
             node->right = NULL;
             return node;
@@ -545,7 +2543,6 @@ static void ast_node_destroy(ast_node_t* node) {
     
     ast_node_destroy(node->left);
     ast_node_destroy(node->right);
-    free(node->value);
     free(node);
 }
 
@@ -553,16 +2550,124 @@ static void print_ast_simple(ast_node_t* node, int indent) {
     if (!node) return;
     
     for (int i = 0; i < indent; i++) printf("  ");
-    printf("(%s %s)\n", 
+    printf("(%s %.*s)\n", 
            node->type == AST_IDENTIFIER ? "Identifier" : "Node", 
-           node->value ? node->value : "");
+           (int)node->value_length, node->value ? node->value : "");
 }
 
 // ================================
 // Main Stage-Bound Simulation
 // ================================
 
-int main(void) {
+// Compile mode (the .so.a step): parse every governance file, build the
+// token automaton and precedence table, and write governance.snapshot
+static int governance_compile(void) {
+    printf("RIFT Governance Compiler\n");
+    printf("========================\n");
+    
+    rift_governance_system_t* governance = governance_system_create(false);
+    if (!governance) {
+        fprintf(stderr, "Failed to create governance system\n");
+        return 1;
+    }
+    
+    bool ok = true;
+    for (int stage = 1; stage < 4 && ok; stage++) ok = governance_load_stage(governance, stage);
+    
+    rift_stage0_processor_t* stage0 = ok ? rift_stage0_create(governance) : NULL;
+    if (stage0) {
+        int dfa_status = stage0->pattern_count == 0 ? SNAPSHOT_DFA_NONE
+                       : stage0->dfa ? SNAPSHOT_DFA_COMPILED : SNAPSHOT_DFA_UNSUPPORTED;
+        ok = governance_write_snapshot(governance, stage0->dfa, dfa_status);
+    } else {
+        ok = false;
+    }
+    
+    if (!ok) fprintf(stderr, "Failed to compile governance snapshot\n");
+    rift_stage0_destroy(stage0);
+    governance_system_destroy(governance);
+    return ok ? 0 : 1;
+}
+
+// Classify mode: runs every corpus line through rift_stage0_process REPEAT
+// times. Results format in gov-process/rift_tokenizer_compare.c
+static int classify_corpus(const char* corpus_path, const char* results_path,
+                           const char* repeat_text) {
+    char* end;
+    errno = 0;
+    unsigned long long repeat = strtoull(repeat_text, &end, 10);
+    if (errno || end == repeat_text || *end != '\0' || repeat == 0) {
+        fprintf(stderr, "--classify: invalid repeat count %s\n", repeat_text);
+        return 1;
+    }
+    
+    // Opened private and writable, like a governance file, so every line
+    // can be NUL-terminated in place
+    config_file_t corpus;
+    if (!config_file_open(&corpus, corpus_path)) {
+        fprintf(stderr, "%s: %s\n", corpus_path, strerror(errno));
+        return 1;
+    }
+    FILE* results = fopen(results_path, "w");
+    if (!results) {
+        fprintf(stderr, "%s: %s\n", results_path, strerror(errno));
+        config_file_close(&corpus);
+        return 1;
+    }
+    for (size_t i = 0; i < corpus.length; i++) {
+        if (corpus.data[i] == '\n') corpus.data[i] = '\0';
+    }
+    
+    rift_governance_system_t* governance = governance_system_create(true);
+    rift_stage0_processor_t* stage0 = governance ? rift_stage0_create(governance) : NULL;
+    bool ok = stage0 != NULL;
+    if (ok) {
+        stage0->trace_tokens = false;
+        fprintf(results, "E staged-%s\n", stage0->dfa ? "dfa" : "regex");
+    }
+    
+    for (unsigned long long pass = 0; ok && pass < repeat; pass++) {
+        for (size_t pos = 0; pos < corpus.length; ) {
+            const char* line = corpus.data + pos;
+            
+            struct timespec start, stop;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            token_stream_t* tokens = rift_stage0_process(stage0, line);
+            clock_gettime(CLOCK_MONOTONIC, &stop);
+            if (!tokens) {
+                ok = false;
+                break;
+            }
+            long long elapsed = (long long)(stop.tv_sec - start.tv_sec) * 1000000000LL +
+                                (stop.tv_nsec - start.tv_nsec);
+            
+            fprintf(results, "%c %lld\n", pass ? 'R' : 'L', elapsed);
+            for (size_t i = 0; pass == 0 && i < tokens->count; i++) {
+                const rift_token_t* token = &tokens->tokens[i];
+                fprintf(results, "T %s %.*s\n", token_type_name(token->type),
+                        (int)token->length, line + token->offset);
+            }
+            pos += tokens->source_length + 1;
+            token_stream_destroy(tokens);
+        }
+    }
+    
+    if (fclose(results) != 0) ok = false;
+    if (!ok) fprintf(stderr, "--classify: failed to classify %s\n", corpus_path);
+    rift_stage0_destroy(stage0);
+    governance_system_destroy(governance);
+    config_file_close(&corpus);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--compile-governance") == 0) {
+        return governance_compile();
+    }
+    if (argc == 5 && strcmp(argv[1], "--classify") == 0) {
+        return classify_corpus(argv[2], argv[3], argv[4]);
+    }
+    
     printf("RIFT Stage-Bound Configuration Simulation\n");
     printf("==========================================\n");
     printf("OBINexus Framework - Advanced Governance Architecture\n");
@@ -570,7 +2675,7 @@ int main(void) {
     printf("Stage-bound execution with .riftrc.N configurations\n");
     
     // Initialize governance system
-    rift_governance_system_t* governance = governance_system_create();
+    rift_governance_system_t* governance = governance_system_create(true);
     if (!governance) {
         fprintf(stderr, "Failed to create governance system\n");
         return 1;
@@ -589,12 +2694,19 @@ int main(void) {
     }
     
     token_stream_t* tokens = rift_stage0_process(stage0, source_input);
+    if (!tokens) {
+        fprintf(stderr, "RIFT-0 tokenization failed\n");
+        rift_stage0_destroy(stage0);
+        governance_system_destroy(governance);
+        return 1;
+    }
     
     // RIFT-1: Demonstrate stage loading (simplified for demo)
     printf("\n[RIFT-1] Loading stage-bound parser configuration\n");
     if (governance_load_stage(governance, 1)) {
         printf("  → SP Alignment: %s\n", governance->stage_configs[1]->sp_alignment);
         printf("  → Grammar rules loaded from .riftrc.1\n");
+        printf("  → Precedence table: %zu binary operators\n", governance->operator_count);
     }
     
     // RIFT-2: Demonstrate stage loading
@@ -610,17 +2722,11 @@ int main(void) {
         printf("  → SP Alignment: %s\n", governance->stage_configs[3]->sp_alignment);
         
         // Get configured output format
-        config_section_t* formats = NULL;
-        for (size_t i = 0; i < governance->stage_configs[3]->section_count; i++) {
-            if (strcmp(governance->stage_configs[3]->section_names[i], "OUTPUT_FORMATS") == 0) {
-                formats = governance->stage_configs[3]->sections[i];
-                break;
-            }
-        }
+        config_section_t* formats = stage_config_section(governance->stage_configs[3], "OUTPUT_FORMATS");
         
         if (formats) {
             const char* primary_format = config_section_get(formats, "primary_format");
-            printf("  → Primary output format: %s\n", primary_format);
+            printf("  → Primary output format: %s\n", primary_format ? primary_format : "(unset)");
             
             // Create simple AST and output
             ast_node_t* ast = create_simple_ast(tokens);